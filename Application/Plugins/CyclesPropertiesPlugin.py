@@ -26,6 +26,7 @@ subdiv_uv_smooth_enum = [
     "Smooth All", 5
 ]
 volume_space_types = ["Object", 0, "World", 1]
+volume_precision_types = ["Full", 0, "Half", 1, "Variable", 2]
 
 baking_shaders = ["Position", "Cycles Position",
                   "Normal", "Cycles Normal",
@@ -408,6 +409,7 @@ def CyclesVolume_Define(in_ctxt):
     oProp.AddParameter3("volume_object_space", c.siInt2, 0, 0, 1)
     oProp.AddParameter2("volume_step_size", c.siFloat, 0.0, 0.0, 100.0, 0.0, 1.0, 32768, 1)
     oProp.AddParameter2("volume_clipping", c.siFloat, 0.001, 0.0, 1.0, 0.0, 0.01)
+    oProp.AddParameter3("volume_precision", c.siInt2, 0, 0, 2)
     return True
 
 
@@ -815,6 +817,7 @@ def cycles_volume_property_build_ui():
     oLayout.AddEnumControl("volume_object_space", volume_space_types, "Space")
     oLayout.AddItem("volume_step_size", "Step Size")
     oLayout.AddItem("volume_clipping", "Clipping")
+    oLayout.AddEnumControl("volume_precision", volume_precision_types, "Precision")
     oLayout.EndGroup()
     PPG.Refresh()
 
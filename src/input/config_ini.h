@@ -38,6 +38,19 @@ struct ConfigSeries
 	XSI::CString sampling_postfix;
 };
 
+struct ConfigVDB
+{
+	ULONG memory_budget;  // in megabytes
+};
+
+struct ConfigTextures
+{
+	ULONG max_size;  // 0 - use textures in full resolution
+	bool use_cache;
+	ULONG cache_max_size;  // in megabytes, the least recently used copies are removed when the cache is larger
+	ULONG prefetch_memory;  // in megabytes, 0 - disable prefetch of image sequences
+};
+
 // this struct store all parameters from input ini-file as separate structs
 struct InputConfig
 {
@@ -45,4 +58,6 @@ struct InputConfig
 	ConfigShaderball shaderball;
 	ConfigRender render;
 	ConfigSeries series;
+	ConfigVDB vdb;
+	ConfigTextures textures;
 };
\ No newline at end of file
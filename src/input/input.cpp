@@ -204,10 +204,30 @@ void read_config_ini()
 		const char* sampling_postfix_str = ini.GetValue("SeriesRendering", "sampling_postfix", "spp");
 		series.sampling_postfix = XSI::CString(sampling_postfix_str);
 
+		ConfigVDB vdb;
+		const char* memory_budget_str = ini.GetValue("VDB", "memory_budget", "4096");
+		vdb.memory_budget = std::stoi(memory_budget_str, nullptr);
+
+		ConfigTextures textures;
+		const char* max_size_str = ini.GetValue("Textures", "max_size", "0");
+		textures.max_size = std::max(0, std::stoi(max_size_str, nullptr));
+
+		const char* use_cache_str = ini.GetValue("Textures", "use_cache", "1");
+		const float use_cache_float = strtof(use_cache_str, nullptr);
+		textures.use_cache = use_cache_float >= 0.5;
+
+		const char* cache_max_size_str = ini.GetValue("Textures", "cache_max_size", "4096");
+		textures.cache_max_size = std::max(0, std::stoi(cache_max_size_str, nullptr));
+
+		const char* prefetch_memory_str = ini.GetValue("Textures", "prefetch_memory", "1024");
+		textures.prefetch_memory = std::max(0, std::stoi(prefetch_memory_str, nullptr));
+
 		input_config.is_init = true;
 		input_config.shaderball = shaderball;
 		input_config.render = render;
 		input_config.series = series;
+		input_config.vdb = vdb;
+		input_config.textures = textures;
 	}
 }
 
@@ -223,6 +243,66 @@ ULONG get_shaderball_displacement_method()
 	}
 }
 
+ULONG get_vdb_memory_budget()
+{
+	if (input_config.is_init)
+	{
+		return input_config.vdb.memory_budget;
+	}
+	else
+	{
+		return 4096;
+	}
+}
+
+ULONG get_texture_max_size()
+{
+	if (input_config.is_init)
+	{
+		return input_config.textures.max_size;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+bool get_texture_use_cache()
+{
+	if (input_config.is_init)
+	{
+		return input_config.textures.use_cache;
+	}
+	else
+	{
+		return true;
+	}
+}
+
+ULONG get_texture_cache_max_size()
+{
+	if (input_config.is_init)
+	{
+		return input_config.textures.cache_max_size;
+	}
+	else
+	{
+		return 4096;
+	}
+}
+
+ULONG get_texture_prefetch_memory()
+{
+	if (input_config.is_init)
+	{
+		return input_config.textures.prefetch_memory;
+	}
+	else
+	{
+		return 1024;
+	}
+}
+
 InputConfig get_input_config()
 {
 	return input_config;
@@ -16,6 +16,11 @@ bool is_optix_available();
 void read_config_ini();
 InputConfig get_input_config();
 ULONG get_shaderball_displacement_method();
+ULONG get_vdb_memory_budget();
+ULONG get_texture_max_size();
+bool get_texture_use_cache();
+ULONG get_texture_cache_max_size();
+ULONG get_texture_prefetch_memory();
 
 void read_ocio_config();
 OCIOConfig get_ocio_config();
@@ -103,6 +103,10 @@ SICALLBACK VDBPrimitive_Define(const XSI::CRef& in_ref)
 		XSI::Parameter visual;
 		in_prim.AddParameter(visual_def, visual);
 
+		XSI::CRef visual_stride_def = fact.CreateParamDef("visual_stride", XSI::CValue::siInt4, kParamCaps, "visual_stride", "", 1, 1, 256, 1, 16);
+		XSI::Parameter visual_stride;
+		in_prim.AddParameter(visual_stride_def, visual_stride);
+
 		XSI::CRef force_load_def = fact.CreateParamDef("force_load_grids", XSI::CValue::siBool, kParamCaps, "force_load_grids", "", false, 0, 1, 0, 1);
 		XSI::Parameter force_load;
 		in_prim.AddParameter(force_load_def, force_load);
@@ -188,17 +192,18 @@ void build_vdb_ui(XSI::PPGLayout& layout, XSI::CustomPrimitive& in_prim)
 	layout.AddItem("frame", "Frame");
 
 	layout.AddItem("visual", "Visualize in Viewport");
+	layout.AddItem("visual_stride", "Voxels Stride");
 
 	layout.AddItem("force_load_grids", "Load All Grids");
 
-	VDBData data = vdb_cache.get(in_prim);
+	std::shared_ptr<VDBData> data = vdb_cache.get(in_prim);
 
-	if (data.is_valid)
+	if (data->is_valid)
 	{
 		XSI::CValueArray grids_combobox;
-		for (ULONG i = 0; i < data.grids_count; i++)
+		for (ULONG i = 0; i < data->grids_count; i++)
 		{
-			grids_combobox.Add(data.grid_names[i]);
+			grids_combobox.Add(data->grid_names[i]);
 			grids_combobox.Add(i);
 		}
 
@@ -210,9 +215,9 @@ void build_vdb_ui(XSI::PPGLayout& layout, XSI::CustomPrimitive& in_prim)
 		{
 			index = 0;
 		}
-		if (index >= data.grids_count)
+		if (index >= data->grids_count)
 		{
-			index = data.grids_count - 1;
+			index = data->grids_count - 1;
 		}
 
 		in_prim.PutParameterValue("grid_index", (LONG)index);
@@ -220,7 +225,7 @@ void build_vdb_ui(XSI::PPGLayout& layout, XSI::CustomPrimitive& in_prim)
 		layout.EndGroup();
 		// set static text
 		layout.AddGroup("Statistics");
-		std::vector<XSI::CString> text_content = data.get_description(index);
+		std::vector<XSI::CString> text_content = data->get_description(index);
 		for (ULONG i = 0; i < text_content.size(); i++)
 		{
 			layout.AddStaticText(text_content[i]);
@@ -323,13 +328,18 @@ SICALLBACK VDBPrimitive_BoundingBox(const XSI::CRef& in_ref)
 	}
 
 	XSI::CParameterRefArray& params = in_prim.GetParameters();
-	VDBData data = vdb_cache.get(in_prim);
-	if (data.is_valid)
+	std::shared_ptr<VDBData> data = vdb_cache.get(in_prim);
+	if (data->is_valid)
 	{
 		int grid_index = params.GetValue("grid_index");
-		if (grid_index >= 0 && grid_index < data.grids_count)
+		if (grid_index >= 0 && grid_index < data->grids_count)
 		{
-			double* bb = data.get_bb(grid_index);
+			if (!data->is_bb_valid(grid_index))
+			{
+				// the file does not contains bounding box, so it can be calculated only from voxels
+				vdb_cache.get_grid(in_prim, grid_index);
+			}
+			const double* bb = data->get_bb(grid_index);
 			in_ctxt.PutAttribute("LowerBoundX", bb[0]);
 			in_ctxt.PutAttribute("LowerBoundY", bb[1]);
 			in_ctxt.PutAttribute("LowerBoundZ", bb[2]);
@@ -351,6 +361,68 @@ SICALLBACK VDBPrimitive_BoundingBox(const XSI::CRef& in_ref)
 	return XSI::CStatus::OK;
 }
 
+inline bool is_stride_coordinate(int value, int stride)
+{
+	return ((value % stride) + stride) % stride == 0;
+}
+
+// write world positions of active voxels, use only voxels with index coordinates divisible by stride
+template<typename GridType>
+void build_typed_preview_points(const openvdb::GridBase::Ptr& grid, int stride, std::vector<float>& out_points)
+{
+	typename GridType::Ptr typed_grid = openvdb::gridPtrCast<GridType>(grid);
+	out_points.reserve(3 * (stride == 1 ? typed_grid->activeVoxelCount() : typed_grid->activeVoxelCount() / ((size_t)stride * stride * stride)));
+	for (typename GridType::ValueOnCIter iter = typed_grid->cbeginValueOn(); iter; ++iter)
+	{
+		openvdb::Coord coord = iter.getCoord();
+		if (stride == 1 || (is_stride_coordinate(coord.x(), stride) && is_stride_coordinate(coord.y(), stride) && is_stride_coordinate(coord.z(), stride)))
+		{
+			openvdb::math::Vec3d position = typed_grid->indexToWorld(coord);
+			out_points.push_back(position.x());
+			out_points.push_back(position.y());
+			out_points.push_back(position.z());
+		}
+	}
+}
+
+void build_preview_points(const openvdb::GridBase::Ptr& grid, int stride, std::vector<float>& out_points)
+{
+	out_points.clear();
+	if (grid->isType<openvdb::FloatGrid>())
+	{
+		build_typed_preview_points<openvdb::FloatGrid>(grid, stride, out_points);
+	}
+	else if (grid->isType<openvdb::DoubleGrid>())
+	{
+		build_typed_preview_points<openvdb::DoubleGrid>(grid, stride, out_points);
+	}
+	else if (grid->isType<openvdb::BoolGrid>())
+	{
+		build_typed_preview_points<openvdb::BoolGrid>(grid, stride, out_points);
+	}
+	else if (grid->isType<openvdb::Int32Grid>())
+	{
+		build_typed_preview_points<openvdb::Int32Grid>(grid, stride, out_points);
+	}
+	else if (grid->isType<openvdb::Int64Grid>())
+	{
+		build_typed_preview_points<openvdb::Int64Grid>(grid, stride, out_points);
+	}
+	else if (grid->isType<openvdb::Vec3IGrid>())
+	{
+		build_typed_preview_points<openvdb::Vec3IGrid>(grid, stride, out_points);
+	}
+	else if (grid->isType<openvdb::Vec3SGrid>())
+	{
+		build_typed_preview_points<openvdb::Vec3SGrid>(grid, stride, out_points);
+	}
+	else if (grid->isType<openvdb::Vec3DGrid>())
+	{
+		build_typed_preview_points<openvdb::Vec3DGrid>(grid, stride, out_points);
+	}
+	out_points.shrink_to_fit();
+}
+
 SICALLBACK VDBPrimitive_Draw(const XSI::CRef& in_ref)
 {
 	XSI::Context in_ctxt(in_ref);
@@ -361,11 +433,15 @@ SICALLBACK VDBPrimitive_Draw(const XSI::CRef& in_ref)
 	}
 
 	XSI::CParameterRefArray& params = in_prim.GetParameters();
-	VDBData data = vdb_cache.get(in_prim);
+	std::shared_ptr<VDBData> data = vdb_cache.get(in_prim);
 	int grid_index = params.GetValue("grid_index");
-	if (grid_index >= 0 && grid_index < data.grids_count)
+	if (grid_index >= 0 && grid_index < data->grids_count)
 	{
-		double* bb = data.get_bb(grid_index);
+		if (!data->is_bb_valid(grid_index))
+		{
+			vdb_cache.get_grid(in_prim, grid_index);
+		}
+		const double* bb = data->get_bb(grid_index);
 		double boxMinPt[3];
 		double boxMaxPt[3];
 
@@ -436,112 +512,28 @@ SICALLBACK VDBPrimitive_Draw(const XSI::CRef& in_ref)
 
 		if (params.GetValue("visual"))
 		{
-			openvdb::GridBase::Ptr grid = data.grids[grid_index];
-			ULONG voxels_count = grid->activeVoxelCount();
-			// next for different data types
-			if (grid->isType<openvdb::FloatGrid>())
-			{// FLOAT
-				openvdb::FloatGrid::Ptr float_grid = openvdb::gridPtrCast<openvdb::FloatGrid>(grid);
-				LLONG cnt = 0;
-				::glBegin(GL_POINTS);
-				for (openvdb::FloatGrid::ValueOnCIter iter = float_grid->cbeginValueOn(); cnt < voxels_count; ++cnt)
-				{
-					openvdb::math::Vec3d vdbVec3 = float_grid->indexToWorld(iter.getCoord());
-					::glVertex3f(vdbVec3.x(), vdbVec3.y(), vdbVec3.z());
-					++iter;
-				};
-				::glEnd();
-			}
-			else if (grid->isType<openvdb::DoubleGrid>())
-			{// DOUBLE
-				openvdb::DoubleGrid::Ptr double_grid = openvdb::gridPtrCast<openvdb::DoubleGrid>(grid);
-				LLONG cnt = 0;
-				::glBegin(GL_POINTS);
-				for (openvdb::DoubleGrid::ValueOnCIter iter = double_grid->cbeginValueOn(); cnt < voxels_count; ++cnt)
+			int stride = std::max((int)params.GetValue("visual_stride"), 1);
+			if (!data->is_preview_valid(grid_index, stride))
+			{
+				// points are builded only once for each grid and stride, so redraw does not iterate voxels
+				vdb_cache.release_preview(*data, grid_index);
+				openvdb::GridBase::Ptr grid = vdb_cache.get_grid(in_prim, grid_index);
+				if (!grid)
 				{
-					openvdb::math::Vec3d vdbVec3 = double_grid->indexToWorld(iter.getCoord());
-					::glVertex3f(vdbVec3.x(), vdbVec3.y(), vdbVec3.z());
-					++iter;
-				};
-				::glEnd();
+					return XSI::CStatus::OK;
+				}
+				build_preview_points(grid, stride, data->preview_points[grid_index]);
+				data->preview_strides[grid_index] = stride;
+				vdb_cache.add_preview(*data, grid_index);
 			}
-			else if (grid->isType<openvdb::BoolGrid>())
-			{// BOOLEAN
-				openvdb::BoolGrid::Ptr bool_grid = openvdb::gridPtrCast<openvdb::BoolGrid>(grid);
-				LLONG cnt = 0;
-				::glBegin(GL_POINTS);
-				for (openvdb::BoolGrid::ValueOnCIter iter = bool_grid->cbeginValueOn(); cnt < voxels_count; ++cnt)
-				{
-					openvdb::math::Vec3d vdbVec3 = bool_grid->indexToWorld(iter.getCoord());
-					::glVertex3f(vdbVec3.x(), vdbVec3.y(), vdbVec3.z());
-					++iter;
-				};
-				::glEnd();
-			}
-			else if (grid->isType<openvdb::Int32Grid>())
-			{// INT32
-				openvdb::Int32Grid::Ptr int32_grid = openvdb::gridPtrCast<openvdb::Int32Grid>(grid);
-				LLONG cnt = 0;
-				::glBegin(GL_POINTS);
-				for (openvdb::Int32Grid::ValueOnCIter iter = int32_grid->cbeginValueOn(); cnt < voxels_count; ++cnt)
-				{
-					openvdb::math::Vec3d vdbVec3 = int32_grid->indexToWorld(iter.getCoord());
-					::glVertex3f(vdbVec3.x(), vdbVec3.y(), vdbVec3.z());
-					++iter;
-				};
-				::glEnd();
-			}
-			else if (grid->isType<openvdb::Int64Grid>())
-			{// INT64
-				openvdb::Int64Grid::Ptr int64_grid = openvdb::gridPtrCast<openvdb::Int64Grid>(grid);
-				LLONG cnt = 0;
-				::glBegin(GL_POINTS);
-				for (openvdb::Int64Grid::ValueOnCIter iter = int64_grid->cbeginValueOn(); cnt < voxels_count; ++cnt)
-				{
-					openvdb::math::Vec3d vdbVec3 = int64_grid->indexToWorld(iter.getCoord());
-					::glVertex3f(vdbVec3.x(), vdbVec3.y(), vdbVec3.z());
-					++iter;
-				};
-				::glEnd();
-			}
-			else if (grid->isType<openvdb::Vec3IGrid>())
-			{// VEC3I
-				openvdb::Vec3IGrid::Ptr vec3i_grid = openvdb::gridPtrCast<openvdb::Vec3IGrid>(grid);
-				LLONG cnt = 0;
-				::glBegin(GL_POINTS);
-				for (openvdb::Vec3IGrid::ValueOnCIter iter = vec3i_grid->cbeginValueOn(); cnt < voxels_count; ++cnt)
-				{
-					openvdb::math::Vec3d vdbVec3 = vec3i_grid->indexToWorld(iter.getCoord());
-					::glVertex3f(vdbVec3.x(), vdbVec3.y(), vdbVec3.z());
-					++iter;
-				};
-				::glEnd();
-			}
-			else if (grid->isType<openvdb::Vec3SGrid>())
-			{// VEC3S
-				openvdb::Vec3SGrid::Ptr vec3s_grid = openvdb::gridPtrCast<openvdb::Vec3SGrid>(grid);
-				LLONG cnt = 0;
-				::glBegin(GL_POINTS);
-				for (openvdb::Vec3SGrid::ValueOnCIter iter = vec3s_grid->cbeginValueOn(); cnt < voxels_count; ++cnt)
-				{
-					openvdb::math::Vec3d vdbVec3 = vec3s_grid->indexToWorld(iter.getCoord());
-					::glVertex3f(vdbVec3.x(), vdbVec3.y(), vdbVec3.z());
-					++iter;
-				};
-				::glEnd();
-			}
-			else if (grid->isType<openvdb::Vec3DGrid>())
-			{// VEC3D
-				openvdb::Vec3DGrid::Ptr vec3d_grid = openvdb::gridPtrCast<openvdb::Vec3DGrid>(grid);
-				LLONG cnt = 0;
-				::glBegin(GL_POINTS);
-				for (openvdb::Vec3DGrid::ValueOnCIter iter = vec3d_grid->cbeginValueOn(); cnt < voxels_count; ++cnt)
-				{
-					openvdb::math::Vec3d vdbVec3 = vec3d_grid->indexToWorld(iter.getCoord());
-					::glVertex3f(vdbVec3.x(), vdbVec3.y(), vdbVec3.z());
-					++iter;
-				};
-				::glEnd();
+
+			const std::vector<float>& points = data->preview_points[grid_index];
+			if (points.size() > 0)
+			{
+				::glEnableClientState(GL_VERTEX_ARRAY);
+				::glVertexPointer(3, GL_FLOAT, 0, points.data());
+				::glDrawArrays(GL_POINTS, 0, (GLsizei)(points.size() / 3));
+				::glDisableClientState(GL_VERTEX_ARRAY);
 			}
 		}
 	}
@@ -549,7 +541,12 @@ SICALLBACK VDBPrimitive_Draw(const XSI::CRef& in_ref)
 	return XSI::CStatus::OK;
 }
 
-VDBData get_vdb_data(XSI::CustomPrimitive& in_prim)
+std::shared_ptr<VDBData> get_vdb_data(XSI::CustomPrimitive& in_prim, const XSI::CTime& eval_time)
+{
+	return vdb_cache.get(in_prim, eval_time);
+}
+
+openvdb::GridBase::Ptr get_vdb_grid(XSI::CustomPrimitive& in_prim, ULONG grid_index, const XSI::CTime& eval_time)
 {
-	return vdb_cache.get(in_prim);
+	return vdb_cache.get_grid(in_prim, grid_index, eval_time);
 }
\ No newline at end of file
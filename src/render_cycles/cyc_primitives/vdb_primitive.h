@@ -5,8 +5,15 @@
 
 #include <openvdb/openvdb.h>
 
+#include <array>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 #include "../../utilities/logs.h"
 #include "../../utilities/strings.h"
+#include "../../input/input.h"
 
 struct VDBData
 {
@@ -21,10 +28,22 @@ struct VDBData
 		grids_count = 0;
 		grids.resize(0);
 		grids.shrink_to_fit();
+		grids_metadata.resize(0);
+		grids_metadata.shrink_to_fit();
 		grid_names.resize(0);
 		grid_names.shrink_to_fit();
+		grids_bb.resize(0);
+		grids_bb.shrink_to_fit();
+		grids_bb_valid.resize(0);
+		grids_bb_valid.shrink_to_fit();
+		preview_points.resize(0);
+		preview_points.shrink_to_fit();
+		preview_strides.resize(0);
+		preview_strides.shrink_to_fit();
 	}
 
+	// read only names, types and metadata of grids in the file
+	// voxels are loaded by load_grid, when the grid is requested by the shader or the viewport
 	void init(XSI::CString& file_path)
 	{
 		reset();
@@ -37,14 +56,18 @@ struct VDBData
 			try
 			{
 				file.open();
-				for (openvdb::io::File::NameIterator nameIter = file.beginName(); nameIter != file.endName(); ++nameIter)
+				openvdb::GridPtrVecPtr file_grids = file.readAllGridMetadata();
+				for (openvdb::GridBase::Ptr grid : *file_grids)
 				{
-					openvdb::Name grid_name = nameIter.gridName();
-					openvdb::GridBase::Ptr grid = file.readGrid(grid_name);
-
-					grids.push_back(grid);
-					grid_names.push_back(XSI::CString(grid_name.c_str()));
+					grids_metadata.push_back(grid);
+					grids.push_back(nullptr);
+					grid_names.push_back(XSI::CString(grid->getName().c_str()));
+					grids_bb.push_back({ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 });
+					grids_bb_valid.push_back(false);
+					preview_points.push_back(std::vector<float>());
+					preview_strides.push_back(0);
 
+					update_bb(grids_count);
 					grids_count++;
 				}
 				is_valid = true;
@@ -58,13 +81,128 @@ struct VDBData
 		}
 	}
 
-	double* get_bb(ULONG index)
+	bool is_grid_loaded(ULONG index) const
+	{
+		return index < grids_count && grids[index] != nullptr;
+	}
+
+	// read voxels of the grid from the file
+	// return the number of bytes used by the loaded grid
+	size_t load_grid(ULONG index)
+	{
+		if (index >= grids_count || grids[index] != nullptr)
+		{
+			return 0;
+		}
+
+		openvdb::io::File file(source_path.GetAsciiString());
+		try
+		{
+			file.open();
+			grids[index] = file.readGrid(grid_names[index].GetAsciiString());
+			file.close();
+		}
+		catch (openvdb::Exception& e)
+		{
+			log_warning(XSI::CString("[VDB Primitive]: ") + XSI::CString(e.what()));
+			return 0;
+		}
+
+		if (!grids[index])
+		{
+			return 0;
+		}
+
+		if (!grids_bb_valid[index])
+		{
+			update_bb(index);
+		}
+
+		return grids[index]->memUsage();
+	}
+
+	// return true if the grid is also used by somebody else (for example, by the Cycles image loader)
+	// in this case the reset of our pointer does not release the voxels
+	bool is_grid_shared(ULONG index) const
+	{
+		return is_grid_loaded(index) && grids[index].use_count() > 1;
+	}
+
+	// release voxels and viewport points of the grid, return the number of released bytes
+	size_t unload_grid(ULONG index)
+	{
+		if (!is_grid_loaded(index))
+		{
+			return 0;
+		}
+
+		size_t memory = grids[index]->memUsage() + release_preview(index);
+		grids[index].reset();
+		return memory;
+	}
+
+	// loaded grid if it exists, or grid with metadata only (without voxels)
+	openvdb::GridBase::Ptr get_grid_or_metadata(ULONG index) const
+	{
+		return grids[index] ? grids[index] : grids_metadata[index];
+	}
+
+	// bounding box of the grid in world space: min x, y, z and max x, y, z
+	// it calculated once, when the grid is initialized or loaded, so the viewport callbacks simply read it
+	const double* get_bb(ULONG index) const
+	{
+		return grids_bb[index].data();
+	}
+
+	// return false if the file does not contains bounding box of the grid and the grid is not loaded yet
+	bool is_bb_valid(ULONG index) const
+	{
+		return index < grids_count && grids_bb_valid[index];
+	}
+
+	// use bounding box from the file metadata if it exists, or calculate it from the loaded voxels
+	void update_bb(ULONG index)
+	{
+		openvdb::GridBase::Ptr grid = get_grid_or_metadata(index);
+		openvdb::CoordBBox bb;
+		if (grid->getMetadata<openvdb::Vec3IMetadata>(openvdb::GridBase::META_FILE_BBOX_MIN) && grid->getMetadata<openvdb::Vec3IMetadata>(openvdb::GridBase::META_FILE_BBOX_MAX))
+		{
+			bb = openvdb::CoordBBox(openvdb::Coord(grid->metaValue<openvdb::Vec3i>(openvdb::GridBase::META_FILE_BBOX_MIN)), openvdb::Coord(grid->metaValue<openvdb::Vec3i>(openvdb::GridBase::META_FILE_BBOX_MAX)));
+		}
+		else if (grids[index] != nullptr)
+		{
+			bb = grids[index]->evalActiveVoxelBoundingBox();
+		}
+		else
+		{
+			return;
+		}
+
+		openvdb::Vec3d minp = grid->indexToWorld(bb.min());
+		openvdb::Vec3d maxp = grid->indexToWorld(bb.max());
+
+		grids_bb[index] = { minp.x(), minp.y(), minp.z(), maxp.x(), maxp.y(), maxp.z() };
+		grids_bb_valid[index] = true;
+	}
+
+	// return true if viewport points of the grid are already builded with the given stride
+	bool is_preview_valid(ULONG index, int stride) const
 	{
-		openvdb::CoordBBox bb = grids[index]->evalActiveVoxelBoundingBox();
-		openvdb::Vec3d minp = grids[index]->indexToWorld(bb.min());
-		openvdb::Vec3d maxp = grids[index]->indexToWorld(bb.max());
+		return index < grids_count && preview_strides[index] == stride;
+	}
 
-		return new double[6]{ minp.x(), minp.y(), minp.z(), maxp.x(), maxp.y(), maxp.z() };
+	size_t get_preview_memory(ULONG index) const
+	{
+		return preview_points[index].capacity() * sizeof(float);
+	}
+
+	// release viewport points of the grid, return the number of released bytes
+	size_t release_preview(ULONG index)
+	{
+		size_t memory = get_preview_memory(index);
+		preview_points[index] = std::vector<float>();
+		preview_strides[index] = 0;
+		return memory;
 	}
 
 	std::vector<XSI::CString> get_description(ULONG index)
@@ -77,24 +215,32 @@ struct VDBData
 		}
 		else
 		{
+			openvdb::GridBase::Ptr grid = get_grid_or_metadata(index);
 			XSI::CString str;
 			str += XSI::CString("Voxels count = ");
-			str += XSI::CString(grids[index]->activeVoxelCount());
+			if (grids[index] == nullptr && grid->getMetadata<openvdb::Int64Metadata>(openvdb::GridBase::META_FILE_VOXEL_COUNT))
+			{
+				str += XSI::CString(grid->metaValue<openvdb::Int64>(openvdb::GridBase::META_FILE_VOXEL_COUNT));
+			}
+			else
+			{
+				str += XSI::CString(grid->activeVoxelCount());
+			}
 			to_return.push_back(str);
 
 			str = XSI::CString("Voxel size = ");
-			openvdb::Vec3d size = grids[index]->transform().voxelSize();
+			openvdb::Vec3d size = grid->transform().voxelSize();
 			str += XSI::CString("(") + XSI::CString(size.x()) + ", " + XSI::CString(size.y()) + ", " + XSI::CString(size.z()) + ")";
 			to_return.push_back(str);
 
 			str = XSI::CString("Data type = ");
-			str += XSI::CString(grids[index]->valueType().c_str());
+			str += XSI::CString(grid->valueType().c_str());
 			to_return.push_back(str);
 
 			str = XSI::CString("\nMetadata:");
 			to_return.push_back(str);
 			bool is_metadata = false;
-			for (openvdb::MetaMap::MetaIterator iter = grids[index]->beginMeta(); iter != grids[index]->endMeta(); ++iter)
+			for (openvdb::MetaMap::MetaIterator iter = grid->beginMeta(); iter != grid->endMeta(); ++iter)
 			{
 				is_metadata = true;
 				const std::string& name = iter->first;
@@ -128,8 +274,14 @@ struct VDBData
 	bool is_valid;
 	XSI::CString source_path;
 	ULONG grids_count;
-	std::vector<openvdb::GridBase::Ptr> grids;
+	std::vector<openvdb::GridBase::Ptr> grids;  // loaded grids, nullptr if voxels of the grid are not loaded
+	std::vector<openvdb::GridBase::Ptr> grids_metadata;  // grids without voxels, contains only transform and metadata
 	std::vector<XSI::CString> grid_names;
+	std::vector<std::array<double, 6>> grids_bb;
+	std::vector<bool> grids_bb_valid;
+	// positions of voxels for viewport drawing (x, y, z for each point), these points are released together with voxels of the grid
+	std::vector<std::vector<float>> preview_points;
+	std::vector<int> preview_strides;  // 0 if preview is not builded
 };
 
 struct VDBIdentifier
@@ -139,67 +291,146 @@ struct VDBIdentifier
 	ULONG obj_id;
 };
 
+// cached datas are indexed by the full path to the vdb-file, it contains the frame number, so each frame of the sequence is a separate item
+// all callers share the same data object, so lookups does not copy grids and metadata
 struct VDBPrimitivesDataContainer
 {
-	bool find_index_by_path(VDBIdentifier& id, ULONG& output)
+	VDBPrimitivesDataContainer()
 	{
-		for (ULONG i = 0; i < vdb_ids.size(); i++)
+		invalid_data = std::make_shared<VDBData>();
+		loaded_memory = 0;
+	}
+
+	// viewport callbacks use the current time, render export use the time of the rendered frame
+	// both get the same data, if the frame is the same, so the file is read only once
+	std::shared_ptr<VDBData> get(XSI::CustomPrimitive& in_prim, const XSI::CTime& eval_time = XSI::CTime())
+	{
+		XSI::CParameterRefArray& params = in_prim.GetParameters();
+		XSI::CString file_path = vdbprimitive_inputs_to_path(params, eval_time);
+		if (file_path.Length() > 0)
 		{
-			if (vdb_ids[i].full_path == id.full_path)
+			// try to find the vdb
+			std::string key = file_path.GetAsciiString();
+			auto it = vdb_items.find(key);
+			if (it != vdb_items.end())
 			{
-				output = i;
-				return true;
+				return it->second.data;
+			}
+			else
+			{//the primitive is new, try to add it
+				std::shared_ptr<VDBData> data = std::make_shared<VDBData>();
+				data->init(file_path);
+				if (data->is_valid)
+				{
+					VDBCacheItem item;
+					item.id.full_path = file_path;
+					item.id.obj_id = in_prim.GetObjectID();
+					item.id.obj_name = in_prim.GetName();
+					item.data = data;
+					vdb_items[key] = item;
+				}
+				return data;
 			}
 		}
-		return false;
+		else
+		{
+			return invalid_data;
+		}
 	}
 
-	void find_indexes_by_name(const XSI::CString& name, ccl::array<ULONG>& output)
+	// return grid with loaded voxels, read it from the file if it is not loaded yet
+	// return nullptr if the grid does not exist
+	openvdb::GridBase::Ptr get_grid(XSI::CustomPrimitive& in_prim, ULONG grid_index, const XSI::CTime& eval_time = XSI::CTime())
 	{
-		for (ULONG i = 0; i < vdb_ids.size(); i++)
+		std::shared_ptr<VDBData> data = get(in_prim, eval_time);
+		if (!data->is_valid || grid_index >= data->grids_count)
 		{
-			if (vdb_ids[i].obj_name == name)
+			return nullptr;
+		}
+
+		if (!data->is_grid_loaded(grid_index))
+		{
+			loaded_memory += data->load_grid(grid_index);
+		}
+		openvdb::GridBase::Ptr grid = data->grids[grid_index];
+		if (grid)
+		{
+			touch_grid(data->source_path, grid_index);
+			unload_unused_grids();
+		}
+
+		return grid;
+	}
+
+	// move the grid to the start of the recently used list
+	void touch_grid(const XSI::CString& full_path, ULONG grid_index)
+	{
+		for (auto it = loaded_grids.begin(); it != loaded_grids.end(); ++it)
+		{
+			if (it->grid_index == grid_index && it->full_path == full_path)
 			{
-				output.push_back_slow(i);
+				loaded_grids.erase(it);
+				break;
 			}
 		}
+		loaded_grids.push_front({ full_path, grid_index });
 	}
 
-	VDBData get(XSI::CustomPrimitive& in_prim)
+	// unload least recently used grids until loaded voxels fit into the memory budget
+	// the last used grid is never unloaded
+	// grids, shared with Cycles loaders, are skipped and stay counted, because the voxels are released only when the loader releases the grid
+	void unload_unused_grids()
 	{
-		ULONG prim_id = in_prim.GetObjectID();
-		XSI::CParameterRefArray& params = in_prim.GetParameters();
-		XSI::CString file_path = vdbprimitive_inputs_to_path(params, XSI::CTime());
-		if (file_path.Length() > 0)
+		size_t memory_budget = (size_t)get_vdb_memory_budget() * 1024 * 1024;
+		auto grid_it = loaded_grids.end();
+		while (loaded_memory > memory_budget && grid_it != loaded_grids.begin())
 		{
-			// try to find the vdb
-			ULONG index;
-			VDBIdentifier id;
-			id.full_path = file_path;
-			id.obj_id = prim_id;
-			id.obj_name = in_prim.GetName();
-			if (find_index_by_path(id, index))
+			--grid_it;
+			if (grid_it == loaded_grids.begin())
 			{
-				return vdb_datas[index];
+				break;
 			}
-			else
-			{//the primitive is new, try to add it
-				VDBData data;
-				data.init(file_path);
-				if (data.is_valid)
-				{
-					vdb_ids.push_back(id);
-					vdb_datas.push_back(data);
-				}
-				return data;
+
+			auto it = vdb_items.find(grid_it->full_path.GetAsciiString());
+			if (it == vdb_items.end())
+			{
+				grid_it = loaded_grids.erase(grid_it);
+				continue;
+			}
+
+			if (it->second.data->is_grid_shared(grid_it->grid_index))
+			{
+				continue;
 			}
+
+			size_t released = it->second.data->unload_grid(grid_it->grid_index);
+			loaded_memory -= std::min(released, loaded_memory);
+			grid_it = loaded_grids.erase(grid_it);
 		}
-		else
+	}
+
+	// viewport points are counted in the memory budget together with voxels of the grid
+	void release_preview(VDBData& data, ULONG grid_index)
+	{
+		size_t released = data.release_preview(grid_index);
+		loaded_memory -= std::min(released, loaded_memory);
+	}
+
+	void add_preview(VDBData& data, ULONG grid_index)
+	{
+		loaded_memory += data.get_preview_memory(grid_index);
+		unload_unused_grids();
+	}
+
+	// remove all grids of the data from the recently used list
+	void release_loaded_grids(VDBData& data)
+	{
+		for (ULONG i = 0; i < data.grids_count; i++)
 		{
-			VDBData data;
-			data.is_valid = false;
-			return data;
+			size_t released = data.unload_grid(i);
+			loaded_memory -= std::min(released, loaded_memory);
 		}
+		loaded_grids.remove_if([&data](const VDBLoadedGrid& g) { return g.full_path == data.source_path; });
 	}
 
 	//call when we delete object from the scene
@@ -207,29 +438,17 @@ struct VDBPrimitivesDataContainer
 	//we should delete all datas with given name
 	void remove(const XSI::CString& name)
 	{
-		ULONG index = 0;
-		ccl::array<ULONG> indexes;
-		find_indexes_by_name(name, indexes);
-		if (indexes.size() > 0)
+		for (auto it = vdb_items.begin(); it != vdb_items.end();)
 		{
-			for (int i = indexes.size() - 1; i >= 0; i--)
-			{// iterate from the end to start
-				ULONG index = indexes[i];
-
-				vdb_ids.erase(vdb_ids.begin() + index);
-				// clear vdb data
-				// reset each grid
-				for (ULONG i = 0; i < vdb_datas[index].grids.size(); i++)
-				{
-					vdb_datas[index].grids[i].reset();
-				}
-				// then clear lists
-				vdb_datas[index].grids.clear();
-				vdb_datas[index].grids.shrink_to_fit();
-				vdb_datas[index].grid_names.clear();
-				vdb_datas[index].grid_names.shrink_to_fit();
-				// delete also data from the list
-				vdb_datas.erase(vdb_datas.begin() + index);
+			if (it->second.id.obj_name == name)
+			{
+				// data can be still used by somebody else, so release voxels explicitly
+				release_loaded_grids(*it->second.data);
+				it = vdb_items.erase(it);
+			}
+			else
+			{
+				++it;
 			}
 		}
 	}
@@ -237,25 +456,32 @@ struct VDBPrimitivesDataContainer
 	// call when reload a scene, here we should clear data about all vdbs
 	void clear()
 	{
-		for (ULONG i = 0; i < vdb_datas.size(); i++)
+		for (auto& [key, item] : vdb_items)
 		{
-			for (ULONG j = 0; j < vdb_datas[i].grids.size(); j++)
-			{
-				vdb_datas[i].grids[j].reset();
-			}
-			vdb_datas[i].grids.clear();
-			vdb_datas[i].grids.shrink_to_fit();
-			vdb_datas[i].grid_names.clear();
-			vdb_datas[i].grid_names.shrink_to_fit();
+			item.data->reset();
 		}
-		vdb_ids.clear();
-		vdb_ids.shrink_to_fit();
-		vdb_datas.clear();
-		vdb_datas.shrink_to_fit();
+		vdb_items.clear();
+		loaded_grids.clear();
+		loaded_memory = 0;
 	}
 
-	std::vector<VDBIdentifier> vdb_ids;
-	std::vector<VDBData> vdb_datas;
+	struct VDBCacheItem
+	{
+		VDBIdentifier id;
+		std::shared_ptr<VDBData> data;
+	};
+
+	struct VDBLoadedGrid
+	{
+		XSI::CString full_path;
+		ULONG grid_index;
+	};
+
+	std::unordered_map<std::string, VDBCacheItem> vdb_items;
+	std::shared_ptr<VDBData> invalid_data;  // returned for primitives without valid file path
+	std::list<VDBLoadedGrid> loaded_grids;  // the first is the most recently used
+	size_t loaded_memory;
 };
 
-VDBData get_vdb_data(XSI::CustomPrimitive& in_prim);
\ No newline at end of file
+std::shared_ptr<VDBData> get_vdb_data(XSI::CustomPrimitive& in_prim, const XSI::CTime& eval_time);
+openvdb::GridBase::Ptr get_vdb_grid(XSI::CustomPrimitive& in_prim, ULONG grid_index, const XSI::CTime& eval_time);
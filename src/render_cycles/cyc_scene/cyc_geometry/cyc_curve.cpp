@@ -12,6 +12,7 @@
 #include <xsi_floatarray.h>
 #include <xsi_nurbscurvelist.h>
 #include <xsi_nurbscurve.h>
+#include <xsi_nurbsdata.h>
 
 #include "../../update_context.h"
 #include "../../../utilities/xsi_properties.h"
@@ -20,6 +21,7 @@
 #include "../../../utilities/strings.h"
 #include "../cyc_scene.h"
 #include "cyc_geometry.h"
+#include "cyc_geometry_cache.h"
 
 void sync_curve_motion_deform(ccl::Hair* curves, UpdateContext* update_context, const XSI::X3DObject& xsi_object, float curve_size, float sample_step, int curve_samples)
 {
@@ -115,12 +117,65 @@ void sync_curve_geom(ccl::Scene* scene, ccl::Hair* curve_geom, UpdateContext* up
 	}
 }
 
+void add_curves_to_hash(GeometryHash& hash, const XSI::NurbsCurveList& xsi_curve_geometry)
+{
+	XSI::CNurbsCurveDataArray curves_data;
+	xsi_curve_geometry.Get(XSI::siSINurbs, curves_data);
+	LONG curves_count = curves_data.GetCount();
+	hash.add((ULONG)curves_count);
+	for (LONG i = 0; i < curves_count; i++)
+	{
+		const XSI::CNurbsCurveData& data = curves_data[i];
+		hash.add(data.m_aControlPoints);
+		hash.add(data.m_aKnots);
+		hash.add((int)data.m_bClosed);
+		hash.add((int)data.m_lDegree);
+	}
+}
+
+uint64_t compute_curve_hash(UpdateContext* update_context, const XSI::Primitive& xsi_primitive, XSI::X3DObject& xsi_object, const XSI::Property& curve_property, bool use_motion_blur, const ccl::array<ccl::Node*>& used_shaders)
+{
+	XSI::CTime eval_time = update_context->get_time();
+
+	GeometryHash hash;
+	hash.add(combine_geometry_name(xsi_object, xsi_primitive));
+	hash.add(eval_time);
+	hash.add((float)curve_property.GetParameterValue("curve_size", eval_time));
+	hash.add((int)curve_property.GetParameterValue("curve_samples", eval_time));
+	add_curves_to_hash(hash, xsi_primitive.GetGeometry(eval_time));
+	hash.add_shaders_attributes(used_shaders);
+
+	hash.add(use_motion_blur ? 1 : 0);
+	if (use_motion_blur)
+	{
+		std::vector<double> motion_times = update_context->get_motion_times();
+		hash.add(motion_times);
+		hash.add((int)update_context->get_motion_position());
+		for (size_t i = 0; i < motion_times.size(); i++)
+		{
+			add_curves_to_hash(hash, xsi_object.GetActivePrimitive(motion_times[i]).GetGeometry(motion_times[i]));
+		}
+	}
+
+	return hash.get_value();
+}
+
 void sync_curve_geom_process(ccl::Scene* scene, ccl::Hair* curve_geom, UpdateContext* update_context, const XSI::Primitive& xsi_primitive, XSI::X3DObject& xsi_object, const XSI::Property& curve_property, bool motion_deform) {
 	curve_geom->name = combine_geometry_name(xsi_object, xsi_primitive).GetAsciiString();
 
 	LONG num_keys = 0;
 	bool use_motion_blur = update_context->get_need_motion() && motion_deform;
 
+	if (update_context->get_use_geometry_hash())
+	{
+		uint64_t curve_hash = compute_curve_hash(update_context, xsi_primitive, xsi_object, curve_property, use_motion_blur, curve_geom->get_used_shaders());
+		update_context->add_geometry_hash(xsi_primitive.GetObjectID(), curve_hash);
+		if (update_context->restore_cached_geometry(xsi_primitive.GetObjectID(), curve_hash, curve_geom))
+		{
+			return;
+		}
+	}
+
 	XSI::CTime eval_time = update_context->get_time();
 	XSI::NurbsCurveList xsi_curve_geometry = xsi_primitive.GetGeometry(eval_time);
 	XSI::CNurbsCurveRefArray xsi_curves = xsi_curve_geometry.GetCurves();
@@ -141,31 +196,10 @@ void sync_curve_geom_process(ccl::Scene* scene, ccl::Hair* curve_geom, UpdateCon
 	}
 }
 
-ccl::Hair* sync_curve_object(ccl::Scene* scene, ccl::Object* curve_object, UpdateContext* update_context, XSI::X3DObject& xsi_object, const XSI::Property& curve_property)
+// curve material is defined by the name in the curve property, export it if it is not exported yet
+ccl::array<ccl::Node*> get_curve_used_shaders(ccl::Scene* scene, UpdateContext* update_context, XSI::X3DObject& xsi_object, const XSI::Property& curve_property, const XSI::CTime& eval_time)
 {
-	XSI::CTime eval_time = update_context->get_time();
-	XSI::CParameterRefArray render_parameters = update_context->get_current_render_parameters();
-
-	bool motion_deform = false;
-	XSI::CString lightgroup = "";
-	sync_geometry_object_parameters(scene, curve_object, xsi_object, lightgroup, motion_deform, "CyclesCurve", render_parameters, eval_time);
-
-	update_context->add_lightgroup(lightgroup);
-
-	XSI::Primitive xsi_primitive = xsi_object.GetActivePrimitive(eval_time);
-	ULONG xsi_curve_id = xsi_primitive.GetObjectID();
-	if (update_context->is_geometry_exists(xsi_curve_id))
-	{
-		size_t geo_index = update_context->get_geometry_index(xsi_curve_id);
-		ccl::Geometry* cyc_geo = scene->geometry[geo_index];
-		if (cyc_geo->geometry_type == ccl::Geometry::Type::HAIR)
-		{
-			return static_cast<ccl::Hair*>(scene->geometry[geo_index]);
-		}
-	}
-
-	ccl::Hair* curve_geom = scene->create_node<ccl::Hair>();
-
+	ccl::array<ccl::Node*> used_shaders;
 	XSI::CString curve_mat_iddentificator = curve_property.GetParameterValue("curve_material", eval_time);
 	// curve_mat_id is a string of the form: library.materialName
 	// we should get actual material ID from this name and theck it
@@ -187,20 +221,46 @@ ccl::Hair* sync_curve_object(ccl::Scene* scene, ccl::Object* curve_object, Updat
 	if (is_get && valid_material == XSI::CStatus::OK && update_context->is_material_exists(curve_mat_id)) {
 		size_t shader_index = update_context->get_xsi_material_cycles_index(curve_mat_id);
 
-		ccl::array<ccl::Node*> used_shaders;
 		used_shaders.push_back_slow(scene->shaders[shader_index]);
-		curve_geom->set_used_shaders(used_shaders);
 	}
 	else {
 		// fail to export missed material
 		// so, output the warning and does not assign the shader
 		log_warning("Curve object " + xsi_object.GetFullName() + " requred missed material.");
 
-		ccl::array<ccl::Node*> used_shaders;
 		used_shaders.push_back_slow(scene->shaders[0]);
-		curve_geom->set_used_shaders(used_shaders);
 	}
 
+	return used_shaders;
+}
+
+ccl::Hair* sync_curve_object(ccl::Scene* scene, ccl::Object* curve_object, UpdateContext* update_context, XSI::X3DObject& xsi_object, const XSI::Property& curve_property)
+{
+	XSI::CTime eval_time = update_context->get_time();
+	XSI::CParameterRefArray render_parameters = update_context->get_current_render_parameters();
+
+	bool motion_deform = false;
+	XSI::CString lightgroup = "";
+	sync_geometry_object_parameters(scene, curve_object, xsi_object, lightgroup, motion_deform, "CyclesCurve", render_parameters, eval_time);
+
+	update_context->add_lightgroup(lightgroup);
+
+	XSI::Primitive xsi_primitive = xsi_object.GetActivePrimitive(eval_time);
+	ULONG xsi_curve_id = xsi_primitive.GetObjectID();
+	if (update_context->is_geometry_exists(xsi_curve_id))
+	{
+		size_t geo_index = update_context->get_geometry_index(xsi_curve_id);
+		ccl::Geometry* cyc_geo = scene->geometry[geo_index];
+		if (cyc_geo->geometry_type == ccl::Geometry::Type::HAIR)
+		{
+			return static_cast<ccl::Hair*>(scene->geometry[geo_index]);
+		}
+	}
+
+	ccl::Hair* curve_geom = scene->create_node<ccl::Hair>();
+
+	curve_geom->set_used_shaders(get_curve_used_shaders(scene, update_context, xsi_object, curve_property, eval_time));
+
 	sync_curve_geom_process(scene, curve_geom, update_context, xsi_primitive, xsi_object, curve_property, motion_deform);
 
 	update_context->add_geometry_index(xsi_curve_id, scene->geometry.size() - 1);
@@ -237,16 +297,34 @@ XSI::CStatus update_curve(ccl::Scene* scene, UpdateContext* update_context, XSI:
 			size_t geo_index = update_context->get_geometry_index(xsi_id);
 			ccl::Geometry* geometry = scene->geometry[geo_index];
 			// try to get xsi object property
-			XSI::Property curve_prop = get_xsi_object_property(xsi_object, "CycleCurve");
+			XSI::Property curve_prop = get_xsi_object_property(xsi_object, "CyclesCurve");
 
 			if (curve_prop.IsValid() && geometry->geometry_type == ccl::Geometry::Type::HAIR)
 			{
 				ccl::Hair* curve_geom = static_cast<ccl::Hair*>(geometry);
-				curve_geom->clear(true);
-
-				sync_curve_geom_process(scene, curve_geom, update_context, xsi_prim, xsi_object, curve_prop, motion_deform);
-
-				curve_geom->tag_update(scene, true);
+				// the material can be changed or reassigned, so set actual shaders before the hash is computed
+				ccl::array<ccl::Node*> used_shaders = get_curve_used_shaders(scene, update_context, xsi_object, curve_prop, eval_time);
+				bool is_shaders_changed = !is_used_shaders_equal(curve_geom->get_used_shaders(), used_shaders);
+				if (is_shaders_changed)
+				{
+					curve_geom->set_used_shaders(used_shaders);
+				}
+
+				// skip the tessellation if only transform or material of the curve is changed
+				bool use_motion_blur = update_context->get_need_motion() && motion_deform;
+				uint64_t curve_hash = compute_curve_hash(update_context, xsi_prim, xsi_object, curve_prop, use_motion_blur, curve_geom->get_used_shaders());
+				if (!update_context->is_geometry_hash_equal(xsi_id, curve_hash))
+				{
+					curve_geom->clear(true);
+
+					sync_curve_geom_process(scene, curve_geom, update_context, xsi_prim, xsi_object, curve_prop, motion_deform);
+
+					curve_geom->tag_update(scene, true);
+				}
+				else if (is_shaders_changed)
+				{
+					curve_geom->tag_update(scene, false);
+				}
 			}
 			else
 			{
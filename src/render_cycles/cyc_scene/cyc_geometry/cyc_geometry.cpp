@@ -174,4 +174,22 @@ void sync_vdb_object_parameters(ccl::Scene* scene, ccl::Object* object, XSI::X3D
 	}
 	
 	object->tag_pass_id_modified();
+}
+
+bool is_used_shaders_equal(const ccl::array<ccl::Node*>& shaders_a, const ccl::array<ccl::Node*>& shaders_b)
+{
+	if (shaders_a.size() != shaders_b.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < shaders_a.size(); i++)
+	{
+		if (shaders_a[i] != shaders_b[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
 }
\ No newline at end of file
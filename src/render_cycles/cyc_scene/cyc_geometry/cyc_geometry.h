@@ -5,6 +5,7 @@
 #include <xsi_x3dobject.h>
 #include <xsi_geometryaccessor.h>
 #include <xsi_polygonmesh.h>
+#include <xsi_geometry.h>
 
 #include "scene/mesh.h"
 #include "scene/scene.h"
@@ -20,6 +21,8 @@
 ccl::uint get_ray_visibility(const XSI::CParameterRefArray& property_params, const XSI::CTime& eval_time);
 // common object parameters for hair and meshes
 void sync_geometry_object_parameters(ccl::Scene* scene, ccl::Object* object, XSI::X3DObject& xsi_object, XSI::CString& lightgroup, bool& out_motion_deform, const XSI::CString& property_name, const XSI::CParameterRefArray& render_parameters, const XSI::CTime& eval_time, bool full_update = true);
+// return true if both arrays contain the same shaders in the same order
+bool is_used_shaders_equal(const ccl::array<ccl::Node*>& shaders_a, const ccl::array<ccl::Node*>& shaders_b);
 void sync_vdb_object_parameters(ccl::Scene* scene, ccl::Object* object, XSI::X3DObject& xsi_object, XSI::CString& lightgroup, const XSI::CParameterRefArray& primitive_parameters, const XSI::CParameterRefArray& render_parameters, const XSI::CTime& eval_time, bool full_update = true);
 
 // cyc_polymesh
@@ -41,7 +44,12 @@ bool is_pointcloud_instances(const XSI::X3DObject& xsi_object, const XSI::CTime&
 bool is_valid_shape(XSI::siICEShapeType shape_type);
 XSI::MATH::CTransformation build_point_transform(const XSI::MATH::CVector3f& position, const XSI::MATH::CRotationf& rotation, float size, const XSI::MATH::CVector3f& scale, bool is_scale_define);
 std::vector<std::vector<XSI::MATH::CTransformation>> build_time_points_transforms(const XSI::X3DObject& xsi_object, const std::vector<double>& motion_times);
-void sync_point_primitive_shape(ccl::Scene* scene, ccl::Object* object, UpdateContext* update_context, XSI::siICEShapeType shape_type, const XSI::MATH::CColor4f& color, const std::vector<XSI::MATH::CTransformation>& point_tfms, XSI::X3DObject& xsi_pointcloud, const XSI::CTime& eval_time);
+// build transforms for all points with valid shapes, out_valid_points contains indices of these points
+std::vector<XSI::MATH::CTransformation> build_points_transforms(const XSI::Geometry& xsi_geometry, std::vector<ULONG>& out_valid_points);
+size_t get_pointcloud_shader_index(ccl::Scene* scene, UpdateContext* update_context, XSI::X3DObject& xsi_pointcloud);
+// if template_object is not NULL, then object parameters are copied from it instead of reading the pointcloud property
+// unique_pass_id is the value of the render parameter, it is read once for the whole pointcloud
+void sync_point_primitive_shape(ccl::Scene* scene, ccl::Object* object, UpdateContext* update_context, XSI::siICEShapeType shape_type, size_t shader_index, const XSI::MATH::CColor4f& color, const std::vector<XSI::MATH::CTransformation>& point_tfms, XSI::X3DObject& xsi_pointcloud, const XSI::CTime& eval_time, bool unique_pass_id, const ccl::Object* template_object = NULL);
 
 // cycs_strands
 bool is_pointcloud_strands(const XSI::X3DObject& xsi_object);
@@ -0,0 +1,362 @@
+#include "scene/scene.h"
+#include "scene/geometry.h"
+#include "scene/mesh.h"
+#include "scene/hair.h"
+#include "scene/pointcloud.h"
+#include "scene/shader.h"
+#include "util/murmurhash.h"
+
+#include <xsi_iceattribute.h>
+#include <xsi_iceattributedataarray.h>
+
+#include <climits>
+#include <algorithm>
+
+#include "cyc_geometry_cache.h"
+
+GeometryHash::GeometryHash()
+{
+	value_low = 0;
+	value_high = 0x9747b28c;
+}
+
+GeometryHash::~GeometryHash()
+{
+
+}
+
+void GeometryHash::add(const void* data, size_t size)
+{
+	// murmur hash accepts int length, so split large buffers
+	const char* bytes = (const char*)data;
+	while (size > 0)
+	{
+		int chunk = (int)std::min(size, (size_t)INT_MAX);
+		value_low = ccl::util_murmur_hash3(bytes, chunk, value_low);
+		value_high = ccl::util_murmur_hash3(bytes, chunk, value_high);
+		bytes += chunk;
+		size -= chunk;
+	}
+}
+
+void GeometryHash::add(int v)
+{
+	add(&v, sizeof(int));
+}
+
+void GeometryHash::add(ULONG v)
+{
+	add(&v, sizeof(ULONG));
+}
+
+void GeometryHash::add(float v)
+{
+	add(&v, sizeof(float));
+}
+
+void GeometryHash::add(double v)
+{
+	add(&v, sizeof(double));
+}
+
+void GeometryHash::add(const XSI::CString& v)
+{
+	add(v.GetAsciiString(), v.Length());
+}
+
+void GeometryHash::add(const XSI::CTime& v)
+{
+	add(v.GetTime());
+}
+
+void GeometryHash::add(const XSI::CDoubleArray& array)
+{
+	ULONG count = array.GetCount();
+	add(count);
+	if (count > 0)
+	{
+		add(array.GetArray(), sizeof(double) * count);
+	}
+}
+
+void GeometryHash::add(const XSI::CFloatArray& array)
+{
+	ULONG count = array.GetCount();
+	add(count);
+	if (count > 0)
+	{
+		add(array.GetArray(), sizeof(float) * count);
+	}
+}
+
+void GeometryHash::add(const XSI::CLongArray& array)
+{
+	ULONG count = array.GetCount();
+	add(count);
+	if (count > 0)
+	{
+		add(array.GetArray(), sizeof(LONG) * count);
+	}
+}
+
+void GeometryHash::add(const std::vector<double>& array)
+{
+	add((ULONG)array.size());
+	if (array.size() > 0)
+	{
+		add(array.data(), sizeof(double) * array.size());
+	}
+}
+
+void GeometryHash::add(const XSI::MATH::CVector4Array& array)
+{
+	LONG count = array.GetCount();
+	add((ULONG)count);
+	std::vector<double> values(count * 4);
+	for (LONG i = 0; i < count; i++)
+	{
+		const XSI::MATH::CVector4& v = array[i];
+		values[4 * i] = v.GetX();
+		values[4 * i + 1] = v.GetY();
+		values[4 * i + 2] = v.GetZ();
+		values[4 * i + 3] = v.GetW();
+	}
+	if (count > 0)
+	{
+		add(values.data(), sizeof(double) * values.size());
+	}
+}
+
+template<typename T>
+void add_ice_data_array(GeometryHash& hash, const XSI::ICEAttribute& xsi_attribute)
+{
+	XSI::CICEAttributeDataArray<T> data;
+	xsi_attribute.GetDataArray(data);
+	ULONG count = data.GetCount();
+	hash.add(count);
+	if (count > 0)
+	{
+		hash.add(&data[0], sizeof(T) * (data.IsConstant() ? 1 : count));
+	}
+}
+
+void GeometryHash::add_ice_attributes(const XSI::Geometry& xsi_geometry)
+{
+	XSI::CRefArray xsi_ice_attributes = xsi_geometry.GetICEAttributes();
+	LONG attributes_count = xsi_ice_attributes.GetCount();
+	for (LONG i = 0; i < attributes_count; i++)
+	{
+		XSI::ICEAttribute xsi_attribute(xsi_ice_attributes[i]);
+		XSI::siICENodeContextType attr_context = xsi_attribute.GetContextType();
+		XSI::siICENodeDataType attr_data_type = xsi_attribute.GetDataType();
+		XSI::siICENodeStructureType attr_structure = xsi_attribute.GetStructureType();
+		add(xsi_attribute.GetName());
+		add((int)attr_context);
+		add((int)attr_data_type);
+		add((int)attr_structure);
+
+		// hash only values, which can be exported to Cycles attributes
+		if ((attr_context == XSI::siICENodeContextComponent0D || attr_context == XSI::siICENodeContextSingleton) && attr_structure == XSI::siICENodeStructureSingle)
+		{
+			if (attr_data_type == XSI::siICENodeDataFloat)
+			{
+				add_ice_data_array<float>(*this, xsi_attribute);
+			}
+			else if (attr_data_type == XSI::siICENodeDataLong)
+			{
+				add_ice_data_array<LONG>(*this, xsi_attribute);
+			}
+			else if (attr_data_type == XSI::siICENodeDataVector2)
+			{
+				add_ice_data_array<XSI::MATH::CVector2f>(*this, xsi_attribute);
+			}
+			else if (attr_data_type == XSI::siICENodeDataVector3)
+			{
+				add_ice_data_array<XSI::MATH::CVector3f>(*this, xsi_attribute);
+			}
+			else if (attr_data_type == XSI::siICENodeDataColor4)
+			{
+				add_ice_data_array<XSI::MATH::CColor4f>(*this, xsi_attribute);
+			}
+			else if (attr_data_type == XSI::siICENodeDataBool)
+			{
+				// boolean data stored as bits, so read it per element
+				XSI::CICEAttributeDataArrayBool data;
+				xsi_attribute.GetDataArray(data);
+				ULONG count = data.GetCount();
+				add(count);
+				std::vector<unsigned char> bytes(count);
+				for (ULONG j = 0; j < count; j++)
+				{
+					bytes[j] = data[j] ? 1 : 0;
+				}
+				if (count > 0)
+				{
+					add(bytes.data(), count);
+				}
+			}
+		}
+	}
+}
+
+void GeometryHash::add_shaders_attributes(const ccl::array<ccl::Node*>& used_shaders)
+{
+	for (size_t i = 0; i < used_shaders.size(); i++)
+	{
+		const ccl::Shader* shader = static_cast<const ccl::Shader*>(used_shaders[i]);
+		for (const ccl::AttributeRequest& request : shader->attributes.requests)
+		{
+			add(request.name.c_str(), request.name.size());
+			add((int)request.std);
+		}
+	}
+}
+
+uint64_t GeometryHash::get_value()
+{
+	return ((uint64_t)value_high << 32) | (uint64_t)value_low;
+}
+
+GeometryCache::GeometryCache()
+{
+	is_active = false;
+	hits = 0;
+	misses = 0;
+}
+
+GeometryCache::~GeometryCache()
+{
+	clear();
+}
+
+void GeometryCache::clear()
+{
+	for (auto& [xsi_id, item] : items)
+	{
+		delete item.geometry;
+	}
+	items.clear();
+
+	is_active = false;
+	hits = 0;
+	misses = 0;
+}
+
+bool GeometryCache::get_is_active()
+{
+	return is_active;
+}
+
+ccl::Geometry* create_standalone_geometry(ccl::Geometry::Type geometry_type)
+{
+	if (geometry_type == ccl::Geometry::Type::MESH)
+	{
+		return new ccl::Mesh();
+	}
+	else if (geometry_type == ccl::Geometry::Type::HAIR)
+	{
+		return new ccl::Hair();
+	}
+	else if (geometry_type == ccl::Geometry::Type::POINTCLOUD)
+	{
+		return new ccl::PointCloud();
+	}
+
+	return NULL;
+}
+
+// copy all sockets and move attributes from one geometry to another
+// in the same way as Blender sync reuse the mesh
+void move_geometry_data(ccl::Geometry* from_geometry, ccl::Geometry* to_geometry)
+{
+	for (const ccl::SocketType& socket : from_geometry->type->inputs)
+	{
+		// used shaders belong to the scene, so the target geometry should already has it
+		if (socket.type == ccl::SocketType::NODE || socket.type == ccl::SocketType::NODE_ARRAY)
+		{
+			continue;
+		}
+		to_geometry->set_value(socket, *from_geometry, socket);
+	}
+
+	to_geometry->attributes.update(std::move(from_geometry->attributes));
+	if (from_geometry->geometry_type == ccl::Geometry::Type::MESH)
+	{
+		ccl::Mesh* from_mesh = static_cast<ccl::Mesh*>(from_geometry);
+		ccl::Mesh* to_mesh = static_cast<ccl::Mesh*>(to_geometry);
+		to_mesh->subd_attributes.update(std::move(from_mesh->subd_attributes));
+	}
+}
+
+void GeometryCache::add(ULONG xsi_id, uint64_t hash, ccl::Geometry* geometry)
+{
+	if (geometry->geometry_type == ccl::Geometry::Type::MESH)
+	{
+		// Cycles tessellate subdivided meshes and apply displacement to the vertices in-place
+		// so, such meshes can not be reused
+		ccl::Mesh* mesh = static_cast<ccl::Mesh*>(geometry);
+		if (mesh->get_subdivision_type() != ccl::Mesh::SUBDIVISION_NONE || mesh->attributes.find(ccl::ATTR_STD_POSITION_UNDISPLACED))
+		{
+			return;
+		}
+	}
+
+	// with static BVH Cycles applies object transform to the vertices in-place
+	// the restored geometry does not keep this flag, so the transform will be applied twice
+	if (geometry->transform_applied)
+	{
+		return;
+	}
+
+	is_active = true;
+
+	ccl::Geometry* cache_geometry = create_standalone_geometry(geometry->geometry_type);
+	if (cache_geometry == NULL)
+	{
+		return;
+	}
+
+	move_geometry_data(geometry, cache_geometry);
+
+	auto it = items.find(xsi_id);
+	if (it != items.end())
+	{
+		delete it->second.geometry;
+		items.erase(it);
+	}
+	items[xsi_id] = { hash, cache_geometry };
+}
+
+bool GeometryCache::restore(ULONG xsi_id, uint64_t hash, ccl::Geometry* geometry)
+{
+	if (!is_active)
+	{
+		return false;
+	}
+
+	auto it = items.find(xsi_id);
+	if (it == items.end() || it->second.hash != hash || it->second.geometry->geometry_type != geometry->geometry_type)
+	{
+		misses++;
+		return false;
+	}
+
+	move_geometry_data(it->second.geometry, geometry);
+
+	// each item can be used only once
+	delete it->second.geometry;
+	items.erase(it);
+	hits++;
+
+	return true;
+}
+
+size_t GeometryCache::get_hits()
+{
+	return hits;
+}
+
+size_t GeometryCache::get_misses()
+{
+	return misses;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "scene/scene.h"
+#include "scene/geometry.h"
+
+#include <xsi_geometry.h>
+#include <xsi_doublearray.h>
+#include <xsi_floatarray.h>
+#include <xsi_longarray.h>
+#include <xsi_string.h>
+#include <xsi_time.h>
+#include <xsi_vector4.h>
+
+#include <unordered_map>
+#include <vector>
+
+// incremental 64-bit hash of the data, used for geometry export
+// if the hash is the same, then exported Cycles geometry will be the same
+// it combines two 32-bit murmur hashes with different seeds, because a collision means that the wrong geometry is rendered
+class GeometryHash
+{
+public:
+	GeometryHash();
+	~GeometryHash();
+
+	void add(const void* data, size_t size);
+	void add(int value);
+	void add(ULONG value);
+	void add(float value);
+	void add(double value);
+	void add(const XSI::CString& value);
+	void add(const XSI::CTime& value);
+	void add(const XSI::CDoubleArray& array);
+	void add(const XSI::CFloatArray& array);
+	void add(const XSI::CLongArray& array);
+	void add(const std::vector<double>& array);
+	void add(const XSI::MATH::CVector4Array& array);
+	// add values of all ICE attributes, which can be exported to the geometry
+	void add_ice_attributes(const XSI::Geometry& xsi_geometry);
+	// add attributes, requested by shaders, because need_attribute depends on it
+	void add_shaders_attributes(const ccl::array<ccl::Node*>& used_shaders);
+
+	uint64_t get_value();
+
+private:
+	uint32_t value_low;
+	uint32_t value_high;
+};
+
+// store Cycles geometries from the previous scene
+// when the session is recreated (but the scene is not changed), then we can reuse these geometries instead of export it again
+// key - id of the xsi primitive, value - hash of the data at export time and standalone geometry object (not owned by any scene)
+class GeometryCache
+{
+public:
+	GeometryCache();
+	~GeometryCache();
+
+	void clear();
+	// return true if the cache was filled from the previous scene, then hits and misses are counted
+	bool get_is_active();
+
+	// move data from the scene geometry into the cache
+	void add(ULONG xsi_id, uint64_t hash, ccl::Geometry* geometry);
+	// move cached data into the new geometry, return false if the cache does not contains valid data for this primitive
+	bool restore(ULONG xsi_id, uint64_t hash, ccl::Geometry* geometry);
+
+	size_t get_hits();
+	size_t get_misses();
+
+private:
+	struct GeometryCacheItem
+	{
+		uint64_t hash;
+		ccl::Geometry* geometry;
+	};
+
+	std::unordered_map<ULONG, GeometryCacheItem> items;
+	bool is_active;
+	size_t hits;
+	size_t misses;
+};
@@ -2,6 +2,7 @@
 #include "scene/object.h"
 #include "scene/hair.h"
 #include "util/hash.h"
+#include "util/tbb.h"
 
 #include <xsi_x3dobject.h>
 #include <xsi_hairprimitive.h>
@@ -10,6 +11,12 @@
 #include <xsi_kinematics.h>
 #include <xsi_kinematicstate.h>
 #include <xsi_floatarray.h>
+#include <xsi_parameter.h>
+#include <xsi_geometry.h>
+#include <xsi_point.h>
+
+#include <vector>
+#include <algorithm>
 
 #include "../../update_context.h"
 #include "../../../utilities/xsi_properties.h"
@@ -19,313 +26,241 @@
 #include "../cyc_scene.h"
 #include "cyc_geometry.h"
 
-struct XsiHairUV
+// data of one chunk from the render hair accessor
+// all chunks are read in one pass, and then copied to the Cycles hair in parallel
+struct XsiHairChunk
 {
-	std::vector<ccl::float2> data;
+	XSI::CLongArray vertices_count;
+	XSI::CFloatArray positions;
+	XSI::CFloatArray radiuses;
+	std::vector<XSI::CFloatArray> uvs;
+	std::vector<XSI::CFloatArray> colors;
+	std::vector<XSI::CFloatArray> weights;
+	size_t first_curve;
+	size_t first_key;
 };
 
-struct XsiHairVertexColor
+LONG get_render_hairs_count(const XSI::HairPrimitive& xsi_hair, const XSI::CTime& eval_time)
 {
-	XSI::CString data_name;
-	std::vector<ccl::float4> data;
-};
-
-struct XsiHairWeightMap
-{
-	XSI::CString data_name;
-	std::vector<float> data;
-};
-
-void sync_hair_geom(ccl::Scene* scene, ccl::Hair* hair_geom, UpdateContext* update_context, const XSI::HairPrimitive &xsi_hair, bool use_motion_blur, ccl::vector<ccl::float4> &out_original_positions, LONG &out_num_keys)
-{
-	XSI::CTime eval_time = update_context->get_time();
-
 	LONG hairs_count = xsi_hair.GetParameterValue("TotalHairs", eval_time);
 	LONG strand_multiplicity = xsi_hair.GetParameterValue("StrandMult", eval_time);
 	if (strand_multiplicity <= 1)
 	{
 		strand_multiplicity = 1;
 	}
-	hairs_count = hairs_count * strand_multiplicity;
+
+	return hairs_count * strand_multiplicity;
+}
+
+void sync_hair_geom(ccl::Scene* scene, ccl::Hair* hair_geom, UpdateContext* update_context, const XSI::HairPrimitive &xsi_hair, bool use_motion_blur, ccl::vector<ccl::float4> &out_original_positions, LONG &out_num_keys)
+{
+	XSI::CTime eval_time = update_context->get_time();
+
+	LONG hairs_count = get_render_hairs_count(xsi_hair, eval_time);
 	XSI::CRenderHairAccessor rha = xsi_hair.GetRenderHairAccessor(hairs_count);
 	LONG num_uvs = rha.GetUVCount();
 	LONG num_colors = rha.GetVertexColorCount();
 	LONG num_weights = rha.GetWeightMapCount();
-	LONG i = 0;
+
+	// read all chunks in one pass
+	std::vector<XsiHairChunk> chunks;
+	LONG chunk_size = rha.GetChunkSize();
+	if (chunk_size > 0)
+	{
+		chunks.reserve((hairs_count + chunk_size - 1) / chunk_size);
+	}
+	size_t num_curves = 0;
+	size_t num_keys = 0;
+	while (rha.Next())
+	{
+		chunks.emplace_back();
+		XsiHairChunk& chunk = chunks.back();
+		rha.GetVerticesCount(chunk.vertices_count);
+		rha.GetVertexPositions(chunk.positions);
+		rha.GetVertexRadiusValues(chunk.radiuses);
+		chunk.uvs.resize(num_uvs);
+		for (LONG i = 0; i < num_uvs; i++)
+		{
+			rha.GetUVValues(i, chunk.uvs[i]);
+		}
+		chunk.colors.resize(num_colors);
+		for (LONG i = 0; i < num_colors; i++)
+		{
+			rha.GetVertexColorValues(i, chunk.colors[i]);
+		}
+		chunk.weights.resize(num_weights);
+		for (LONG i = 0; i < num_weights; i++)
+		{
+			rha.GetWeightMapValues(i, chunk.weights[i]);
+		}
+
+		chunk.first_curve = num_curves;
+		chunk.first_key = num_keys;
+		LONG strands_count = chunk.vertices_count.GetCount();
+		const LONG* vertices_count = chunk.vertices_count.GetArray();
+		for (LONG i = 0; i < strands_count; i++)
+		{
+			num_keys += vertices_count[i];
+		}
+		num_curves += strands_count;
+	}
+	out_num_keys = num_keys;
+
+	// allocate all curves and keys at once
+	hair_geom->resize_curves(num_curves, num_keys);
+	ccl::float3* curve_keys = hair_geom->get_curve_keys().data();
+	float* curve_radius = hair_geom->get_curve_radius().data();
+	int* curve_first_key = hair_geom->get_curve_first_key().data();
+	int* curve_shader = hair_geom->get_curve_shader().data();
+
+	if (use_motion_blur)
+	{
+		out_original_positions.resize(num_keys);
+	}
 
 	// prepare attributes
-	ccl::Attribute* attr_intercept = NULL;
-	ccl::Attribute* attr_random = NULL;
-	ccl::Attribute* attr_length = NULL;
+	float* intercept_data = NULL;
+	float* random_data = NULL;
+	float* length_data = NULL;
 	if (hair_geom->need_attribute(scene, ccl::ATTR_STD_CURVE_INTERCEPT))
 	{
-		attr_intercept = hair_geom->attributes.add(ccl::ATTR_STD_CURVE_INTERCEPT);
+		intercept_data = hair_geom->attributes.add(ccl::ATTR_STD_CURVE_INTERCEPT)->data_float();
 	}
 	if (hair_geom->need_attribute(scene, ccl::ATTR_STD_CURVE_RANDOM))
 	{
-		attr_random = hair_geom->attributes.add(ccl::ATTR_STD_CURVE_RANDOM);
+		random_data = hair_geom->attributes.add(ccl::ATTR_STD_CURVE_RANDOM)->data_float();
 	}
 	if (hair_geom->need_attribute(scene, ccl::ATTR_STD_CURVE_LENGTH))
 	{
-		attr_length = hair_geom->attributes.add(ccl::ATTR_STD_CURVE_LENGTH);
+		length_data = hair_geom->attributes.add(ccl::ATTR_STD_CURVE_LENGTH)->data_float();
 	}
 
-	// prepare store structures
-	std::vector<XsiHairUV> uv_data;
+	std::vector<ccl::float2*> uv_attributes_data(num_uvs, NULL);
 	for (LONG uv_index = 0; uv_index < num_uvs; uv_index++)
 	{
-		XsiHairUV new_data;
-		new_data.data.resize(0);
-		uv_data.push_back(new_data);
-	}
-	std::vector<XsiHairVertexColor> color_data;
-	for (LONG color_index = 0; color_index < num_colors; color_index++)
-	{
-		XsiHairVertexColor new_data;
-		new_data.data.resize(0);
-		color_data.push_back(new_data);
+		ccl::ustring attr_name = ccl::ustring("uv" + std::to_string(uv_index));
+		if (hair_geom->need_attribute(scene, attr_name))
+		{
+			uv_attributes_data[uv_index] = hair_geom->attributes.add(attr_name, ccl::TypeFloat2, ccl::ATTR_ELEMENT_CURVE)->data_float2();
+		}
 	}
-
-	std::vector<XsiHairWeightMap> weight_data;
-	for (LONG weight_index = 0; weight_index < num_weights; weight_index++)
+	// default uv
+	ccl::float2* default_uv_data = NULL;
+	if (hair_geom->need_attribute(scene, ccl::ATTR_STD_UV) && num_uvs > 0)
 	{
-		XsiHairWeightMap new_data;
-		new_data.data.resize(0);
-		weight_data.push_back(new_data);
+		default_uv_data = hair_geom->attributes.add(ccl::ATTR_STD_UV, ccl::ustring("std_uv"))->data_float2();
 	}
 
-	// get keys and curves data
-	LONG num_curves = 0;
-	while (rha.Next())
+	std::vector<ccl::float4*> color_attributes_data(num_colors, NULL);
+	for (LONG color_index = 0; color_index < num_colors; color_index++)
 	{
-		XSI::CLongArray vertices_count_array;
-		rha.GetVerticesCount(vertices_count_array);
-		LONG strands_count = vertices_count_array.GetCount();
-		for (i = 0; i < strands_count; i++)
+		ccl::ustring attr_name = ccl::ustring(rha.GetVertexColorName(color_index).GetAsciiString());
+		if (hair_geom->need_attribute(scene, attr_name))
 		{
-			LONG n_count = vertices_count_array[i];
-			out_num_keys += n_count;
+			color_attributes_data[color_index] = hair_geom->attributes.add(attr_name, ccl::TypeRGBA, ccl::ATTR_ELEMENT_CURVE)->data_float4();
 		}
-		num_curves += strands_count;
 	}
 
-	size_t original_index = 0;
-
-	if (use_motion_blur)
+	std::vector<float*> weight_attributes_data(num_weights, NULL);
+	for (LONG weight_index = 0; weight_index < num_weights; weight_index++)
 	{
-		out_original_positions.resize(out_num_keys);
+		ccl::ustring attr_name = ccl::ustring(rha.GetWeightMapName(weight_index).GetAsciiString());
+		if (hair_geom->need_attribute(scene, attr_name))
+		{
+			weight_attributes_data[weight_index] = hair_geom->attributes.add(attr_name, ccl::TypeFloat, ccl::ATTR_ELEMENT_CURVE)->data_float();
+		}
 	}
 
-	hair_geom->reserve_curves(num_curves, out_num_keys);
+	ccl::float3* generated = hair_geom->attributes.add(ccl::ATTR_STD_GENERATED)->data_float3();
 
-	rha.Reset();
-	// set hair data
-	out_num_keys = 0;
-	while (rha.Next())
+	// each chunk writes to its own range of curves and keys, so process them in parallel
+	ccl::parallel_for((size_t)0, chunks.size(), [&](size_t chunk_index)
 	{
-		XSI::CLongArray vertices_count_array;  // vertex count in each hair strand
-		rha.GetVerticesCount(vertices_count_array);
-		LONG strands_count = vertices_count_array.GetCount();
-		XSI::CFloatArray pos_vals;
-		rha.GetVertexPositions(pos_vals);  // actual vertex positions for all hairs
-		XSI::CFloatArray rad_vals;
-		rha.GetVertexRadiusValues(rad_vals);  // point radius
-		LONG pos_k = 0;
-		LONG radius_k = 0;
-		// positions
-		for (i = 0; i < strands_count; i++)
+		const XsiHairChunk& chunk = chunks[chunk_index];
+		LONG strands_count = chunk.vertices_count.GetCount();
+		const LONG* vertices_count = chunk.vertices_count.GetArray();
+		const float* positions = chunk.positions.GetArray();
+		const float* radiuses = chunk.radiuses.GetArray();
+
+		size_t key_index = chunk.first_key;
+		for (LONG i = 0; i < strands_count; i++)
 		{
-			LONG n_count = vertices_count_array[i];
+			size_t curve_index = chunk.first_curve + i;
+			LONG n_count = vertices_count[i];
 			float strand_length = 0.0f;
+			curve_first_key[curve_index] = key_index;
+			curve_shader[curve_index] = 0;
 			for (LONG j = 0; j < n_count; j++)
 			{
-				hair_geom->add_curve_key(ccl::make_float3(pos_vals[pos_k], pos_vals[pos_k + 1], pos_vals[pos_k + 2]), rad_vals[radius_k]);
+				const float* p = positions + 3 * key_index - 3 * chunk.first_key;
+				float radius = radiuses[key_index - chunk.first_key];
+				curve_keys[key_index] = ccl::make_float3(p[0], p[1], p[2]);
+				curve_radius[key_index] = radius;
 				if (use_motion_blur)
 				{
-					out_original_positions[original_index] = ccl::make_float4(pos_vals[pos_k], pos_vals[pos_k + 1], pos_vals[pos_k + 2], rad_vals[radius_k]);
-					original_index++;
+					out_original_positions[key_index] = ccl::make_float4(p[0], p[1], p[2], radius);
 				}
 				// increase strand length
 				if (j > 0)
 				{
-					float dx = pos_vals[pos_k] - pos_vals[pos_k - 3];
-					float dy = pos_vals[pos_k + 1] - pos_vals[pos_k - 2];
-					float dz = pos_vals[pos_k + 2] - pos_vals[pos_k - 1];
+					float dx = p[0] - p[-3];
+					float dy = p[1] - p[-2];
+					float dz = p[2] - p[-1];
 					strand_length += sqrtf(dx * dx + dy * dy + dz * dz);
 				}
-				pos_k = pos_k + 3;
-				radius_k = radius_k + 1;
-				if (attr_intercept)
+				if (intercept_data != NULL)
 				{
-					if (j == 0)
-					{
-						attr_intercept->add(0.0);
-					}
-					else
-					{
-						attr_intercept->add((float)j / (float)(n_count - 1));
-					}
+					intercept_data[key_index] = j == 0 ? 0.0f : (float)j / (float)(n_count - 1);
 				}
+				key_index++;
 			}
-			if (attr_random != NULL)
+			if (random_data != NULL)
 			{
-				attr_random->add(ccl::hash_uint2_to_float(i, 0));
+				random_data[curve_index] = ccl::hash_uint2_to_float(curve_index, 0);
 			}
-			if (attr_length != NULL)
+			if (length_data != NULL)
 			{
-				attr_length->add(strand_length);
+				length_data[curve_index] = strand_length;
 			}
-			hair_geom->add_curve(out_num_keys, 0);
-			out_num_keys += n_count;
-		}
+			generated[curve_index] = curve_keys[curve_first_key[curve_index]];
 
-		// uvs
-		for (i = 0; i < num_uvs; i++)
-		{
-			XSI::CFloatArray uv_vals;
-			rha.GetUVValues(i, uv_vals);
-			LONG uv_vals_count = uv_vals.GetCount();
-			for (LONG j = 0; j < uv_vals_count; j += 3)
+			// uvs, colors and weights are defined per strand, if there are no values for the strand, then use zero
+			for (LONG uv_index = 0; uv_index < num_uvs; uv_index++)
 			{
-				ccl::float2 new_uv_data = ccl::make_float2(uv_vals[j], uv_vals[j + 1]);
-				uv_data[i].data.push_back(new_uv_data);
-			}
-			for (LONG j = uv_vals_count / 3; j < strands_count; j++)
-			{
-				uv_data[i].data.push_back(ccl::make_float2(0, 0));
-			}
-		}
-
-		// vertex color
-		for (i = 0; i < num_colors; i++)
-		{
-			XSI::CFloatArray color_values;
-			rha.GetVertexColorValues(i, color_values);
-			LONG colors_count = color_values.GetCount();
-			XSI::CString colors_name = rha.GetVertexColorName(i);
-			color_data[i].data_name = colors_name;
-			for (LONG j = 0; j < colors_count; j += 4)
-			{
-				color_data[i].data.push_back(ccl::make_float4(color_values[j], color_values[j + 1], color_values[j + 2], 1.0));
-			}
-			for (LONG j = colors_count / 4; j < strands_count; j++)
-			{
-				color_data[i].data.push_back(ccl::make_float4(0, 0, 0, 1.0));
-			}
-		}
-
-		// weight map
-		for (i = 0; i < num_weights; i++)
-		{
-			XSI::CFloatArray weight_values;
-			rha.GetWeightMapValues(i, weight_values);
-			LONG weight_count = weight_values.GetCount();
-			XSI::CString weight_name = rha.GetWeightMapName(i);
-			weight_data[i].data_name = weight_name;
-			for (LONG j = 0; j < weight_count; j++)
-			{
-				weight_data[i].data.push_back(weight_values[j]);
-			}
-			for (LONG j = weight_count; j < strands_count; j++)
-			{
-				weight_data[i].data.push_back(0);
+				const XSI::CFloatArray& uv_vals = chunk.uvs[uv_index];
+				ccl::float2 uv = i < uv_vals.GetCount() / 3 ? ccl::make_float2(uv_vals[3 * i], uv_vals[3 * i + 1]) : ccl::make_float2(0.0f, 0.0f);
+				if (uv_attributes_data[uv_index] != NULL)
+				{
+					uv_attributes_data[uv_index][curve_index] = uv;
+				}
+				if (uv_index == 0 && default_uv_data != NULL)
+				{
+					default_uv_data[curve_index] = uv;
+				}
 			}
-		}
-	}
-
-	// set attribute values
-	for (size_t uv_set_index = 0; uv_set_index < uv_data.size(); uv_set_index++)
-	{
-		ccl::ustring attr_name = ccl::ustring("uv" + std::to_string(uv_set_index));
-		if (hair_geom->need_attribute(scene, attr_name))
-		{
-			ccl::Attribute* new_uv_attribute = hair_geom->attributes.add(attr_name, ccl::TypeFloat2, ccl::ATTR_ELEMENT_CURVE);
-			ccl::float2* attr_data = new_uv_attribute->data_float2();
-			for (size_t d_index = 0; d_index < uv_data[uv_set_index].data.size(); d_index++)
+			for (LONG color_index = 0; color_index < num_colors; color_index++)
 			{
-				*attr_data = uv_data[uv_set_index].data[d_index];
-				attr_data++;
+				if (color_attributes_data[color_index] != NULL)
+				{
+					const XSI::CFloatArray& color_values = chunk.colors[color_index];
+					color_attributes_data[color_index][curve_index] = i < color_values.GetCount() / 4 ? ccl::make_float4(color_values[4 * i], color_values[4 * i + 1], color_values[4 * i + 2], 1.0f) : ccl::make_float4(0.0f, 0.0f, 0.0f, 1.0f);
+				}
 			}
-		}
-	}
-	// default uv
-	if (hair_geom->need_attribute(scene, ccl::ATTR_STD_UV) && uv_data.size() > 0)
-	{
-		ccl::Attribute* attr_uv = hair_geom->attributes.add(ccl::ATTR_STD_UV, ccl::ustring("std_uv"));
-		ccl::float2* attr_data = attr_uv->data_float2();
-		for (size_t d_index = 0; d_index < uv_data[0].data.size(); d_index++)
-		{
-			*attr_data = uv_data[0].data[d_index];
-			attr_data++;
-		}
-	}
-
-	// vertex color
-	for (size_t color_index = 0; color_index < color_data.size(); color_index++)
-	{
-		ccl::ustring attr_name = ccl::ustring(color_data[color_index].data_name.GetAsciiString());
-		if (hair_geom->need_attribute(scene, attr_name))
-		{
-			ccl::Attribute* color_attr = hair_geom->attributes.add(attr_name, ccl::TypeRGBA, ccl::ATTR_ELEMENT_CURVE);
-			ccl::float4* attr_data = color_attr->data_float4();
-			for (size_t d_index = 0; d_index < color_data[color_index].data.size(); d_index++)
+			for (LONG weight_index = 0; weight_index < num_weights; weight_index++)
 			{
-				*attr_data = color_data[color_index].data[d_index];
-				attr_data++;
-			}
-		}
-	}
-
-	// weigh maps
-	for (size_t weight_index = 0; weight_index < weight_data.size(); weight_index++)
-	{
-		ccl::ustring attr_name = ccl::ustring(weight_data[weight_index].data_name.GetAsciiString());
-		if (hair_geom->need_attribute(scene, attr_name))
-		{
-			ccl::Attribute* weight_attr = hair_geom->attributes.add(attr_name, ccl::TypeFloat, ccl::ATTR_ELEMENT_CURVE);
-			float* attr_data = weight_attr->data_float();
-			for (size_t d_index = 0; d_index < weight_data[weight_index].data.size(); d_index++)
-			{
-				*attr_data = weight_data[weight_index].data[d_index];
-				attr_data++;
+				if (weight_attributes_data[weight_index] != NULL)
+				{
+					const XSI::CFloatArray& weight_values = chunk.weights[weight_index];
+					weight_attributes_data[weight_index][curve_index] = i < weight_values.GetCount() ? weight_values[i] : 0.0f;
+				}
 			}
 		}
-	}
-
-	// generate STD_GENERATED attribute
-	ccl::Attribute* attr_generated = hair_geom->attributes.add(ccl::ATTR_STD_GENERATED);
-	ccl::float3* generated = attr_generated->data_float3();
+	});
 
-	for (size_t gen_i = 0; gen_i < hair_geom->num_curves(); gen_i++)
-	{
-		ccl::float3 co = hair_geom->get_curve_keys()[hair_geom->get_curve(gen_i).first_key];
-		generated[gen_i] = co;
-	}
-
-	// clear temporary data
-	for (size_t uv_index = 0; uv_index < uv_data.size(); uv_index++)
-	{
-		uv_data[uv_index].data.clear();
-		uv_data[uv_index].data.shrink_to_fit();
-	}
-	uv_data.clear();
-	uv_data.shrink_to_fit();
-
-	for (size_t color_index = 0; color_index < color_data.size(); color_index++)
-	{
-		color_data[color_index].data.clear();
-		color_data[color_index].data.shrink_to_fit();
-	}
-	color_data.clear();
-	color_data.shrink_to_fit();
-
-	for (size_t weight_index = 0; weight_index < weight_data.size(); weight_index++)
-	{
-		weight_data[weight_index].data.clear();
-		weight_data[weight_index].data.shrink_to_fit();
-	}
-	weight_data.clear();
-	weight_data.shrink_to_fit();
+	hair_geom->tag_curve_keys_modified();
+	hair_geom->tag_curve_radius_modified();
+	hair_geom->tag_curve_first_key_modified();
+	hair_geom->tag_curve_shader_modified();
 }
 
 void sync_hair_motion_deform(ccl::Hair* hair, UpdateContext* update_context, const XSI::X3DObject &xsi_object, LONG num_keys, const ccl::vector<ccl::float4> &original_positions)
@@ -334,7 +269,6 @@ void sync_hair_motion_deform(ccl::Hair* hair, UpdateContext* update_context, con
 	hair->set_motion_steps(motion_steps);
 	hair->set_use_motion_blur(true);
 
-	size_t attribute_index = 0;
 	ccl::Attribute* attr_m_positions = hair->attributes.add(ccl::ATTR_STD_MOTION_VERTEX_POSITION, ccl::ustring("std_motion_strand_position"));
 	ccl::float4* motion_positions = attr_m_positions->data_float4();
 	MotionSettingsPosition motion_position = update_context->get_motion_position();
@@ -345,61 +279,33 @@ void sync_hair_motion_deform(ccl::Hair* hair, UpdateContext* update_context, con
 		float time = update_context->get_motion_time(time_motion_step);
 
 		XSI::HairPrimitive time_primitive(xsi_object.GetActivePrimitive(time));
-		LONG time_total_hairs = time_primitive.GetParameterValue("TotalHairs");
-		LONG time_strands_mult = time_primitive.GetParameterValue("StrandMult");
-		if (time_strands_mult <= 1)
-		{
-			time_strands_mult = 1;
-		}
-		time_total_hairs = time_total_hairs * time_strands_mult;
-		XSI::CRenderHairAccessor time_rha = time_primitive.GetRenderHairAccessor(time_total_hairs);
+		XSI::CRenderHairAccessor time_rha = time_primitive.GetRenderHairAccessor(get_render_hairs_count(time_primitive, time));
+
+		// write keys directly into the motion step, if the number of keys is different, then overwrite it by original positions
+		ccl::float4* step_positions = motion_positions + mi * num_keys;
 		LONG time_keys_count = 0;
 		while (time_rha.Next())
 		{
-			XSI::CLongArray time_vertex_count;
-			time_rha.GetVerticesCount(time_vertex_count);
-			LONG time_strands = time_vertex_count.GetCount();
-			for (LONG i = 0; i < time_strands; i++)
-			{
-				LONG n_count = time_vertex_count[i];
-				time_keys_count += n_count;
-			}
-		}
-
-		time_rha.Reset();
-		if (time_keys_count == num_keys)
-		{
-			while (time_rha.Next())
+			XSI::CFloatArray time_positions;
+			time_rha.GetVertexPositions(time_positions);
+			XSI::CFloatArray time_radiuses;
+			time_rha.GetVertexRadiusValues(time_radiuses);
+			LONG chunk_keys = time_radiuses.GetCount();
+			if (time_keys_count + chunk_keys <= num_keys)
 			{
-				XSI::CLongArray time_vertices_count_array;
-				time_rha.GetVerticesCount(time_vertices_count_array);
-				LONG time_strands_count = time_vertices_count_array.GetCount();
-				XSI::CFloatArray time_positions;
-				time_rha.GetVertexPositions(time_positions);
-				XSI::CFloatArray time_radiuses;
-				time_rha.GetVertexRadiusValues(time_radiuses);
-				LONG time_pos_key = 0;
-				LONG time_rad_key = 0;
-				// positions
-				for (LONG i = 0; i < time_strands_count; i++)
+				const float* positions = time_positions.GetArray();
+				const float* radiuses = time_radiuses.GetArray();
+				for (LONG k = 0; k < chunk_keys; k++)
 				{
-					LONG time_n_count = time_vertices_count_array[i];
-					for (LONG j = 0; j < time_n_count; j++)
-					{
-						ccl::float4 val = ccl::make_float4(time_positions[time_pos_key], time_positions[time_pos_key + 1], time_positions[time_pos_key + 2], time_radiuses[time_rad_key]);
-						motion_positions[attribute_index++] = val;
-						time_pos_key = time_pos_key + 3;
-						time_rad_key = time_rad_key + 1;
-					}
+					step_positions[time_keys_count + k] = ccl::make_float4(positions[3 * k], positions[3 * k + 1], positions[3 * k + 2], radiuses[k]);
 				}
 			}
+			time_keys_count += chunk_keys;
 		}
-		else
+
+		if (time_keys_count != num_keys)
 		{// invalid data, the number of keys is nonequal to original
-			for (size_t k_index = 0; k_index < original_positions.size(); k_index++)
-			{
-				motion_positions[attribute_index++] = original_positions[k_index];
-			}
+			std::copy(original_positions.begin(), original_positions.end(), step_positions);
 		}
 	}
 }
@@ -412,6 +318,9 @@ void sync_hair_geom_process(ccl::Scene* scene, ccl::Hair* hair_geom, UpdateConte
 	LONG num_keys = 0;
 	bool use_motion_blur = update_context->get_need_motion() && motion_deform;
 
+	// hairs are not reused from the previous session
+	// render hairs depend on weight maps, textures and emitter geometry, and only the full export contains all these data
+
 	sync_hair_geom(scene, hair_geom, update_context, xsi_hair, use_motion_blur, original_positions, num_keys);
 	if (use_motion_blur)
 	{
@@ -459,7 +368,7 @@ ccl::Hair* sync_hair_object(ccl::Scene* scene, ccl::Object* hair_object, UpdateC
 	XSI::Material xsi_material = xsi_object.GetMaterial();
 	ULONG xsi_material_id = xsi_material.GetObjectID();
 	size_t shader_index = 0;
-	if (update_context->is_material_exists(xsi_material_id))
+	if (sync_used_material(scene, update_context, xsi_material))
 	{
 		shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
 	}
@@ -0,0 +1,121 @@
+#pragma once
+#include "util/types.h"
+
+#include <xsi_iceattributedataarray.h>
+#include <xsi_vector2f.h>
+#include <xsi_vector3f.h>
+#include <xsi_color4f.h>
+
+#include <vector>
+#include <algorithm>
+
+// typed gather kernels for copying the whole ICE attribute data array into the Cycles attribute buffer
+// if remap is empty, then output element i is the input element i (contiguous path)
+// otherwise output element i is the input element remap[i]
+// constant arrays (and singleton attributes) are broadcasted to all output elements
+
+// return pointer to the plain buffer of the attribute data, it can be used from several threads
+// out_step is the distance between elements: 1 for usual arrays and 0 for constant arrays (all elements share one value)
+// return NULL for empty arrays
+template<typename T>
+const T* get_ice_attribute_buffer(const XSI::CICEAttributeDataArray<T>& data, size_t& out_step)
+{
+	out_step = (data.IsConstant() || data.GetCount() == 1) ? 0 : 1;
+	if (data.GetCount() == 0)
+	{
+		return NULL;
+	}
+
+	return &data[0];
+}
+
+template<typename T, typename C, typename F>
+void gather_ice_attribute(const XSI::CICEAttributeDataArray<T>& data, C* output, size_t output_count, const std::vector<LONG>& remap, F convert)
+{
+	size_t data_count = data.GetCount();
+	if (data_count == 0 || output_count == 0)
+	{
+		return;
+	}
+
+	if (data.IsConstant() || data_count == 1)
+	{
+		std::fill(output, output + output_count, convert(data[0]));
+		return;
+	}
+
+	// all non-constant values are stored in one plain buffer, so read it directly
+	const T* src = &data[0];
+	if (remap.size() == 0)
+	{
+		size_t count = std::min(output_count, data_count);
+		for (size_t i = 0; i < count; i++)
+		{
+			output[i] = convert(src[i]);
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < output_count; i++)
+		{
+			output[i] = convert(src[remap[i]]);
+		}
+	}
+}
+
+// boolean arrays are stored as bits, so here we can use only per-element access
+inline void gather_ice_attribute(const XSI::CICEAttributeDataArrayBool& data, float* output, size_t output_count, const std::vector<LONG>& remap)
+{
+	size_t data_count = data.GetCount();
+	if (data_count == 0 || output_count == 0)
+	{
+		return;
+	}
+
+	if (data.IsConstant() || data_count == 1)
+	{
+		std::fill(output, output + output_count, data[0] ? 1.0f : 0.0f);
+		return;
+	}
+
+	if (remap.size() == 0)
+	{
+		size_t count = std::min(output_count, data_count);
+		for (size_t i = 0; i < count; i++)
+		{
+			output[i] = data[i] ? 1.0f : 0.0f;
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < output_count; i++)
+		{
+			output[i] = data[remap[i]] ? 1.0f : 0.0f;
+		}
+	}
+}
+
+inline void gather_ice_attribute(const XSI::CICEAttributeDataArrayFloat& data, float* output, size_t output_count, const std::vector<LONG>& remap)
+{
+	gather_ice_attribute(data, output, output_count, remap, [](const float& v) { return v; });
+}
+
+inline void gather_ice_attribute(const XSI::CICEAttributeDataArrayLong& data, float* output, size_t output_count, const std::vector<LONG>& remap)
+{
+	gather_ice_attribute(data, output, output_count, remap, [](const LONG& v) { return (float)v; });
+}
+
+inline void gather_ice_attribute(const XSI::CICEAttributeDataArrayVector2f& data, ccl::float2* output, size_t output_count, const std::vector<LONG>& remap)
+{
+	gather_ice_attribute(data, output, output_count, remap, [](const XSI::MATH::CVector2f& v) { return ccl::make_float2(v.GetX(), v.GetY()); });
+}
+
+inline void gather_ice_attribute(const XSI::CICEAttributeDataArrayVector3f& data, ccl::float3* output, size_t output_count, const std::vector<LONG>& remap)
+{
+	gather_ice_attribute(data, output, output_count, remap, [](const XSI::MATH::CVector3f& v) { return ccl::make_float3(v.GetX(), v.GetY(), v.GetZ()); });
+}
+
+inline void gather_ice_attribute(const XSI::CICEAttributeDataArrayColor4f& data, ccl::float4* output, size_t output_count, const std::vector<LONG>& remap)
+{
+	gather_ice_attribute(data, output, output_count, remap, [](const XSI::MATH::CColor4f& c) { return ccl::make_float4(c.GetR(), c.GetG(), c.GetB(), c.GetA()); });
+}
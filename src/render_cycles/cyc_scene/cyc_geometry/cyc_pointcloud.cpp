@@ -1,3 +1,6 @@
+#include "util/tbb.h"
+#include "util/hash.h"
+
 #include <xsi_x3dobject.h>
 #include <xsi_primitive.h>
 #include <xsi_geometry.h>
@@ -5,9 +8,11 @@
 #include <xsi_iceattributedataarray.h>
 #include <xsi_kinematics.h>
 #include <xsi_kinematicstate.h>
+#include <xsi_material.h>
 
 #include "../../../render_base/type_enums.h"
 #include "cyc_geometry.h"
+#include "cyc_ice_attributes.h"
 #include "../cyc_scene.h"
 #include "../../../utilities/logs.h"
 #include "../../../utilities/math.h"
@@ -144,80 +149,141 @@ XSI::MATH::CTransformation build_point_transform(const XSI::MATH::CVector3f& pos
 	return build_point_transform(position, rotation, size_vector);
 }
 
-std::vector<std::vector<XSI::MATH::CTransformation>> build_time_points_transforms(const XSI::X3DObject &xsi_object, const std::vector<double> &motion_times)
+std::vector<XSI::MATH::CTransformation> build_points_transforms(const XSI::Geometry& xsi_geometry, std::vector<ULONG>& out_valid_points)
 {
-	size_t motion_times_count = motion_times.size();
-	// get geometries for all times
-	std::vector<XSI::Geometry> xsi_time_geometies(motion_times_count);
-	for (size_t i = 0; i < motion_times_count; i++)
+	XSI::ICEAttribute shape_attribute = xsi_geometry.GetICEAttributeFromName("Shape");
+	XSI::CICEAttributeDataArrayShape shape_data;
+	shape_attribute.GetDataArray(shape_data);
+
+	XSI::ICEAttribute position_attribute = xsi_geometry.GetICEAttributeFromName("PointPosition");
+	XSI::CICEAttributeDataArrayVector3f position_data;
+	position_attribute.GetDataArray(position_data);
+
+	XSI::ICEAttribute orientation_attribute = xsi_geometry.GetICEAttributeFromName("Orientation");
+	XSI::CICEAttributeDataArrayRotationf rotation_data;
+	orientation_attribute.GetDataArray(rotation_data);
+
+	XSI::ICEAttribute size_attribute = xsi_geometry.GetICEAttributeFromName("Size");
+	XSI::CICEAttributeDataArrayFloat size_data;
+	size_attribute.GetDataArray(size_data);
+
+	XSI::ICEAttribute scale_attribute = xsi_geometry.GetICEAttributeFromName("Scale");
+	XSI::CICEAttributeDataArrayVector3f scale_data;
+	scale_attribute.GetDataArray(scale_data);
+
+	size_t shape_data_count = shape_data.GetCount();
+	// constant arrays contain only one element, so the number of elements is checked only for per-point scale
+	ULONG scale_count = scale_data.GetCount();
+	bool is_scale_define = scale_attribute.IsDefined();
+
+	// shapes can be read only per element, so find valid points at first
+	out_valid_points.clear();
+	out_valid_points.reserve(shape_data_count);
+	for (size_t i = 0; i < shape_data_count; i++)
 	{
-		float time = motion_times[i];
-		xsi_time_geometies[i] = xsi_object.GetActivePrimitive(time).GetGeometry(time);
+		if (is_valid_shape(shape_data[i].GetType()))
+		{
+			out_valid_points.push_back(i);
+		}
 	}
 
-	std::vector<std::vector<XSI::MATH::CTransformation>> time_points_tfms(motion_times_count);
-	for (size_t time_index = 0; time_index < motion_times_count; time_index++)
+	std::vector<XSI::MATH::CTransformation> points_tfms(out_valid_points.size());
+	size_t position_step = 0;
+	size_t rotation_step = 0;
+	size_t size_step = 0;
+	size_t scale_step = 0;
+	const XSI::MATH::CVector3f* positions = get_ice_attribute_buffer(position_data, position_step);
+	const XSI::MATH::CRotationf* rotations = get_ice_attribute_buffer(rotation_data, rotation_step);
+	const float* sizes = get_ice_attribute_buffer(size_data, size_step);
+	const XSI::MATH::CVector3f* scales = get_ice_attribute_buffer(scale_data, scale_step);
+	if (positions == NULL || rotations == NULL || sizes == NULL)
 	{
-		XSI::Geometry time_geometry = xsi_time_geometies[time_index];
-		XSI::ICEAttribute time_shape_attribute = time_geometry.GetICEAttributeFromName("Shape");
-		XSI::CICEAttributeDataArrayShape time_shape_data;
-		time_shape_attribute.GetDataArray(time_shape_data);
+		out_valid_points.clear();
+		return {};
+	}
 
-		XSI::ICEAttribute time_position_attribute = time_geometry.GetICEAttributeFromName("PointPosition");
-		XSI::CICEAttributeDataArrayVector3f time_position_data;
-		time_position_attribute.GetDataArray(time_position_data);
+	// next build transforms for all valid points in parallel
+	ccl::parallel_for((size_t)0, out_valid_points.size(), [&](size_t k)
+	{
+		ULONG i = out_valid_points[k];
+		points_tfms[k] = build_point_transform(positions[i * position_step], rotations[i * rotation_step], sizes[i * size_step], (scales != NULL && (scale_step == 0 || i < scale_count)) ? scales[i * scale_step] : XSI::MATH::CVector3f(1.0f, 1.0f, 1.0f), is_scale_define);
+	});
 
-		XSI::ICEAttribute time_orientation_attribute = time_geometry.GetICEAttributeFromName("Orientation");
-		XSI::CICEAttributeDataArrayRotationf time_rotation_data;
-		time_orientation_attribute.GetDataArray(time_rotation_data);
+	return points_tfms;
+}
 
-		XSI::ICEAttribute time_size_attribute = time_geometry.GetICEAttributeFromName("Size");
-		XSI::CICEAttributeDataArrayFloat time_size_data;
-		time_size_attribute.GetDataArray(time_size_data);
+std::vector<std::vector<XSI::MATH::CTransformation>> build_time_points_transforms(const XSI::X3DObject &xsi_object, const std::vector<double> &motion_times)
+{
+	size_t motion_times_count = motion_times.size();
 
-		XSI::ICEAttribute time_scale_attribute = time_geometry.GetICEAttributeFromName("Scale");
-		XSI::CICEAttributeDataArrayVector3f time_scale_data;
-		time_scale_attribute.GetDataArray(time_scale_data);
+	// at each time the number of points can be different with respect to current time
+	// but we will create array of arrays of transforms for each point at each time
+	std::vector<std::vector<XSI::MATH::CTransformation>> time_points_tfms(motion_times_count);
+	std::vector<ULONG> time_valid_points;
+	for (size_t time_index = 0; time_index < motion_times_count; time_index++)
+	{
+		float time = motion_times[time_index];
+		XSI::Geometry time_geometry = xsi_object.GetActivePrimitive(time).GetGeometry(time);
+		time_points_tfms[time_index] = build_points_transforms(time_geometry, time_valid_points);
+	}
 
-		size_t time_shape_data_count = time_shape_data.GetCount();
-		int time_scale_count = time_scale_attribute.GetElementCount();
-		bool is_time_scale_define = time_scale_attribute.IsDefined();
+	return time_points_tfms;
+}
+
+size_t get_pointcloud_shader_index(ccl::Scene* scene, UpdateContext* update_context, XSI::X3DObject& xsi_pointcloud)
+{
+	XSI::Material xsi_material = xsi_pointcloud.GetMaterial();
+	ULONG xsi_material_id = xsi_material.GetObjectID();
+	if (sync_used_material(scene, update_context, xsi_material))
+	{
+		return update_context->get_xsi_material_cycles_index(xsi_material_id);
+	}
+
+	return 0;
+}
 
-		// at this time the number of points can be different with respect to current time
-		// but we will create array of arrays of transforms for each point at each time
-		for (size_t time_i = 0; time_i < time_shape_data_count; time_i++)
+// copy object parameters (visibility, lightgroup, holdout and so on) from one object to another
+// only unique values (pass id and random id) are recalculated
+void copy_point_object_parameters(ccl::Scene* scene, ccl::Object* object, const ccl::Object* template_object, bool unique_pass_id)
+{
+	for (const ccl::SocketType& socket : template_object->type->inputs)
+	{
+		if (socket.type == ccl::SocketType::NODE || socket.type == ccl::SocketType::NODE_ARRAY)
 		{
-			XSI::siICEShapeType time_shape_type = time_shape_data[time_i].GetType();
-			if (is_valid_shape(time_shape_type))
-			{
-				XSI::MATH::CTransformation time_point_tfm = build_point_transform(time_position_data[time_i], time_rotation_data[time_i], time_size_data[time_i], time_i < time_scale_count ? time_scale_data[time_i] : XSI::MATH::CVector3f(1.0f, 1.0f, 1.0f), is_time_scale_define);
-				time_points_tfms[time_index].push_back(time_point_tfm);
-			}
+			continue;
 		}
+		object->set_value(socket, *template_object, socket);
 	}
+	object->name = template_object->name;
 
-	return time_points_tfms;
+	// use the same index as sync_geometry_object_parameters, the object is already added to the scene
+	size_t object_index = scene->objects.size();
+	if (unique_pass_id)
+	{
+		object->set_pass_id(object_index);
+	}
+	XSI::CString to_hash = XSI::CString(object->name.c_str()) + "_" + XSI::CString(object_index);
+	object->set_random_id(ccl::hash_uint2(ccl::hash_string(to_hash.GetAsciiString()), 0));
+
+	object->tag_update(scene);
 }
 
-void sync_point_primitive_shape(ccl::Scene* scene, ccl::Object* object, UpdateContext* update_context, XSI::siICEShapeType shape_type, const XSI::MATH::CColor4f &color, const std::vector<XSI::MATH::CTransformation> &point_tfms, XSI::X3DObject &xsi_pointcloud, const XSI::CTime &eval_time)
+void sync_point_primitive_shape(ccl::Scene* scene, ccl::Object* object, UpdateContext* update_context, XSI::siICEShapeType shape_type, size_t shader_index, const XSI::MATH::CColor4f &color, const std::vector<XSI::MATH::CTransformation> &point_tfms, XSI::X3DObject &xsi_pointcloud, const XSI::CTime &eval_time, bool unique_pass_id, const ccl::Object* template_object)
 {
-	XSI::CString lightgroup = "";
-	bool motion_deform = false;  // ignore this, primitives can move only as particles
 	XSI::CParameterRefArray render_parameters = update_context->get_current_render_parameters();
-	sync_geometry_object_parameters(scene, object, xsi_pointcloud, lightgroup, motion_deform, "CyclesPointcloud", render_parameters, eval_time);
-
-	update_context->add_lightgroup(lightgroup);
+	if (template_object == NULL)
+	{
+		XSI::CString lightgroup = "";
+		bool motion_deform = false;  // ignore this, primitives can move only as particles
+		sync_geometry_object_parameters(scene, object, xsi_pointcloud, lightgroup, motion_deform, "CyclesPointcloud", render_parameters, eval_time);
 
-	// get material shader index
-	XSI::Material xsi_material = xsi_pointcloud.GetMaterial();
-	ULONG xsi_material_id = xsi_material.GetObjectID();
-	size_t shader_index = 0;
-	if (update_context->is_material_exists(xsi_material_id))
+		update_context->add_lightgroup(lightgroup);
+	}
+	else
 	{
-		shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
+		// all shapes of the pointcloud have the same parameters, so does not read it from the property again
+		copy_point_object_parameters(scene, object, template_object, unique_pass_id);
 	}
-	ccl::array<ccl::Node*> used_shaders;
-	used_shaders.push_back_slow(scene->shaders[shader_index]);
 
 	ccl::Mesh* mesh = NULL;
 	if (update_context->is_primitive_shape_exists(shape_type, shader_index))
@@ -226,6 +292,9 @@ void sync_point_primitive_shape(ccl::Scene* scene, ccl::Object* object, UpdateCo
 	}
 	else
 	{
+		ccl::array<ccl::Node*> used_shaders;
+		used_shaders.push_back_slow(scene->shaders[shader_index]);
+
 		mesh = build_primitive(scene, shape_type);
 		mesh->set_used_shaders(used_shaders);
 		update_context->add_primitive_shape(shape_type, shader_index, scene->geometry.size() - 1);
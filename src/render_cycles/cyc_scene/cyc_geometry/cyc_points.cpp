@@ -15,9 +15,14 @@
 #include <xsi_kinematics.h>
 #include <xsi_kinematicstate.h>
 
+#include <vector>
+#include <algorithm>
+
 #include "../../update_context.h"
 #include "../../../utilities/xsi_properties.h"
 #include "cyc_geometry.h"
+#include "cyc_geometry_cache.h"
+#include "cyc_ice_attributes.h"
 #include "../cyc_scene.h"
 #include "../../../utilities/math.h"
 #include "../../../utilities/strings.h"
@@ -55,25 +60,43 @@ void sync_points_geom(ccl::Scene* scene, ccl::PointCloud* points_geom, UpdateCon
 
 	ULONG num_points = position_data.GetCount();
 	ULONG size_count = size_data.GetCount();
-	points_geom->reserve(num_points);
+	const std::vector<LONG> no_remap;
+
+	// allocate all points at once and then write directly into the arrays
+	points_geom->resize(num_points);
+	ccl::float3* points = points_geom->get_points().data();
+	float* radius = points_geom->get_radius().data();
+	int* shader = points_geom->get_shader().data();
+
+	gather_ice_attribute(position_data, points, num_points, no_remap);
+	if (size_count < num_points && !size_data.IsConstant())
+	{
+		// points without size are invisible
+		std::fill(radius, radius + num_points, 0.0f);
+	}
+	gather_ice_attribute(size_data, radius, num_points, no_remap);
+	std::fill(shader, shader + num_points, 0);
+
+	points_geom->tag_points_modified();
+	points_geom->tag_radius_modified();
+	points_geom->tag_shader_modified();
 
-	ccl::Attribute* attr_random = NULL;
 	if (points_geom->need_attribute(scene, ccl::ATTR_STD_POINT_RANDOM))
 	{
-		attr_random = points_geom->attributes.add(ccl::ATTR_STD_POINT_RANDOM);
+		ccl::Attribute* attr_random = points_geom->attributes.add(ccl::ATTR_STD_POINT_RANDOM);
+		float* random_data = attr_random->data_float();
+		for (size_t i = 0; i < num_points; i++)
+		{
+			random_data[i] = ccl::hash_uint2_to_float(i, 0);
+		}
 	}
 
-	out_original_positions.resize(num_points);
-	for (size_t i = 0; i < num_points; i++)
+	if (use_motion_blur)
 	{
-		XSI::MATH::CVector3f position = position_data[i];
-		float size = i < size_count ? size_data[i] : 0.0f;
-		ccl::float3 position_float3 = vector3_to_float3(position);
-		points_geom->add_point(position_float3, size);
-		out_original_positions[i] = ccl::make_float4(position_float3.x, position_float3.y, position_float3.z, size);
-		if (attr_random != NULL)
+		out_original_positions.resize(num_points);
+		for (size_t i = 0; i < num_points; i++)
 		{
-			attr_random->add(ccl::hash_uint2_to_float(i, 0));
+			out_original_positions[i] = ccl::make_float4(points[i].x, points[i].y, points[i].z, radius[i]);
 		}
 	}
 
@@ -102,69 +125,46 @@ void sync_points_geom(ccl::Scene* scene, ccl::PointCloud* points_geom, UpdateCon
 					XSI::CICEAttributeDataArrayFloat attr_data;
 					ice_attribute.GetDataArray(attr_data);
 					ccl::Attribute* attr = cycles_attributes.add(name, ccl::TypeFloat, element);
-					float* data = attr->data_float();
-					for (size_t v = 0; v < num_points; v++)
-					{
-						data[v] = attr_data[v];
-					}
+					gather_ice_attribute(attr_data, attr->data_float(), num_points, no_remap);
 				}
 				else if (attr_data_type == XSI::siICENodeDataBool)
 				{
 					XSI::CICEAttributeDataArrayBool attr_data;
 					ice_attribute.GetDataArray(attr_data);
 					ccl::Attribute* attr = cycles_attributes.add(name, ccl::TypeFloat, element);
-					float* data = attr->data_float();
-					for (size_t v = 0; v < num_points; v++)
-					{
-						data[v] = attr_data[v] ? 1.0 : 0.0;
-					}
+					gather_ice_attribute(attr_data, attr->data_float(), num_points, no_remap);
 				}
 				else if (attr_data_type == XSI::siICENodeDataLong)
 				{
 					XSI::CICEAttributeDataArrayLong attr_data;
 					ice_attribute.GetDataArray(attr_data);
 					ccl::Attribute* attr = cycles_attributes.add(name, ccl::TypeFloat, element);
-					float* data = attr->data_float();
-					for (size_t v = 0; v < num_points; v++)
-					{
-						data[v] = attr_data[v];
-					}
+					gather_ice_attribute(attr_data, attr->data_float(), num_points, no_remap);
 				}
 				else if (attr_data_type == XSI::siICENodeDataVector3)
 				{
 					XSI::CICEAttributeDataArrayVector3f attr_data;
 					ice_attribute.GetDataArray(attr_data);
 					ccl::Attribute* attr = cycles_attributes.add(name, ccl::TypeVector, element);
-					ccl::float3* data = attr->data_float3();
-					for (size_t v = 0; v < num_points; v++)
-					{
-						XSI::MATH::CVector3f vector = attr_data[v];
-						data[v] = ccl::make_float3(vector.GetX(), vector.GetY(), vector.GetZ());
-					}
+					gather_ice_attribute(attr_data, attr->data_float3(), num_points, no_remap);
 				}
 				else if (attr_data_type == XSI::siICENodeDataColor4)
 				{
 					XSI::CICEAttributeDataArrayColor4f attr_data;
 					ice_attribute.GetDataArray(attr_data);
 					ccl::Attribute* attr = cycles_attributes.add(name, ccl::TypeRGBA, element);
-					ccl::float4* data = attr->data_float4();
-					for (size_t v = 0; v < num_points; v++)
+					// point colors are in sRGB space
+					gather_ice_attribute(attr_data, attr->data_float4(), num_points, no_remap, [](const XSI::MATH::CColor4f& c)
 					{
-						XSI::MATH::CColor4f color = attr_data[v];
-						data[v] = ccl::make_float4(srgb_to_linear(color.GetR()), srgb_to_linear(color.GetG()), srgb_to_linear(color.GetB()), color.GetA());
-					}
+						return ccl::make_float4(srgb_to_linear(c.GetR()), srgb_to_linear(c.GetG()), srgb_to_linear(c.GetB()), c.GetA());
+					});
 				}
 				else if (attr_data_type == XSI::siICENodeDataVector2)
 				{
 					XSI::CICEAttributeDataArrayVector2f attr_data;
 					ice_attribute.GetDataArray(attr_data);
 					ccl::Attribute* attr = cycles_attributes.add(name, ccl::TypeFloat2, element);
-					ccl::float2* data = attr->data_float2();
-					for (size_t v = 0; v < num_points; v++)
-					{
-						XSI::MATH::CVector2f vector = attr_data[v];
-						data[v] = ccl::make_float2(vector.GetX(), vector.GetY());
-					}
+					gather_ice_attribute(attr_data, attr->data_float2(), num_points, no_remap);
 				}
 			}
 		}
@@ -207,11 +207,18 @@ void sync_points_deform(ccl::PointCloud* points_geom, UpdateContext* update_cont
 		// if at current time the number of points is greater than original, ignore it
 		// if the number of points is less, then fill other by center position
 		ULONG points_limit = std::min(original_points_count, time_points_count);
-		for (ULONG point_index = 0; point_index < points_limit; point_index++)
+		if (points_limit > 0)
 		{
-			XSI::MATH::CVector3f position = position_data[point_index];
-			float size = size_data[point_index];
-			motion_positions[attribute_index++] = ccl::make_float4(position.GetX(), position.GetY(), position.GetZ(), size);
+			// read directly from the data buffers, constant arrays contain only one value
+			const XSI::MATH::CVector3f* positions = &position_data[0];
+			const float* sizes = &size_data[0];
+			size_t position_step = position_data.IsConstant() ? 0 : 1;
+			size_t size_step = size_data.IsConstant() ? 0 : 1;
+			for (ULONG point_index = 0; point_index < points_limit; point_index++)
+			{
+				const XSI::MATH::CVector3f& position = positions[point_index * position_step];
+				motion_positions[attribute_index++] = ccl::make_float4(position.GetX(), position.GetY(), position.GetZ(), sizes[point_index * size_step]);
+			}
 		}
 
 		// next other points
@@ -222,6 +229,46 @@ void sync_points_deform(ccl::PointCloud* points_geom, UpdateContext* update_cont
 	}
 }
 
+uint64_t compute_points_hash(UpdateContext* update_context, const XSI::Primitive& xsi_primitive, XSI::X3DObject& xsi_object, bool use_motion_blur, const ccl::array<ccl::Node*>& used_shaders)
+{
+	XSI::CTime eval_time = update_context->get_time();
+
+	GeometryHash hash;
+	hash.add(combine_geometry_name(xsi_object, xsi_primitive));
+	hash.add(eval_time);
+	// positions and sizes are also ICE attributes
+	hash.add_ice_attributes(xsi_primitive.GetGeometry(eval_time));
+	hash.add_shaders_attributes(used_shaders);
+
+	hash.add(use_motion_blur ? 1 : 0);
+	if (use_motion_blur)
+	{
+		std::vector<double> motion_times = update_context->get_motion_times();
+		hash.add(motion_times);
+		hash.add((int)update_context->get_motion_position());
+		for (size_t i = 0; i < motion_times.size(); i++)
+		{
+			XSI::Geometry time_xsi_geometry = xsi_object.GetActivePrimitive(motion_times[i]).GetGeometry(motion_times[i]);
+			XSI::CICEAttributeDataArrayVector3f position_data;
+			time_xsi_geometry.GetICEAttributeFromName("PointPosition").GetDataArray(position_data);
+			XSI::CICEAttributeDataArrayFloat size_data;
+			time_xsi_geometry.GetICEAttributeFromName("Size").GetDataArray(size_data);
+			hash.add(position_data.GetCount());
+			hash.add(size_data.GetCount());
+			if (position_data.GetCount() > 0)
+			{
+				hash.add(&position_data[0], sizeof(XSI::MATH::CVector3f) * (position_data.IsConstant() ? 1 : position_data.GetCount()));
+			}
+			if (size_data.GetCount() > 0)
+			{
+				hash.add(&size_data[0], sizeof(float) * (size_data.IsConstant() ? 1 : size_data.GetCount()));
+			}
+		}
+	}
+
+	return hash.get_value();
+}
+
 void sync_points_geom_process(ccl::Scene* scene, ccl::PointCloud* points_geom, UpdateContext* update_context, const XSI::Primitive& xsi_primitive, XSI::X3DObject& xsi_object, bool motion_deform)
 {
 	points_geom->name = combine_geometry_name(xsi_object, xsi_primitive).GetAsciiString();
@@ -229,6 +276,17 @@ void sync_points_geom_process(ccl::Scene* scene, ccl::PointCloud* points_geom, U
 	ccl::vector<ccl::float4> original_positions;
 	bool use_motion_blur = update_context->get_need_motion() && motion_deform;
 
+	// try to reuse the pointcloud from the previous session
+	if (update_context->get_use_geometry_hash())
+	{
+		uint64_t points_hash = compute_points_hash(update_context, xsi_primitive, xsi_object, use_motion_blur, points_geom->get_used_shaders());
+		update_context->add_geometry_hash(xsi_primitive.GetObjectID(), points_hash);
+		if (update_context->restore_cached_geometry(xsi_primitive.GetObjectID(), points_hash, points_geom))
+		{
+			return;
+		}
+	}
+
 	sync_points_geom(scene, points_geom, update_context, xsi_primitive, use_motion_blur, original_positions);
 
 	if (use_motion_blur)
@@ -272,7 +330,7 @@ ccl::PointCloud* sync_points_object(ccl::Scene* scene, ccl::Object* object, Upda
 	XSI::Material xsi_material = xsi_object.GetMaterial();
 	ULONG xsi_material_id = xsi_material.GetObjectID();
 	size_t shader_index = 0;
-	if (update_context->is_material_exists(xsi_material_id))
+	if (sync_used_material(scene, update_context, xsi_material))
 	{
 		shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
 	}
@@ -25,6 +25,7 @@
 #include "cyc_geometry.h"
 #include "cyc_polymesh_attributes.h"
 #include "cyc_tangent_attribute.h"
+#include "cyc_geometry_cache.h"
 #include "../cyc_scene.h"
 #include "../../../utilities/xsi_properties.h"
 #include "../../../utilities/logs.h"
@@ -338,15 +339,17 @@ void sync_triangle_mesh(ccl::Scene* scene, ccl::Mesh* mesh, const XSI::CGeometry
 	std::memcpy(gen_attr->data_float3(), mesh->get_verts().data(), sizeof(ccl::float3) * mesh->get_verts().size());
 
 	// use common method for export attrbutes
-	XSI::CPolygonFaceRefArray faces;
-	sync_mesh_attribute_vertex_color(scene, mesh, attributes, xsi_geo_acc, SubdivideMode_None, triangle_nodes, faces);
-	sync_mesh_attribute_random_per_island(scene, mesh, attributes, SubdivideMode_None, nodes_count, triangles_count, triangle_nodes, xsi_polymesh, faces);
+	// face corners are used only for subdivided meshes
+	XSI::CLongArray polygon_sizes;
+	XSI::CLongArray face_nodes;
+	sync_mesh_attribute_vertex_color(scene, mesh, attributes, xsi_geo_acc, SubdivideMode_None, triangle_nodes, face_nodes);
+	sync_mesh_attribute_random_per_island(scene, mesh, attributes, SubdivideMode_None, nodes_count, triangles_count, triangle_nodes, xsi_polymesh, polygon_sizes, face_nodes);
 	sync_mesh_attribute_pointness(scene, mesh, SubdivideMode_None, vertex_count, nodes_count, xsi_vertices, node_normals, xsi_polymesh);
 	
 	// uvs
 	XSI::CRefArray uv_refs = xsi_geo_acc.GetUVs();
 	// export first uv as default uv attribute
-	sync_mesh_uvs(mesh, SubdivideMode_None, triangles_count, nodes_count, uv_refs, faces, triangle_nodes);
+	sync_mesh_uvs(mesh, SubdivideMode_None, triangles_count, nodes_count, uv_refs, face_nodes, triangle_nodes);
 	// export tangent for each uv
 	for (size_t i = 0; i < uv_refs.GetCount(); i++)
 	{
@@ -367,17 +370,17 @@ void sync_subdivide_mesh(ccl::Scene* scene, ccl::Mesh* mesh, const XSI::CGeometr
 	xsi_geo_acc.GetVertexPositions(vertex_positions);
 
 	XSI::CVertexRefArray xsi_vertices = xsi_polymesh.GetVertices();
-	XSI::CPolygonFaceRefArray xsi_faces = xsi_polymesh.GetPolygons();
 	XSI::CLongArray polygon_sizes;
 	xsi_geo_acc.GetPolygonVerticesCount(polygon_sizes);
+	// node index for each polygon corner (polygons are in the same order as in polygon_sizes)
+	// compute it once and use for face topology, uvs, vertex colors and other per-corner data
 	XSI::CLongArray node_indices;
+	xsi_geo_acc.GetNodeIndices(node_indices);
 	XSI::CFloatArray node_normals;  // define array here, but fill it later, if we need this
 	std::vector<LONG> xsi_node_to_vertex(nodes_count);
-	// we need node indices for linear subdivision
 	// in linear subdivision case case we should use each node as individual mesh vertex
 	if (subdiv_mode == SubdivideMode_Linear) {
-		xsi_geo_acc.GetNodeIndices(node_indices);
-		// we also need the map from node index to vertex index
+		// we need the map from node index to vertex index
 		// because we obtain from geometry vertex positiosn, but required node positions
 		for (LONG i = 0; i < vertex_count; i++)
 		{
@@ -419,19 +422,20 @@ void sync_subdivide_mesh(ccl::Scene* scene, ccl::Mesh* mesh, const XSI::CGeometr
 		}
 
 		// assign mesh faces
+		// vertex index for each polygon corner, in the same order as node_indices
+		XSI::CLongArray vertex_indices;
+		xsi_geo_acc.GetVertexIndices(vertex_indices);
 		ccl::vector<int> vi;
-		size_t faces_count = xsi_faces.GetCount();
-		for (size_t face_index = 0; face_index < faces_count; face_index++)
+		LONG corner_offset = 0;
+		for (size_t face_index = 0; face_index < polygons_count; face_index++)
 		{
-			XSI::PolygonFace face(xsi_faces[face_index]);
-			XSI::CVertexRefArray face_vertices = face.GetVertices();
-			size_t face_vertex_count = face_vertices.GetCount();
+			LONG face_vertex_count = polygon_sizes[face_index];
 			vi.resize(face_vertex_count);
-			for (size_t v = 0; v < face_vertex_count; v++)
+			for (LONG v = 0; v < face_vertex_count; v++)
 			{
-				XSI::Vertex vert(face_vertices[v]);
-				vi[v] = vert.GetIndex();
+				vi[v] = vertex_indices[corner_offset + v];
 			}
+			corner_offset += face_vertex_count;
 			mesh->add_subd_face(&vi[0], face_vertex_count, xsi_polygon_material_indices[face_index], true);
 		}
 	} 
@@ -449,6 +453,7 @@ void sync_subdivide_mesh(ccl::Scene* scene, ccl::Mesh* mesh, const XSI::CGeometr
 		LONG node_iterator = 0;
 		for (LONG i = 0; i < polygons_count; i++) {
 			LONG poly_size = polygon_sizes[i];
+			face_corners.clear();
 			for (LONG j = 0; j < poly_size; j++) {
 				LONG node_index = node_indices[node_iterator];
 				// define node normal
@@ -459,7 +464,6 @@ void sync_subdivide_mesh(ccl::Scene* scene, ccl::Mesh* mesh, const XSI::CGeometr
 
 				node_iterator++;
 			}
-			face_corners.clear();
 
 			// add face to the mesh
 			mesh->add_subd_face(&face_corners[0], poly_size, xsi_polygon_material_indices[i], false);
@@ -538,14 +542,14 @@ void sync_subdivide_mesh(ccl::Scene* scene, ccl::Mesh* mesh, const XSI::CGeometr
 	
 	XSI::CLongArray triangle_nodes;  // these arrays does not actualy used for subdivided mesh
 	LONG triangles_count = xsi_geo_acc.GetTriangleCount();
-	sync_mesh_attribute_vertex_color(scene, mesh, attributes, xsi_geo_acc, subdiv_mode, triangle_nodes, xsi_faces);
-	sync_mesh_attribute_random_per_island(scene, mesh, attributes, subdiv_mode, nodes_count, triangles_count, triangle_nodes, xsi_polymesh, xsi_faces);
+	sync_mesh_attribute_vertex_color(scene, mesh, attributes, xsi_geo_acc, subdiv_mode, triangle_nodes, node_indices);
+	sync_mesh_attribute_random_per_island(scene, mesh, attributes, subdiv_mode, nodes_count, triangles_count, triangle_nodes, xsi_polymesh, polygon_sizes, node_indices);
 	sync_mesh_attribute_pointness(scene, mesh, subdiv_mode, vertex_count, nodes_count, xsi_vertices, node_normals, xsi_polymesh);
 
 	// uvs
 	XSI::CRefArray uv_refs = xsi_geo_acc.GetUVs();
 	// export first uv as default uv attribute
-	sync_mesh_uvs(mesh, subdiv_mode, triangles_count, nodes_count, uv_refs, xsi_faces, triangle_nodes);
+	sync_mesh_uvs(mesh, subdiv_mode, triangles_count, nodes_count, uv_refs, node_indices, triangle_nodes);
 	// export tangent for each uv
 	for (size_t i = 0; i < uv_refs.GetCount(); i++)
 	{
@@ -594,6 +598,89 @@ void sync_mesh_subdiv_property(XSI::X3DObject& xsi_object, int &io_level, Subdiv
 	}
 }
 
+// hash all the data, used for export non-subdivided mesh
+// it used for geometry cache, so, should contains everything, which can change the output mesh
+uint64_t compute_triangle_mesh_hash(UpdateContext* update_context, const XSI::X3DObject& xsi_object, const XSI::CGeometryAccessor& xsi_geo_acc, const XSI::PolygonMesh& xsi_polymesh, const ccl::array<ccl::Node*>& used_shaders, bool motion_deform, bool geo_use_angle, float geo_angle, const XSI::CTime& eval_time)
+{
+	GeometryHash hash;
+	hash.add(combine_geometry_name(xsi_object, xsi_polymesh));
+	hash.add(eval_time);
+	hash.add(geo_use_angle ? 1 : 0);
+	hash.add(geo_angle);
+
+	XSI::CDoubleArray vertex_positions;
+	xsi_geo_acc.GetVertexPositions(vertex_positions);
+	hash.add(vertex_positions);
+
+	XSI::CLongArray polygon_sizes;
+	xsi_geo_acc.GetPolygonVerticesCount(polygon_sizes);
+	hash.add(polygon_sizes);
+
+	XSI::CLongArray vertex_indices;
+	xsi_geo_acc.GetVertexIndices(vertex_indices);
+	hash.add(vertex_indices);
+
+	XSI::CLongArray node_indices;
+	xsi_geo_acc.GetNodeIndices(node_indices);
+	hash.add(node_indices);
+
+	XSI::CLongArray polygon_materials;
+	xsi_geo_acc.GetPolygonMaterialIndices(polygon_materials);
+	hash.add(polygon_materials);
+
+	XSI::CFloatArray node_normals;
+	get_geo_accessor_normals(xsi_geo_acc, xsi_geo_acc.GetNodeCount(), node_normals);
+	hash.add(node_normals);
+
+	XSI::CRefArray uv_refs = xsi_geo_acc.GetUVs();
+	for (LONG i = 0; i < uv_refs.GetCount(); i++)
+	{
+		XSI::ClusterProperty uv_prop(uv_refs[i]);
+		XSI::CFloatArray uv_values;
+		uv_prop.GetValues(uv_values);
+		hash.add(uv_prop.GetName());
+		hash.add(uv_values);
+	}
+
+	XSI::CRefArray color_refs = xsi_geo_acc.GetVertexColors();
+	for (LONG i = 0; i < color_refs.GetCount(); i++)
+	{
+		XSI::ClusterProperty color_prop(color_refs[i]);
+		XSI::CFloatArray color_values;
+		color_prop.GetValues(color_values);
+		hash.add(color_prop.GetName());
+		hash.add(color_values);
+	}
+
+	hash.add_ice_attributes(xsi_polymesh);
+	hash.add_shaders_attributes(used_shaders);
+
+	// deformation at all motion steps
+	bool use_motion = update_context->get_need_motion() && motion_deform;
+	hash.add(use_motion ? 1 : 0);
+	if (use_motion)
+	{
+		std::vector<double> motion_times = update_context->get_motion_times();
+		hash.add(motion_times);
+		hash.add((int)update_context->get_motion_position());
+		for (size_t i = 0; i < motion_times.size(); i++)
+		{
+			double time = motion_times[i];
+			XSI::PolygonMesh xsi_time_mesh = xsi_object.GetActivePrimitive(time).GetGeometry(time, XSI::siConstructionModeSecondaryShape);
+			XSI::CGeometryAccessor xsi_time_acc = xsi_time_mesh.GetGeometryAccessor(XSI::siConstructionModeSecondaryShape, XSI::siCatmullClark, 0, false, geo_use_angle, geo_angle);
+			XSI::CDoubleArray time_positions;
+			xsi_time_acc.GetVertexPositions(time_positions);
+			hash.add(time_positions);
+
+			XSI::CFloatArray time_normals;
+			get_geo_accessor_normals(xsi_time_acc, xsi_time_acc.GetNodeCount(), time_normals);
+			hash.add(time_normals);
+		}
+	}
+
+	return hash.get_value();
+}
+
 void sync_polymesh_process(ccl::Scene* scene, ccl::Mesh* mesh_geom, UpdateContext* update_context, XSI::X3DObject &xsi_object, const XSI::Primitive &xsi_primitive, bool motion_deform, const XSI::CTime &eval_time)
 {
 	// geometry is new, create it
@@ -624,7 +711,7 @@ void sync_polymesh_process(ccl::Scene* scene, ccl::Mesh* mesh_geom, UpdateContex
 		XSI::Material xsi_material = xsi_geo_materials[i];
 		ULONG xsi_material_id = xsi_material.GetObjectID();
 		size_t shader_index = 0;
-		if (update_context->is_material_exists(xsi_material_id))
+		if (sync_used_material(scene, update_context, xsi_material))
 		{
 			shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
 		}
@@ -644,6 +731,17 @@ void sync_polymesh_process(ccl::Scene* scene, ccl::Mesh* mesh_geom, UpdateContex
 
 	if (subdiv_mode == SubdivideMode_None)
 	{// non subdivided mesh
+		// try to reuse the mesh from the previous session
+		if (update_context->get_use_geometry_hash())
+		{
+			uint64_t mesh_hash = compute_triangle_mesh_hash(update_context, xsi_object, xsi_geo_acc, xsi_polymesh, used_shaders, motion_deform, geo_use_angle, geo_angle, eval_time);
+			update_context->add_geometry_hash(xsi_primitive.GetObjectID(), mesh_hash);
+			if (update_context->restore_cached_geometry(xsi_primitive.GetObjectID(), mesh_hash, mesh_geom))
+			{
+				return;
+			}
+		}
+
 		// so, we should create triangles
 		sync_triangle_mesh(scene, mesh_geom, xsi_geo_acc, xsi_polymesh);
 	}
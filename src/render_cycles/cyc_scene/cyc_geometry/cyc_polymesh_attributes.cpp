@@ -16,10 +16,11 @@
 #include <xsi_iceattributedataarray.h>
 #include <xsi_iceattributedataarray2D.h>
 
+#include "cyc_ice_attributes.h"
 #include "../../../utilities/math.h"
 #include "../../../utilities/logs.h"
 
-void sync_mesh_attribute_vertex_color(ccl::Scene* scene, ccl::Mesh* mesh, ccl::AttributeSet& attributes, const XSI::CGeometryAccessor& xsi_geo_acc, SubdivideMode subdiv_mode, const XSI::CLongArray& triangle_nodes, const XSI::CPolygonFaceRefArray& faces)
+void sync_mesh_attribute_vertex_color(ccl::Scene* scene, ccl::Mesh* mesh, ccl::AttributeSet& attributes, const XSI::CGeometryAccessor& xsi_geo_acc, SubdivideMode subdiv_mode, const XSI::CLongArray& triangle_nodes, const XSI::CLongArray& face_nodes)
 {
 	XSI::CRefArray vertex_colors_array = xsi_geo_acc.GetVertexColors();
 	size_t vertex_colors_array_count = vertex_colors_array.GetCount();
@@ -54,26 +55,19 @@ void sync_mesh_attribute_vertex_color(ccl::Scene* scene, ccl::Mesh* mesh, ccl::A
 			}
 			else
 			{
-				size_t faces_count = faces.GetCount();
-				for (size_t face_index = 0; face_index < faces_count; face_index++)
+				// face_nodes contains node index for each polygon corner
+				size_t corners_count = face_nodes.GetCount();
+				for (size_t corner_index = 0; corner_index < corners_count; corner_index++)
 				{
-					XSI::PolygonFace face(faces[face_index]);
-					XSI::CPolygonNodeRefArray face_nodes = face.GetNodes();
-					size_t face_nodes_count = face_nodes.GetCount();
-					for (size_t node_index = 0; node_index < face_nodes_count; node_index++)
-					{
-						XSI::PolygonNode node(face_nodes[node_index]);
-						size_t n = node.GetIndex();
-						cdata[0] = ccl::color_float4_to_uchar4(ccl::make_float4(values[4 * n], values[4 * n + 1], values[4 * n + 2], values[4 * n + 3]));
-						cdata++;
-					}
+					size_t n = face_nodes[corner_index];
+					cdata[corner_index] = ccl::color_float4_to_uchar4(ccl::make_float4(values[4 * n], values[4 * n + 1], values[4 * n + 2], values[4 * n + 3]));
 				}
 			}
 		}
 	}
 }
 
-void sync_mesh_attribute_random_per_island(ccl::Scene* scene, ccl::Mesh* mesh, ccl::AttributeSet& attributes, SubdivideMode subdiv_mode, size_t nodes_count, size_t triangles_count, const XSI::CLongArray& triangle_nodes, const XSI::PolygonMesh& xsi_polymesh, const XSI::CPolygonFaceRefArray& faces)
+void sync_mesh_attribute_random_per_island(ccl::Scene* scene, ccl::Mesh* mesh, ccl::AttributeSet& attributes, SubdivideMode subdiv_mode, size_t nodes_count, size_t triangles_count, const XSI::CLongArray& triangle_nodes, const XSI::PolygonMesh& xsi_polymesh, const XSI::CLongArray& polygon_sizes, const XSI::CLongArray& face_nodes)
 {
 	if (mesh->need_attribute(scene, ccl::ATTR_STD_RANDOM_PER_ISLAND))
 	{
@@ -99,14 +93,13 @@ void sync_mesh_attribute_random_per_island(ccl::Scene* scene, ccl::Mesh* mesh, c
 		// fill attribute for every triangle
 		if (subdiv_mode != SubdivideMode_None)
 		{// for subdivided mesh
-			size_t face_count = faces.GetCount();
+			size_t face_count = polygon_sizes.GetCount();
+			size_t corner_offset = 0;
 			for (size_t face_index = 0; face_index < face_count; face_index++)
 			{
-				XSI::PolygonFace face(faces[face_index]);
-				XSI::CPolygonNodeRefArray face_nodes = face.GetNodes();
-				XSI::PolygonNode node(face_nodes[0]);
-				float value = ccl::hash_uint_to_float(vertices_sets.find(node.GetIndex()));
+				float value = ccl::hash_uint_to_float(vertices_sets.find(face_nodes[corner_offset]));
 				island_data[face_index] = value;
+				corner_offset += polygon_sizes[face_index];
 			}
 		}
 		else
@@ -398,7 +391,7 @@ void sync_mesh_attribute_pointness(ccl::Scene* scene, ccl::Mesh* mesh, Subdivide
 	}
 }
 
-void sync_mesh_uvs(ccl::Mesh* mesh, SubdivideMode subdiv_mode, size_t triangles_count, size_t nodes_count, const XSI::CRefArray &uv_refs, const XSI::CPolygonFaceRefArray& faces, const XSI::CLongArray& triangle_nodes)
+void sync_mesh_uvs(ccl::Mesh* mesh, SubdivideMode subdiv_mode, size_t triangles_count, size_t nodes_count, const XSI::CRefArray &uv_refs, const XSI::CLongArray& face_nodes, const XSI::CLongArray& triangle_nodes)
 {
 	// in non-subdivide mesh we use tyriangles
 	// for any subdivided mesh we use polygons
@@ -441,26 +434,17 @@ void sync_mesh_uvs(ccl::Mesh* mesh, SubdivideMode subdiv_mode, size_t triangles_
 
 		ccl::float2* uv_attribute_data = uv_attribute->data_float2();
 		if (subdiv_mode != SubdivideMode_None)
-		{// use polygons and nodes
-			size_t faces_count = faces.GetCount();
-			for (size_t face_index = 0; face_index < faces_count; face_index++)
+		{// use polygon corners, face_nodes already contains node index for each corner
+			size_t corners_count = face_nodes.GetCount();
+			for (size_t corner_index = 0; corner_index < corners_count; corner_index++)
 			{
-				XSI::PolygonFace face(faces[face_index]);
-				XSI::CPolygonNodeRefArray face_nodes = face.GetNodes();
-				size_t face_nodes_count = face_nodes.GetCount();
-				for (size_t node_index = 0; node_index < face_nodes_count; node_index++)
-				{
-					XSI::PolygonNode node(face_nodes[node_index]);
-					ccl::float2 uv_value = ccl::make_float2(uv_values[node.GetIndex() * 3], uv_values[node.GetIndex() * 3 + 1]);
-					uv_attribute_data[0] = ccl::make_float2(uv_value.x, uv_value.y);
-					uv_attribute_data++;
+				size_t n = face_nodes[corner_index];
+				uv_attribute_data[corner_index] = ccl::make_float2(uv_values[n * 3], uv_values[n * 3 + 1]);
+			}
 
-					if (uv_index == 0)
-					{
-						default_uv[0] = ccl::make_float2(uv_value.x, uv_value.y);
-						default_uv++;
-					}
-				}
+			if (uv_index == 0)
+			{
+				std::memcpy(default_uv, uv_attribute_data, sizeof(ccl::float2) * corners_count);
 			}
 		}
 		else
@@ -514,156 +498,60 @@ void sync_ice_attributes(ccl::Scene* scene, ccl::Mesh* mesh, const XSI::Geometry
 
 			if ((attr_context == XSI::siICENodeContextComponent0D || attr_context == XSI::siICENodeContextSingleton) && attr_structure == XSI::siICENodeStructureSingle)
 			{
-				bool is_array = attr_context == XSI::siICENodeContextComponent0D;
+				// for Catmull-Clark subdivision mesh vertices are the same as geometry vertices, so we can copy data as is
+				// in other cases each mesh vertex is a node, and the value should be taken from the corresponding vertex
+				bool is_nodes = subdiv_mode != SubdivideMode_CatmulClark;
+				size_t output_count = is_nodes ? nodes_count : vertex_count;
+				const std::vector<LONG> no_remap;
+				const std::vector<LONG>& remap = is_nodes ? nodes_to_vertex : no_remap;
+				ccl::AttributeSet& attributes = (subdiv_mode != SubdivideMode_None) ? mesh->subd_attributes : mesh->attributes;
+
 				if (attr_data_type == XSI::siICENodeDataVector3)
 				{
 					XSI::CICEAttributeDataArrayVector3f attr_data;
 					xsi_attribute.GetDataArray(attr_data);
 
-					ccl::Attribute* cycles_attribute = (subdiv_mode != SubdivideMode_None) ? mesh->subd_attributes.add(attr_name, ccl::TypeVector, ccl::ATTR_ELEMENT_VERTEX) : mesh->attributes.add(attr_name, ccl::TypeVector, ccl::ATTR_ELEMENT_VERTEX);
-
-					ccl::float3* cyc_attr_data = cycles_attribute->data_float3();
-					if (subdiv_mode != SubdivideMode_CatmulClark)
-					{
-						for (size_t node_index = 0; node_index < nodes_count; node_index++)
-						{
-							*cyc_attr_data = vector3_to_float3(attr_data[is_array ? nodes_to_vertex[node_index] : 0]);
-							cyc_attr_data++;
-						}
-					}
-					else
-					{
-						for (size_t v_index = 0; v_index < vertex_count; v_index++)
-						{
-							*cyc_attr_data = vector3_to_float3(attr_data[is_array ? v_index : 0]);
-							cyc_attr_data++;
-						}
-					}
+					ccl::Attribute* cycles_attribute = attributes.add(attr_name, ccl::TypeVector, ccl::ATTR_ELEMENT_VERTEX);
+					gather_ice_attribute(attr_data, cycles_attribute->data_float3(), output_count, remap);
 				}
 				else if (attr_data_type == XSI::siICENodeDataVector2)
 				{
 					XSI::CICEAttributeDataArrayVector2f attr_data;
 					xsi_attribute.GetDataArray(attr_data);
-					
-					ccl::Attribute* cycles_attribute = (subdiv_mode != SubdivideMode_None) ? mesh->subd_attributes.add(attr_name, ccl::TypeFloat2, ccl::ATTR_ELEMENT_VERTEX) : mesh->attributes.add(attr_name, ccl::TypeFloat2, ccl::ATTR_ELEMENT_VERTEX);
-
-					ccl::float2* cyc_attr_data = cycles_attribute->data_float2();
 
-					if (subdiv_mode != SubdivideMode_CatmulClark)
-					{
-						for (size_t node_index = 0; node_index < nodes_count; node_index++)
-						{
-							*cyc_attr_data = vector2_to_float2(attr_data[is_array ? nodes_to_vertex[node_index] : 0]);
-							cyc_attr_data++;
-						}
-					}
-					else
-					{
-						for (size_t v_index = 0; v_index < vertex_count; v_index++)
-						{
-							*cyc_attr_data = vector2_to_float2(attr_data[is_array ? v_index : 0]);
-							cyc_attr_data++;
-						}
-					}
+					ccl::Attribute* cycles_attribute = attributes.add(attr_name, ccl::TypeFloat2, ccl::ATTR_ELEMENT_VERTEX);
+					gather_ice_attribute(attr_data, cycles_attribute->data_float2(), output_count, remap);
 				}
 				else if (attr_data_type == XSI::siICENodeDataColor4)
 				{
 					XSI::CICEAttributeDataArrayColor4f attr_data;
 					xsi_attribute.GetDataArray(attr_data);
 
-					ccl::Attribute* cycles_attribute = (subdiv_mode != SubdivideMode_None) ? mesh->subd_attributes.add(attr_name, ccl::TypeColor, ccl::ATTR_ELEMENT_VERTEX) : mesh->attributes.add(attr_name, ccl::TypeColor, ccl::ATTR_ELEMENT_VERTEX);
-
-					ccl::float4* cyc_attr_data = cycles_attribute->data_float4();
-
-					if (subdiv_mode != SubdivideMode_CatmulClark)
-					{
-						for (size_t node_index = 0; node_index < nodes_count; node_index++)
-						{
-							*cyc_attr_data = color4_to_float4(attr_data[is_array ? nodes_to_vertex[node_index] : 0]);
-							cyc_attr_data++;
-						}
-					}
-					else
-					{
-						for (size_t v_index = 0; v_index < vertex_count; v_index++)
-						{
-							*cyc_attr_data = color4_to_float4(attr_data[is_array ? v_index : 0]);
-							cyc_attr_data++;
-						}
-					}
+					ccl::Attribute* cycles_attribute = attributes.add(attr_name, ccl::TypeColor, ccl::ATTR_ELEMENT_VERTEX);
+					gather_ice_attribute(attr_data, cycles_attribute->data_float4(), output_count, remap);
 				}
 				else if (attr_data_type == XSI::siICENodeDataBool || attr_data_type == XSI::siICENodeDataFloat || attr_data_type == XSI::siICENodeDataLong)
 				{
-					ccl::Attribute* cycles_attribute = (subdiv_mode != SubdivideMode_None) ? mesh->subd_attributes.add(attr_name, ccl::TypeFloat, ccl::ATTR_ELEMENT_VERTEX) : mesh->attributes.add(attr_name, ccl::TypeFloat, ccl::ATTR_ELEMENT_VERTEX);
-
+					ccl::Attribute* cycles_attribute = attributes.add(attr_name, ccl::TypeFloat, ccl::ATTR_ELEMENT_VERTEX);
 					float* cyc_attr_data = cycles_attribute->data_float();
 
 					if (attr_data_type == XSI::siICENodeDataBool)
 					{
 						XSI::CICEAttributeDataArrayBool attr_data;
 						xsi_attribute.GetDataArray(attr_data);
-
-						if (subdiv_mode != SubdivideMode_CatmulClark)
-						{
-							for (size_t node_index = 0; node_index < nodes_count; node_index++)
-							{
-								*cyc_attr_data = attr_data[is_array ? nodes_to_vertex[node_index] : 0] ? 1.0f : 0.0f;
-								cyc_attr_data++;
-							}
-						}
-						else
-						{
-							for (size_t v_index = 0; v_index < vertex_count; v_index++)
-							{
-								*cyc_attr_data = attr_data[is_array ? v_index : 0] ? 1.0f : 0.0f;
-								cyc_attr_data++;
-							}
-						}
-
+						gather_ice_attribute(attr_data, cyc_attr_data, output_count, remap);
 					}
 					else if (attr_data_type == XSI::siICENodeDataFloat)
 					{
 						XSI::CICEAttributeDataArrayFloat attr_data;
 						xsi_attribute.GetDataArray(attr_data);
-
-						if (subdiv_mode != SubdivideMode_CatmulClark)
-						{
-							for (size_t node_index = 0; node_index < nodes_count; node_index++)
-							{
-								*cyc_attr_data = attr_data[is_array ? nodes_to_vertex[node_index] : 0];
-								cyc_attr_data++;
-							}
-						}
-						else
-						{
-							for (size_t v_index = 0; v_index < vertex_count; v_index++)
-							{
-								*cyc_attr_data = attr_data[is_array ? v_index : 0];
-								cyc_attr_data++;
-							}
-						}
+						gather_ice_attribute(attr_data, cyc_attr_data, output_count, remap);
 					}
 					else if (attr_data_type == XSI::siICENodeDataLong)
 					{
 						XSI::CICEAttributeDataArrayLong attr_data;
 						xsi_attribute.GetDataArray(attr_data);
-
-						if (subdiv_mode != SubdivideMode_CatmulClark)
-						{
-							for (size_t node_index = 0; node_index < nodes_count; node_index++)
-							{
-								*cyc_attr_data = (float)attr_data[is_array ? nodes_to_vertex[node_index] : 0];
-								cyc_attr_data++;
-							}
-						}
-						else
-						{
-							for (size_t v_index = 0; v_index < vertex_count; v_index++)
-							{
-								*cyc_attr_data = (float)attr_data[is_array ? v_index : 0];
-								cyc_attr_data++;
-							}
-						}
+						gather_ice_attribute(attr_data, cyc_attr_data, output_count, remap);
 					}
 				}
 			}
@@ -2,6 +2,7 @@
 #include "scene/hair.h"
 #include "scene/object.h"
 #include "util/hash.h"
+#include "util/tbb.h"
 
 #include <xsi_x3dobject.h>
 #include <xsi_geometry.h>
@@ -13,8 +14,12 @@
 #include <xsi_kinematics.h>
 #include <xsi_kinematicstate.h>
 
+#include <vector>
+#include <algorithm>
+
 #include "../../update_context.h"
 #include "cyc_geometry.h"
+#include "cyc_ice_attributes.h"
 #include "../cyc_scene.h"
 #include "../../../utilities/math.h"
 #include "../../../utilities/logs.h"
@@ -40,12 +45,18 @@ bool is_pointcloud_strands(const XSI::X3DObject& xsi_object)
 	}
 }
 
-float calculate_strand_radius(const ULONG point_index,  // the index of the point in the pointcloud
-	const XSI::CICEAttributeDataArrayFloat &point_size,  // array of point radiuses
-	const ULONG point_size_length,  // the size of the array with point radiuses
+// radius of the strand root, it defined by the point size
+// if points size aray is empty, use zero value
+// if the point index outside of the array, use the last value of the array
+float get_strand_point_radius(const XSI::CICEAttributeDataArrayFloat& point_size, ULONG point_size_length, ULONG point_index)
+{
+	return point_size_length > 0 ? point_size[point_index < point_size_length ? point_index : point_size_length - 1] : 0.0;
+}
+
+float calculate_strand_radius(float point_radius,  // radius of the point in the pointcloud, used if there are no strand sizes
 	const ULONG strand_index,  // index of the strand knot in the current point, for initial point it equals to 0, for last knot it equals to strand_positions_count
 	const ULONG strand_length,  // the length of the strand (the number of knots with the start one), so, for strand *---*---*, where the first * is point, strand_length = 3 (and strand_positions_count = 2)
-	const XSI::CICEAttributeDataArrayFloat &strand_size,  // array of size values for a given strand
+	const float* strand_size,  // array of size values for a given strand
 	const ULONG strand_size_length  // the number of elements of the size array for strand (it can be different from strand_length)
 )
 {
@@ -53,10 +64,7 @@ float calculate_strand_radius(const ULONG point_index,  // the index of the poin
 	// laso return point radius in the case when the strand has zero knots (strand_length = konts count + 1)
 	if (strand_size_length == 0 || strand_length <= 1)
 	{
-		// return either 0.0 (if the array with sizes is empty)
-		// or last value of the array (if point index greater the the length)
-		// or actual value in the array
-		return point_size_length > 0 ? point_size[point_index < point_size_length ? point_index : point_size_length - 1] : 0.0;
+		return point_radius;
 	}
 
 	// if there is only one value in strand sizes, then return it
@@ -82,6 +90,47 @@ float calculate_strand_radius(const ULONG point_index,  // the index of the poin
 	return (1.0f - c) * strand_size[interval_index] + c * strand_size[interval_index + 1];
 }
 
+// location of one strand data in plain buffers
+// ICE sub arrays are copied into these buffers, because the data of a sub array is valid only until the next GetSubArray call
+struct IceStrandSpan
+{
+	size_t knots_start;
+	ULONG knots_count;
+	size_t sizes_start;
+	ULONG sizes_count;
+	XSI::MATH::CVector3f point_position;
+	float point_radius;
+};
+
+// write keys of the strand: at first the point position, then all strand knots
+// return the length of the strand (without the segment from the point to the first knot)
+float write_strand_keys(const IceStrandSpan& span, const std::vector<XSI::MATH::CVector3f>& knots, const std::vector<float>& sizes, ccl::float4* out_keys)
+{
+	ULONG strand_length = span.knots_count + 1;
+	const XSI::MATH::CVector3f* span_knots = knots.data() + span.knots_start;
+	const float* span_sizes = span.sizes_count > 0 ? sizes.data() + span.sizes_start : NULL;
+	const XSI::MATH::CVector3f& p = span.point_position;
+	out_keys[0] = ccl::make_float4(p.GetX(), p.GetY(), p.GetZ(), calculate_strand_radius(span.point_radius, 0, strand_length, span_sizes, span.sizes_count));
+
+	float strand_sparse_length = 0.0f;
+	for (ULONG k_index = 0; k_index < span.knots_count; k_index++)
+	{
+		const XSI::MATH::CVector3f& knot_position = span_knots[k_index];
+		float radius = calculate_strand_radius(span.point_radius, k_index + 1, strand_length, span_sizes, span.sizes_count);
+		out_keys[k_index + 1] = ccl::make_float4(knot_position.GetX(), knot_position.GetY(), knot_position.GetZ(), radius);
+		if (k_index > 0)
+		{
+			const XSI::MATH::CVector3f& prev_knot_position = span_knots[k_index - 1];
+			float dx = knot_position.GetX() - prev_knot_position.GetX();
+			float dy = knot_position.GetY() - prev_knot_position.GetY();
+			float dz = knot_position.GetZ() - prev_knot_position.GetZ();
+			strand_sparse_length += sqrtf(dx * dx + dy * dy + dz * dz);
+		}
+	}
+
+	return strand_sparse_length;
+}
+
 void sync_strands_geom(ccl::Scene* scene, 
 	ccl::Hair* strands_geom,
 	UpdateContext* update_context, 
@@ -130,147 +179,132 @@ void sync_strands_geom(ccl::Scene* scene,
 
 	XSI::CICEAttributeDataArrayVector3f one_strand_data;
 
-	// at first we should reserve the curves in the geometry
-	// so, iterate throw points and calculate indices of non-trivail strands
+	// read each strand only once and copy its data into plain buffers
+	// calculate indices of non-trivail strands and total number of keys
 	ULONG total_keys = 0;
-	ULONG total_curves = 0;
 	ULONG points_count = point_position_data.GetCount();
+	std::vector<IceStrandSpan> spans;
+	std::vector<XSI::MATH::CVector3f> strands_knots;
+	std::vector<float> strands_sizes;
+	spans.reserve(points_count);
 	for (size_t i = 0; i < points_count; i++)
 	{
-		// get the current strand length data
 		strand_position_data.GetSubArray(i, one_strand_data);
 		ULONG strand_length = one_strand_data.GetCount();
 		if (strand_length > 0)
 		{
+			IceStrandSpan span;
+			span.knots_start = strands_knots.size();
+			span.knots_count = strand_length;
+			for (ULONG k = 0; k < strand_length; k++)
+			{
+				strands_knots.push_back(one_strand_data[k]);
+			}
+			span.sizes_start = strands_sizes.size();
+			span.sizes_count = 0;
+			if (use_strand_size)
+			{
+				strand_size_data.GetSubArray(i, one_strand_size_data);
+				span.sizes_count = one_strand_size_data.GetCount();
+				for (ULONG k = 0; k < span.sizes_count; k++)
+				{
+					strands_sizes.push_back(one_strand_size_data[k]);
+				}
+			}
+			span.point_position = point_position_data[i];
+			span.point_radius = get_strand_point_radius(size_data, size_data_length, i);
+			spans.push_back(span);
+
 			out_strand_points.push_back(i);
 			out_strand_lengths.push_back(strand_length);
 
 			total_keys += strand_length + 1;  // because each strand does not contains start point (point position)
-			total_curves += 1;
 		}
 	}
+	ULONG total_curves = spans.size();
 
-	strands_geom->reserve_curves(total_curves, total_keys);
-	ccl::Attribute* attr_intercept = NULL;
-	ccl::Attribute* attr_random = NULL;
-	ccl::Attribute* attr_length = NULL;
+	// index of the first key for each curve
+	std::vector<ULONG> first_keys(total_curves);
+	ULONG first_key = 0;
+	for (size_t curve_index = 0; curve_index < total_curves; curve_index++)
+	{
+		first_keys[curve_index] = first_key;
+		first_key += spans[curve_index].knots_count + 1;
+	}
+
+	// allocate all curves at once and fill it in parallel
+	strands_geom->resize_curves(total_curves, total_keys);
+	ccl::float3* curve_keys = strands_geom->get_curve_keys().data();
+	float* curve_radius = strands_geom->get_curve_radius().data();
+	int* curve_first_key = strands_geom->get_curve_first_key().data();
+	int* curve_shader = strands_geom->get_curve_shader().data();
+
+	float* intercept_data = NULL;
+	float* random_data = NULL;
+	float* length_data = NULL;
 	if (strands_geom->need_attribute(scene, ccl::ATTR_STD_CURVE_INTERCEPT))
 	{
-		attr_intercept = strands_geom->attributes.add(ccl::ATTR_STD_CURVE_INTERCEPT);
+		intercept_data = strands_geom->attributes.add(ccl::ATTR_STD_CURVE_INTERCEPT)->data_float();
 	}
 	if (strands_geom->need_attribute(scene, ccl::ATTR_STD_CURVE_RANDOM))
 	{
-		attr_random = strands_geom->attributes.add(ccl::ATTR_STD_CURVE_RANDOM);
+		random_data = strands_geom->attributes.add(ccl::ATTR_STD_CURVE_RANDOM)->data_float();
 	}
 	if (strands_geom->need_attribute(scene, ccl::ATTR_STD_CURVE_LENGTH))
 	{
-		attr_length = strands_geom->attributes.add(ccl::ATTR_STD_CURVE_LENGTH);
-	}
-	ULONG original_index = 0;
-	
-	if (use_motion_blur)
-	{
-		out_original_positions.resize(total_keys);
+		length_data = strands_geom->attributes.add(ccl::ATTR_STD_CURVE_LENGTH)->data_float();
 	}
+	ccl::float3* generated = strands_geom->attributes.add(ccl::ATTR_STD_GENERATED)->data_float3();
 
-	ULONG strand_sizes_length = 0;
-	ULONG first_key = 0;
-	for (size_t curve_index = 0; curve_index < total_curves; curve_index++)
-	{
-		// get actual point index for this curve
-		size_t point_index = out_strand_points[curve_index];  // we should get data for this point and strand
-
-		// get strand positions array
-		strand_position_data.GetSubArray(point_index, one_strand_data);
-		ULONG strand_knots_length = one_strand_data.GetCount();
-		// one strand data contains non-zero values
-		// also extract strand sizes, if it exists
-		if (use_strand_size)
-		{
-			strand_size_data.GetSubArray(point_index, one_strand_size_data);
-			// and save the array length
-			// we will use it later to check is the array is too short or not
-			strand_sizes_length = one_strand_size_data.GetCount();
-		}
-		else
-		{
-			strand_sizes_length = 0;
-		}
+	// we always need keys with radius, so write it to the original positions array
+	out_original_positions.resize(total_keys);
+	ccl::float4* keys = out_original_positions.data();
 
-		// set start point of the strand - point position
-		XSI::MATH::CVector3f point_position = point_position_data[point_index];
-		// for initial strand point use point size
-		// if points size aray is empty, use zero value
-		// if the point index outside of the array, use the last value of the array
-		float point_radius = calculate_strand_radius(point_index, size_data, size_data_length, 0, strand_knots_length + 1, one_strand_size_data, strand_sizes_length);
-		strands_geom->add_curve_key(vector3_to_float3(point_position), point_radius);
-
-		// if we need motion blur, fill original positions array
-		if (use_motion_blur)
-		{
-			out_original_positions[original_index] = ccl::make_float4(point_position.GetX(), point_position.GetY(), point_position.GetZ(), point_radius);
-			original_index++;
-		}
-
-		// start strand, so the intercept attribute is 0.0
-		if (attr_intercept)
-		{
-			attr_intercept->add(0.0);
-		}
-
-		float strand_sparse_length = 0.0f;
-		float total_time = strand_knots_length + 1;
-		for (ULONG k_index = 0; k_index < strand_knots_length; k_index++)
+	ccl::parallel_for((size_t)0, (size_t)total_curves, [&](size_t curve_index)
+	{
+		const IceStrandSpan& span = spans[curve_index];
+		ULONG key_start = first_keys[curve_index];
+		ULONG strand_keys = span.knots_count + 1;
+		float strand_sparse_length = write_strand_keys(span, strands_knots, strands_sizes, keys + key_start);
+		for (ULONG k = 0; k < strand_keys; k++)
 		{
-			float radius = calculate_strand_radius(point_index, size_data, size_data_length, k_index + 1, strand_knots_length + 1, one_strand_size_data, strand_sizes_length);
-			
-			XSI::MATH::CVector3f knot_position = one_strand_data[k_index];
-			strands_geom->add_curve_key(vector3_to_float3(knot_position), radius);
-			if (k_index > 0)
-			{
-				XSI::MATH::CVector3f prev_knot_position = one_strand_data[k_index - 1];
-				float dx = knot_position.GetX() - prev_knot_position.GetX();
-				float dy = knot_position.GetY() - prev_knot_position.GetY();
-				float dz = knot_position.GetZ() - prev_knot_position.GetZ();
-				strand_sparse_length += sqrtf(dx * dx + dy * dy + dz * dz);
-			}
-
-			if (use_motion_blur)
+			const ccl::float4& key = keys[key_start + k];
+			curve_keys[key_start + k] = ccl::make_float3(key.x, key.y, key.z);
+			curve_radius[key_start + k] = key.w;
+			if (intercept_data != NULL)
 			{
-				out_original_positions[original_index] = ccl::make_float4(knot_position.GetX(), knot_position.GetY(), knot_position.GetZ(), radius);
-				original_index++;
-			}
-
-			if (attr_intercept)
-			{
-				float time = static_cast<float>(k_index + 1) / total_time;
-
-				attr_intercept->add(time);
+				intercept_data[key_start + k] = static_cast<float>(k) / static_cast<float>(strand_keys);
 			}
 		}
-		if (attr_random != NULL)
+		curve_first_key[curve_index] = key_start;
+		curve_shader[curve_index] = 0;
+		generated[curve_index] = curve_keys[key_start];
+
+		if (random_data != NULL)
 		{
-			attr_random->add(ccl::hash_uint2_to_float(curve_index, 0));
+			random_data[curve_index] = ccl::hash_uint2_to_float(curve_index, 0);
 		}
-		if (attr_length != NULL)
+		if (length_data != NULL)
 		{
-			attr_length->add(strand_sparse_length);
+			length_data[curve_index] = strand_sparse_length;
 		}
-		strands_geom->add_curve(first_key, 0);
-		first_key += strand_knots_length + 1;
-	}
+	});
+
+	strands_geom->tag_curve_keys_modified();
+	strands_geom->tag_curve_radius_modified();
+	strands_geom->tag_curve_first_key_modified();
+	strands_geom->tag_curve_shader_modified();
 
-	ccl::Attribute* attr_generated = strands_geom->attributes.add(ccl::ATTR_STD_GENERATED);
-	ccl::float3* generated = attr_generated->data_float3();
-	for (size_t i = 0; i < strands_geom->num_curves(); i++)
+	if (!use_motion_blur)
 	{
-		ccl::float3 co = strands_geom->get_curve_keys()[strands_geom->get_curve(i).first_key];
-		generated[i] = co;
+		out_original_positions.clear();
+		out_original_positions.shrink_to_fit();
 	}
 
 	// add ICE attributes
 	// each attribute is per curve
 	XSI::CRefArray xsi_ice_attributes = xsi_geometry.GetICEAttributes();
+	std::vector<LONG> curve_points(out_strand_points.begin(), out_strand_points.end());
 
 	for (LONG i = 0; i < xsi_ice_attributes.GetCount(); i++)
 	{
@@ -295,13 +329,7 @@ void sync_strands_geom(ccl::Scene* scene,
 					xsi_attribute.GetDataArray(attr_data);
 
 					ccl::Attribute* cycles_attribute = strands_geom->attributes.add(attr_name, ccl::TypeVector, ccl::ATTR_ELEMENT_CURVE);
-
-					ccl::float3* cyc_attr_data = cycles_attribute->data_float3();
-					for (size_t v_index = 0; v_index < total_curves; v_index++)
-					{
-						*cyc_attr_data = vector3_to_float3(attr_data[out_strand_points[v_index]]);
-						cyc_attr_data++;
-					}
+					gather_ice_attribute(attr_data, cycles_attribute->data_float3(), total_curves, curve_points);
 				}
 				else if (attr_data_type == XSI::siICENodeDataColor4)
 				{
@@ -309,13 +337,7 @@ void sync_strands_geom(ccl::Scene* scene,
 					xsi_attribute.GetDataArray(attr_data);
 
 					ccl::Attribute* cycles_attribute = strands_geom->attributes.add(attr_name, ccl::TypeColor, ccl::ATTR_ELEMENT_CURVE);
-
-					ccl::float4* cyc_attr_data = cycles_attribute->data_float4();
-					for (size_t v_index = 0; v_index < total_curves; v_index++)
-					{
-						*cyc_attr_data = color4_to_float4(attr_data[out_strand_points[v_index]]);
-						cyc_attr_data++;
-					}
+					gather_ice_attribute(attr_data, cycles_attribute->data_float4(), total_curves, curve_points);
 				}
 				else if (attr_data_type == XSI::siICENodeDataFloat)
 				{
@@ -323,13 +345,7 @@ void sync_strands_geom(ccl::Scene* scene,
 					xsi_attribute.GetDataArray(attr_data);
 
 					ccl::Attribute* cycles_attribute = strands_geom->attributes.add(attr_name, ccl::TypeFloat, ccl::ATTR_ELEMENT_CURVE);
-
-					float* cyc_attr_data = cycles_attribute->data_float();
-					for (size_t v_index = 0; v_index < total_curves; v_index++)
-					{
-						*cyc_attr_data = attr_data[out_strand_points[v_index]];
-						cyc_attr_data++;
-					}
+					gather_ice_attribute(attr_data, cycles_attribute->data_float(), total_curves, curve_points);
 				}
 			}
 		}
@@ -347,14 +363,28 @@ void sync_strands_deform(ccl::Hair* hair,
 	hair->set_motion_steps(motion_steps);
 	hair->set_use_motion_blur(true);
 
-	size_t attribute_index = 0;
 	ccl::Attribute* attr_m_positions = hair->attributes.add(ccl::ATTR_STD_MOTION_VERTEX_POSITION, ccl::ustring("std_motion_strand_position"));
 	ccl::float4* motion_positions = attr_m_positions->data_float4();
 	MotionSettingsPosition motion_position = update_context->get_motion_position();
 
+	// index of the first key for each curve
+	size_t total_curves = strand_points.size();
+	std::vector<size_t> first_keys(total_curves);
+	size_t total_keys = 0;
+	for (size_t curve_index = 0; curve_index < total_curves; curve_index++)
+	{
+		first_keys[curve_index] = total_keys;
+		total_keys += strand_length[curve_index] + 1;
+	}
+
+	std::vector<IceStrandSpan> spans(total_curves);
+	std::vector<bool> is_valid_span(total_curves);
+	std::vector<XSI::MATH::CVector3f> strands_knots;
+	std::vector<float> strands_sizes;
 	for (size_t mi = 0; mi < motion_steps - 1; mi++)
 	{
 		size_t time_motion_step = calc_time_motion_step(mi, motion_steps, motion_position);
+		ccl::float4* step_positions = motion_positions + mi * total_keys;
 
 		float time = update_context->get_motion_time(time_motion_step);
 		XSI::Geometry time_xsi_geometry = xsi_object.GetActivePrimitive(time).GetGeometry();
@@ -387,73 +417,68 @@ void sync_strands_deform(ccl::Hair* hair,
 				time_strand_size_count = time_strand_size_data.GetCount();
 			}
 
-			// iterate throw strands
-			size_t total_curves = strand_points.size();
-			size_t original_positions_iterator = 0;
 			// we should iterate throw curves in the original frame
+			// at first collect strand data at this time
+			XSI::CICEAttributeDataArrayVector3f time_one_strand_positions;
+			XSI::CICEAttributeDataArrayFloat strand_sizes;
+			strands_knots.clear();
+			strands_sizes.clear();
 			for (size_t curve_index = 0; curve_index < total_curves; curve_index++)
 			{
 				size_t point_index = strand_points[curve_index];
-				size_t strand_knots_count = strand_length[curve_index];
+				is_valid_span[curve_index] = false;
 				// check that in this time the point exists
-				bool is_fail = true;
 				if (point_index < time_points_count && point_index < time_sizes_count && point_index < time_strands_count)
 				{
-					// create buffer for every strand independently
-					// in onether case the render is crashed
-					XSI::CICEAttributeDataArrayVector3f time_one_strand_positions;
 					time_strand_data.GetSubArray(point_index, time_one_strand_positions);
-					XSI::CICEAttributeDataArrayFloat strand_sizes;
-					ULONG strand_sizes_length = 0;
-					if (use_strand_size && point_index < time_strand_size_count)
+					// the strand length at the time should be equal to the strand length at original frame
+					if (time_one_strand_positions.GetCount() == strand_length[curve_index])
 					{
-						time_strand_size_data.GetSubArray(point_index, strand_sizes);
-						strand_sizes_length = strand_sizes.GetCount();
-					}
-					size_t time_strand_knots_count = time_one_strand_positions.GetCount();  // the number of knots in the current strand at current time
-					float strand_prop_length = time_strand_knots_count + 1;
-					if (time_strand_knots_count == strand_knots_count)
-					{
-						// the strand length at the time equal to the strand length at original frame
-						is_fail = false;
-
-						XSI::MATH::CVector3f p = time_pos_data[point_index];
-						float point_radius = calculate_strand_radius(point_index, time_size_data, time_sizes_count, 0, time_strand_knots_count + 1, strand_sizes, strand_sizes_length);
-						motion_positions[attribute_index++] = ccl::make_float4(p.GetX(), p.GetY(), p.GetZ(), point_radius);
-						// next keys for strand positions
-						for (ULONG k_index = 0; k_index < time_strand_knots_count; k_index++)
+						IceStrandSpan& span = spans[curve_index];
+						span.knots_start = strands_knots.size();
+						span.knots_count = strand_length[curve_index];
+						for (ULONG k = 0; k < span.knots_count; k++)
 						{
-							float s = calculate_strand_radius(point_index, time_size_data, time_sizes_count, k_index + 1, time_strand_knots_count + 1, strand_sizes, strand_sizes_length);
-							p = time_one_strand_positions[k_index];
-							motion_positions[attribute_index++] = ccl::make_float4(p.GetX(), p.GetY(), p.GetZ(), s);
+							strands_knots.push_back(time_one_strand_positions[k]);
 						}
-					}
-					else
-					{
-						// the strand length is different with original one
-						// in this case simply copy original positions
-						is_fail = true;
+						span.sizes_start = strands_sizes.size();
+						span.sizes_count = 0;
+						if (use_strand_size && point_index < time_strand_size_count)
+						{
+							time_strand_size_data.GetSubArray(point_index, strand_sizes);
+							span.sizes_count = strand_sizes.GetCount();
+							for (ULONG k = 0; k < span.sizes_count; k++)
+							{
+								strands_sizes.push_back(strand_sizes[k]);
+							}
+						}
+						span.point_position = time_pos_data[point_index];
+						span.point_radius = get_strand_point_radius(time_size_data, time_sizes_count, point_index);
+						is_valid_span[curve_index] = true;
 					}
 				}
-				if (is_fail)
+			}
+
+			// next write keys in parallel
+			ccl::parallel_for((size_t)0, total_curves, [&](size_t curve_index)
+			{
+				size_t key_start = first_keys[curve_index];
+				if (is_valid_span[curve_index])
+				{
+					write_strand_keys(spans[curve_index], strands_knots, strands_sizes, step_positions + key_start);
+				}
+				else
 				{
 					// at present time the pointcloud does not contains data for a given point
 					// or the strand length is different with original one
 					// in this case we should copy strand positions from original positions (only for this strand)
-					for (size_t k = 0; k < strand_knots_count + 1; k++)
-					{
-						motion_positions[attribute_index++] = original_positions[original_positions_iterator + k];
-					}
+					std::copy(original_positions.begin() + key_start, original_positions.begin() + key_start + strand_length[curve_index] + 1, step_positions + key_start);
 				}
-				original_positions_iterator += strand_knots_count + 1;
-			}
+			});
 		}
 		else
 		{// invald attribute at the time, set default positions
-			for (size_t k_index = 0; k_index < original_positions.size(); k_index++)
-			{
-				motion_positions[attribute_index++] = original_positions[k_index];
-			}
+			std::copy(original_positions.begin(), original_positions.end(), step_positions);
 		}
 	}
 }
@@ -513,7 +538,7 @@ ccl::Hair* sync_strands_object(ccl::Scene* scene, ccl::Object* object, UpdateCon
 	XSI::Material xsi_material = xsi_object.GetMaterial();
 	ULONG xsi_material_id = xsi_material.GetObjectID();
 	size_t shader_index = 0;
-	if (update_context->is_material_exists(xsi_material_id))
+	if (sync_used_material(scene, update_context, xsi_material))
 	{
 		shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
 	}
@@ -12,6 +12,7 @@
 #include <xsi_floatarray.h>
 #include <xsi_nurbssurfacemesh.h>
 #include <xsi_nurbssurface.h>
+#include <xsi_nurbsdata.h>
 
 #include "../../update_context.h"
 #include "../../../utilities/xsi_properties.h"
@@ -21,6 +22,7 @@
 #include "../cyc_scene.h"
 #include "cyc_geometry.h"
 #include "cyc_tangent_attribute.h"
+#include "cyc_geometry_cache.h"
 
 void sync_surface_motion_deform(ccl::Mesh* surface, UpdateContext* update_context, const XSI::X3DObject& xsi_object, float u_sample_step, int u_samples, float v_sample_step, int v_samples)
 {
@@ -149,12 +151,70 @@ void sync_surface_geom(ccl::Scene* scene, ccl::Mesh* mesh, UpdateContext* update
 	}
 }
 
+void add_surfaces_to_hash(GeometryHash& hash, const XSI::NurbsSurfaceMesh& xsi_surface_geometry)
+{
+	XSI::CNurbsSurfaceDataArray surfaces_data;
+	xsi_surface_geometry.Get(XSI::siSINurbs, surfaces_data);
+	LONG surfaces_count = surfaces_data.GetCount();
+	hash.add((ULONG)surfaces_count);
+	for (LONG i = 0; i < surfaces_count; i++)
+	{
+		const XSI::CNurbsSurfaceData& data = surfaces_data[i];
+		hash.add(data.m_aControlPoints);
+		hash.add(data.m_aUKnots);
+		hash.add(data.m_aVKnots);
+		hash.add((int)data.m_bUClosed);
+		hash.add((int)data.m_bVClosed);
+		hash.add((int)data.m_lUDegree);
+		hash.add((int)data.m_lVDegree);
+	}
+}
+
+// tessellated mesh depends only on control points of the surfaces and tessellation settings
+// so, if the hash is the same, then we can skip the tessellation
+uint64_t compute_surface_hash(UpdateContext* update_context, const XSI::Primitive& xsi_primitive, XSI::X3DObject& xsi_object, const XSI::Property& surface_property, bool use_motion_blur, const ccl::array<ccl::Node*>& used_shaders)
+{
+	XSI::CTime eval_time = update_context->get_time();
+
+	GeometryHash hash;
+	hash.add(combine_geometry_name(xsi_object, xsi_primitive));
+	hash.add(eval_time);
+	hash.add((int)surface_property.GetParameterValue("surface_u_samples", eval_time));
+	hash.add((int)surface_property.GetParameterValue("surface_v_samples", eval_time));
+	add_surfaces_to_hash(hash, xsi_primitive.GetGeometry(eval_time));
+	hash.add_shaders_attributes(used_shaders);
+
+	hash.add(use_motion_blur ? 1 : 0);
+	if (use_motion_blur)
+	{
+		std::vector<double> motion_times = update_context->get_motion_times();
+		hash.add(motion_times);
+		hash.add((int)update_context->get_motion_position());
+		for (size_t i = 0; i < motion_times.size(); i++)
+		{
+			add_surfaces_to_hash(hash, xsi_object.GetActivePrimitive(motion_times[i]).GetGeometry(motion_times[i]));
+		}
+	}
+
+	return hash.get_value();
+}
+
 void sync_surface_geom_process(ccl::Scene* scene, ccl::Mesh* mesh, UpdateContext* update_context, const XSI::Primitive& xsi_primitive, XSI::X3DObject& xsi_object, const XSI::Property& surface_property, bool motion_deform) {
 	mesh->name = combine_geometry_name(xsi_object, xsi_primitive).GetAsciiString();
 
 	LONG num_keys = 0;
 	bool use_motion_blur = update_context->get_need_motion() && motion_deform;
 
+	if (update_context->get_use_geometry_hash())
+	{
+		uint64_t surface_hash = compute_surface_hash(update_context, xsi_primitive, xsi_object, surface_property, use_motion_blur, mesh->get_used_shaders());
+		update_context->add_geometry_hash(xsi_primitive.GetObjectID(), surface_hash);
+		if (update_context->restore_cached_geometry(xsi_primitive.GetObjectID(), surface_hash, mesh))
+		{
+			return;
+		}
+	}
+
 	XSI::CTime eval_time = update_context->get_time();
 	XSI::NurbsSurfaceMesh xsi_surface_geometry = xsi_primitive.GetGeometry(eval_time);
 	XSI::CNurbsSurfaceRefArray xsi_surfaces = xsi_surface_geometry.GetSurfaces();
@@ -175,6 +235,21 @@ void sync_surface_geom_process(ccl::Scene* scene, ccl::Mesh* mesh, UpdateContext
 	}
 }
 
+ccl::array<ccl::Node*> get_surface_used_shaders(ccl::Scene* scene, UpdateContext* update_context, XSI::X3DObject& xsi_object)
+{
+	XSI::Material xsi_material = xsi_object.GetMaterial();
+	ULONG xsi_material_id = xsi_material.GetObjectID();
+	size_t shader_index = 0;
+	if (sync_used_material(scene, update_context, xsi_material)){
+		shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
+	}
+
+	ccl::array<ccl::Node*> used_shaders;
+	used_shaders.push_back_slow(scene->shaders[shader_index]);
+
+	return used_shaders;
+}
+
 ccl::Mesh* sync_surface_object(ccl::Scene* scene, ccl::Object* surface_object, UpdateContext* update_context, XSI::X3DObject& xsi_object, const XSI::Property& surface_property)
 {
 	XSI::CTime eval_time = update_context->get_time();
@@ -200,16 +275,7 @@ ccl::Mesh* sync_surface_object(ccl::Scene* scene, ccl::Object* surface_object, U
 
 	ccl::Mesh* mesh = scene->create_node<ccl::Mesh>();
 
-	XSI::Material xsi_material = xsi_object.GetMaterial();
-	ULONG xsi_material_id = xsi_material.GetObjectID();
-	size_t shader_index = 0;
-	if (update_context->is_material_exists(xsi_material_id)){
-		shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
-	}
-
-	ccl::array<ccl::Node*> used_shaders;
-	used_shaders.push_back_slow(scene->shaders[shader_index]);
-	mesh->set_used_shaders(used_shaders);
+	mesh->set_used_shaders(get_surface_used_shaders(scene, update_context, xsi_object));
 
 	sync_surface_geom_process(scene, mesh, update_context, xsi_primitive, xsi_object, surface_property, motion_deform);
 
@@ -220,8 +286,8 @@ ccl::Mesh* sync_surface_object(ccl::Scene* scene, ccl::Object* surface_object, U
 
 XSI::CStatus update_surface(ccl::Scene* scene, UpdateContext* update_context, XSI::X3DObject& xsi_object)
 {
-	// as for curves, we always update geometry of the surface
-	// because even if only change the property, we can change samples count and thus the geometry should be rebuild
+	// as for curves, the geometry of the surface is rebuilded only if the hash of control points and tessellation settings is changed
+	// so, transform or material changes does not require the tessellation
 	XSI::CTime eval_time = update_context->get_time();
 	XSI::CParameterRefArray render_parameters = update_context->get_current_render_parameters();
 	XSI::Primitive xsi_prim(xsi_object.GetActivePrimitive(eval_time));
@@ -248,16 +314,34 @@ XSI::CStatus update_surface(ccl::Scene* scene, UpdateContext* update_context, XS
 		{
 			size_t geo_index = update_context->get_geometry_index(xsi_id);
 			ccl::Geometry* geometry = scene->geometry[geo_index];
-			XSI::Property surface_prop = get_xsi_object_property(xsi_object, "CycleSurface");
+			XSI::Property surface_prop = get_xsi_object_property(xsi_object, "CyclesSurface");
 
 			if (surface_prop.IsValid() && geometry->geometry_type == ccl::Geometry::Type::MESH)
 			{
 				ccl::Mesh* surface_geom = static_cast<ccl::Mesh*>(geometry);
-				surface_geom->clear(true);
+				// the material can be changed or reassigned, so set actual shaders before the hash is computed
+				ccl::array<ccl::Node*> used_shaders = get_surface_used_shaders(scene, update_context, xsi_object);
+				bool is_shaders_changed = !is_used_shaders_equal(surface_geom->get_used_shaders(), used_shaders);
+				if (is_shaders_changed)
+				{
+					surface_geom->set_used_shaders(used_shaders);
+				}
+
+				bool use_motion_blur = update_context->get_need_motion() && motion_deform;
+				uint64_t surface_hash = compute_surface_hash(update_context, xsi_prim, xsi_object, surface_prop, use_motion_blur, surface_geom->get_used_shaders());
+				if (!update_context->is_geometry_hash_equal(xsi_id, surface_hash))
+				{
+					surface_geom->clear(true);
 
-				sync_surface_geom_process(scene, surface_geom, update_context, xsi_prim, xsi_object, surface_prop, motion_deform);
+					sync_surface_geom_process(scene, surface_geom, update_context, xsi_prim, xsi_object, surface_prop, motion_deform);
 
-				surface_geom->tag_update(scene, true);
+					surface_geom->tag_update(scene, true);
+				}
+				else if (is_shaders_changed)
+				{
+					// the new material can use displacement, so rebuild the mesh
+					surface_geom->tag_update(scene, true);
+				}
 			}
 			else
 			{
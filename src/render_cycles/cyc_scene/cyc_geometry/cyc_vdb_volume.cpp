@@ -6,6 +6,7 @@
 
 #include "../cyc_loaders/cyc_loaders.h"
 #include "../../../render_cycles/update_context.h"
+#include "../cyc_scene.h"
 #include "cyc_geometry.h"
 #include "../../../render_cycles/cyc_primitives/vdb_primitive.h"
 #include "../../../utilities/math.h"
@@ -25,7 +26,16 @@ void add_vdb_to_volume(ccl::Scene* scene, ccl::Volume* volume_geom, const XSI::C
 		attr = volume_geom->attributes.add(attr_name, is_vector ? ccl::TypeDesc::TypeVector : ccl::TypeDesc::TypeFloat, ccl::ATTR_ELEMENT_VOXEL);
 	}
 
-	XSIVDBLoader* vdb_loader = new XSIVDBLoader(vdb_data.grids[index], xsi_object.GetObjectID(), file_path, index, vdb_data.grid_names[index].GetAsciiString());
+	// voxels of the grid are loaded only here, when the grid is required by the shader
+	XSI::CustomPrimitive xsi_prim(xsi_object.GetActivePrimitive(eval_time));
+	openvdb::GridBase::Ptr grid = get_vdb_grid(xsi_prim, index, eval_time);
+	if (!grid)
+	{
+		volume_geom->attributes.remove(attr);
+		return;
+	}
+
+	XSIVDBLoader* vdb_loader = new XSIVDBLoader(grid, xsi_object.GetObjectID(), file_path, index, vdb_data.grid_names[index].GetAsciiString());
 	ccl::ImageParams volume_params;
 	volume_params.frame = frame;
 
@@ -195,7 +205,7 @@ void sync_vdb_volume_geom_process(ccl::Scene* scene, ccl::Volume* volume_geom, U
 			ccl::ustring a_name = ccl::ustring(attr_name.GetAsciiString());
 			if (force_load_all_grids || volume_geom->need_attribute(scene, a_name))
 			{
-				add_vdb_to_volume(scene, volume_geom, eval_time, xsi_object, vdb_data, i, frame, file_path, false, ccl::ATTR_STD_NONE, a_name, is_vector_type(vdb_data.grids[i]));
+				add_vdb_to_volume(scene, volume_geom, eval_time, xsi_object, vdb_data, i, frame, file_path, false, ccl::ATTR_STD_NONE, a_name, is_vector_type(vdb_data.grids_metadata[i]));
 				loaded_grid_names.push_back(attr_name);
 			}
 		}
@@ -230,7 +240,7 @@ ccl::Volume* sync_vdb_volume_object(ccl::Scene* scene, ccl::Object* object, Upda
 	XSI::Material xsi_material = xsi_object.GetMaterial();
 	ULONG xsi_material_id = xsi_material.GetObjectID();
 	size_t shader_index = 0;
-	if (update_context->is_material_exists(xsi_material_id))
+	if (sync_used_material(scene, update_context, xsi_material))
 	{
 		shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
 	}
@@ -284,9 +294,9 @@ XSI::CStatus update_vdb(ccl::Scene* scene, UpdateContext* update_context, XSI::X
 
 				XSI::CParameterRefArray& prim_params = xsi_primitive.GetParameters();
 				XSI::CString file_path = vdbprimitive_inputs_to_path(prim_params, eval_time);
-				VDBData vdb_data = get_vdb_data(xsi_primitive);
+				std::shared_ptr<VDBData> vdb_data = get_vdb_data(xsi_primitive, eval_time);
 
-				sync_vdb_volume_geom_process(scene, volume_geom, update_context, xsi_object, vdb_data, file_path);
+				sync_vdb_volume_geom_process(scene, volume_geom, update_context, xsi_object, *vdb_data, file_path);
 
 				volume_geom->tag_update(scene, true);
 			}
@@ -166,23 +166,55 @@ void sync_volume_parameters(ccl::Volume* volume, XSI::X3DObject& xsi_object, con
 	volume->set_object_space(object_space == 0);
 }
 
-void sync_volume_attribute(ccl::Scene* scene, ccl::Volume* volume_geom, bool is_std_atribute, ccl::AttributeStandard std_attribute, const std::string &attribute_name, VolumeAttributeType attribute_data_type, const XSI::Primitive &xsi_primitive, const XSI::CTime &eval_time)
+// return precision of float grids in the NanoVDB format: 32 - full float, 16 - half, 0 - variable
+int get_volume_precision(XSI::X3DObject& xsi_object, const XSI::CTime& eval_time)
+{
+	XSI::Property xsi_property = get_xsi_object_property(xsi_object, "CyclesVolume");
+	int precision_mode = 0;
+	if (xsi_property.IsValid())
+	{
+		XSI::Parameter precision_param = xsi_property.GetParameter("volume_precision");
+		if (precision_param.IsValid())
+		{
+			precision_mode = precision_param.GetValue(eval_time);
+		}
+	}
+
+	return precision_mode == 1 ? 16 : (precision_mode == 2 ? 0 : 32);
+}
+
+void sync_volume_attribute(ccl::Scene* scene, ccl::Volume* volume_geom, bool is_std_atribute, ccl::AttributeStandard std_attribute, const std::string &attribute_name, VolumeAttributeType attribute_data_type, const XSI::Primitive &xsi_primitive, const XSI::CTime &eval_time, int volume_precision)
 {
 	ccl::Attribute* attribute = is_std_atribute ? 
 		volume_geom->attributes.add(std_attribute) :
 		volume_geom->attributes.add(ccl::ustring(attribute_name), attribute_data_type == VolumeAttributeType::VolumeAttributeType_Float ? ccl::TypeFloat : (attribute_data_type == VolumeAttributeType::VolumeAttributeType_Vector ? ccl::TypeVector : ccl::TypeColor), ccl::ATTR_ELEMENT_VOXEL);
 
-	ICEVolumeLoader* ice_loader = new ICEVolumeLoader(attribute_data_type, xsi_primitive, attribute_name, eval_time);
+	// float and vector attributes are converted to sparse grids, colors are always exported as dense grids
+	ccl::ImageLoader* loader = NULL;
+	bool is_empty = true;
+	if (attribute_data_type == VolumeAttributeType::VolumeAttributeType_Color)
+	{
+		ICEVolumeLoader* ice_loader = new ICEVolumeLoader(attribute_data_type, xsi_primitive, attribute_name, eval_time);
+		is_empty = ice_loader->is_empty();
+		loader = ice_loader;
+	}
+	else
+	{
+		ICESparseVolumeLoader* ice_loader = new ICESparseVolumeLoader(attribute_data_type, xsi_primitive, attribute_name, eval_time, volume_precision);
+		is_empty = ice_loader->is_empty();
+		loader = ice_loader;
+	}
 
-	if (ice_loader->is_empty())
+	if (is_empty)
 	{
 		volume_geom->attributes.remove(attribute);
+		delete loader;
 	}
 	else
 	{
 		ccl::ImageParams volume_params;
 		volume_params.frame = eval_time.GetTime();
-		attribute->data_voxel() = scene->image_manager->add_image(std::unique_ptr<ccl::ImageLoader>(ice_loader), volume_params, false);
+		attribute->data_voxel() = scene->image_manager->add_image(std::unique_ptr<ccl::ImageLoader>(loader), volume_params, false);
 	}
 }
 
@@ -193,6 +225,7 @@ void sync_volume_geom_process(ccl::Scene* scene, ccl::Volume* volume_geom, Updat
 	XSI::CTime eval_time = update_context->get_time();
 
 	sync_volume_parameters(volume_geom, xsi_object, eval_time);
+	int volume_precision = get_volume_precision(xsi_object, eval_time);
 
 	// we should get all valid combinations of ICE attributes
 	// but exports only needed from this list
@@ -204,37 +237,37 @@ void sync_volume_geom_process(ccl::Scene* scene, ccl::Volume* volume_geom, Updat
 	std::unordered_set<std::string> exported_names;
 	if (volume_geom->need_attribute(scene, ccl::AttributeStandard::ATTR_STD_VOLUME_DENSITY) && volume_attributes_map.contains("density") && volume_attributes_map["density"] == VolumeAttributeType::VolumeAttributeType_Float)
 	{
-		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_DENSITY, "density", VolumeAttributeType::VolumeAttributeType_Float, xsi_primitive, eval_time);
+		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_DENSITY, "density", VolumeAttributeType::VolumeAttributeType_Float, xsi_primitive, eval_time, volume_precision);
 		exported_names.insert("density");
 	}
 
 	if (volume_geom->need_attribute(scene, ccl::AttributeStandard::ATTR_STD_VOLUME_COLOR) && volume_attributes_map.contains("color") && volume_attributes_map["color"] == VolumeAttributeType::VolumeAttributeType_Color)
 	{
-		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_COLOR, "color", VolumeAttributeType::VolumeAttributeType_Color, xsi_primitive, eval_time);
+		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_COLOR, "color", VolumeAttributeType::VolumeAttributeType_Color, xsi_primitive, eval_time, volume_precision);
 		exported_names.insert("color");
 	}
 
 	if (volume_geom->need_attribute(scene, ccl::AttributeStandard::ATTR_STD_VOLUME_FLAME) && volume_attributes_map.contains("flame") && volume_attributes_map["flame"] == VolumeAttributeType::VolumeAttributeType_Float)
 	{
-		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_FLAME, "flame", VolumeAttributeType::VolumeAttributeType_Float, xsi_primitive, eval_time);
+		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_FLAME, "flame", VolumeAttributeType::VolumeAttributeType_Float, xsi_primitive, eval_time, volume_precision);
 		exported_names.insert("flame");
 	}
 
 	if (volume_geom->need_attribute(scene, ccl::AttributeStandard::ATTR_STD_VOLUME_HEAT) && volume_attributes_map.contains("heat") && volume_attributes_map["heat"] == VolumeAttributeType::VolumeAttributeType_Float)
 	{
-		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_HEAT, "heat", VolumeAttributeType::VolumeAttributeType_Float, xsi_primitive, eval_time);
+		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_HEAT, "heat", VolumeAttributeType::VolumeAttributeType_Float, xsi_primitive, eval_time, volume_precision);
 		exported_names.insert("heat");
 	}
 
 	if (volume_geom->need_attribute(scene, ccl::AttributeStandard::ATTR_STD_VOLUME_TEMPERATURE) && volume_attributes_map.contains("temperature") && volume_attributes_map["temperature"] == VolumeAttributeType::VolumeAttributeType_Float)
 	{
-		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_TEMPERATURE, "temperature", VolumeAttributeType::VolumeAttributeType_Float, xsi_primitive, eval_time);
+		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_TEMPERATURE, "temperature", VolumeAttributeType::VolumeAttributeType_Float, xsi_primitive, eval_time, volume_precision);
 		exported_names.insert("temperature");
 	}
 
 	if (volume_geom->need_attribute(scene, ccl::AttributeStandard::ATTR_STD_VOLUME_VELOCITY) && volume_attributes_map.contains("velocity") && volume_attributes_map["velocity"] == VolumeAttributeType::VolumeAttributeType_Vector)
 	{
-		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_VELOCITY, "velocity", VolumeAttributeType::VolumeAttributeType_Vector, xsi_primitive, eval_time);
+		sync_volume_attribute(scene, volume_geom, true, ccl::AttributeStandard::ATTR_STD_VOLUME_VELOCITY, "velocity", VolumeAttributeType::VolumeAttributeType_Vector, xsi_primitive, eval_time, volume_precision);
 		exported_names.insert("velocity");
 	}
 
@@ -243,7 +276,7 @@ void sync_volume_geom_process(ccl::Scene* scene, ccl::Volume* volume_geom, Updat
 	{
 		if (!exported_names.contains(key) && volume_geom->need_attribute(scene, ccl::ustring(key.c_str())))
 		{
-			sync_volume_attribute(scene, volume_geom, false, ccl::AttributeStandard::ATTR_STD_NONE, key, val, xsi_primitive, eval_time);
+			sync_volume_attribute(scene, volume_geom, false, ccl::AttributeStandard::ATTR_STD_NONE, key, val, xsi_primitive, eval_time, volume_precision);
 			exported_names.insert(key);
 		}
 	}
@@ -276,7 +309,7 @@ ccl::Volume* sync_volume_object(ccl::Scene* scene, ccl::Object* object, UpdateCo
 	XSI::Material xsi_material = xsi_object.GetMaterial();
 	ULONG xsi_material_id = xsi_material.GetObjectID();
 	size_t shader_index = 0;
-	if (update_context->is_material_exists(xsi_material_id))
+	if (sync_used_material(scene, update_context, xsi_material))
 	{
 		shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
 	}
@@ -364,7 +397,18 @@ XSI::CStatus update_volume_property(ccl::Scene* scene, UpdateContext* update_con
 			if (geometry->geometry_type == ccl::Geometry::Type::VOLUME)
 			{
 				ccl::Volume* volume_geom = static_cast<ccl::Volume*>(geometry);
-				sync_volume_parameters(volume_geom, xsi_object, eval_time);
+				if (is_pointcloud_volume(xsi_object, eval_time))
+				{
+					// precision of grids can be changed, so recreate attributes
+					// loaders with the same settings are equal to existing ones, so the image manager reuses already loaded grids
+					volume_geom->clear(true);
+					sync_volume_geom_process(scene, volume_geom, update_context, xsi_prim, xsi_object);
+					volume_geom->tag_update(scene, true);
+				}
+				else
+				{
+					sync_volume_parameters(volume_geom, xsi_object, eval_time);
+				}
 			}
 			else
 			{
@@ -425,7 +425,7 @@ void sync_custom_background(ccl::Scene* scene, const XSI::X3DObject &xsi_object,
 	// at first we should get the shader
 	XSI::Material xsi_material = xsi_object.GetMaterial();
 	ULONG xsi_material_id = xsi_material.GetObjectID();
-	if (update_context->is_material_exists(xsi_material_id))
+	if (sync_used_material(scene, update_context, xsi_material))
 	{
 		size_t shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
 		if (shader_index >= 0 && shader_index < scene->shaders.size())
@@ -472,7 +472,7 @@ void sync_custom_light(ccl::Scene* scene, const XSI::X3DObject & xsi_object, Upd
 			// get light shader index
 			XSI::Material xsi_material = xsi_object.GetMaterial();
 			ULONG xsi_material_id = xsi_material.GetObjectID();
-			if (update_context->is_material_exists(xsi_material_id))
+			if (sync_used_material(scene, update_context, xsi_material))
 			{
 				size_t shader_index = update_context->get_xsi_material_cycles_index(xsi_material_id);
 
@@ -729,7 +729,8 @@ void update_background(ccl::Scene* scene, UpdateContext* update_context)
 		std::vector<XSI::CStringArray> aovs(2);
 		aovs[0].Clear();
 		aovs[1].Clear();
-		XSI::CStatus is_update = update_material(scene, xsi_material, shader_index, update_context->get_time(), aovs);
+		bool is_update_displacement = false;
+		XSI::CStatus is_update = update_material(scene, update_context, xsi_material, shader_index, update_context->get_time(), aovs, is_update_displacement);
 		set_background_light(scene, scene->background, scene->default_background, update_context, update_context->get_current_render_parameters(), update_context->get_time());
 	}
 }
\ No newline at end of file
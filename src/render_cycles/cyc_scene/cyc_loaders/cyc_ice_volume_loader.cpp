@@ -6,24 +6,22 @@
 #include <xsi_geometry.h>
 #include <xsi_primitive.h>
 
+#include <openvdb/openvdb.h>
+#include <openvdb/tools/Dense.h>
+
+#include <cstring>
+
 #include "cyc_loaders.h"
 #include "../../../utilities/logs.h"
 #include "../../../utilities/files_io.h"
 #include "../../../render_base/type_enums.h"
 
-ICEVolumeLoader::ICEVolumeLoader(VolumeAttributeType attribute_type, const XSI::Primitive& xsi_primitive, const std::string& attribute_name, const XSI::CTime& eval_time)
+// read resolution and corners of the volume from attributes name_size, name_min and name_max
+void read_ice_volume_bounds(const XSI::Geometry& xsi_geometry, const XSI::CString& attribute_name, size_t& size_x, size_t& size_y, size_t& size_z, XSI::MATH::CVector3f& min_value, XSI::MATH::CVector3f& max_value)
 {
-	m_xsi_primitive_id = xsi_primitive.GetObjectID();
-	m_xsi_attribute_name = XSI::CString(attribute_name.c_str());
-	m_attribute_type = attribute_type;
-
-	XSI::Geometry xsi_geometry = xsi_primitive.GetGeometry(eval_time);
-	m_xsi_attribute = xsi_geometry.GetICEAttributeFromName(m_xsi_attribute_name);
-
-	// get size and corners attributes
-	XSI::ICEAttribute size_attribute = xsi_geometry.GetICEAttributeFromName(m_xsi_attribute_name + "_size");
-	XSI::ICEAttribute min_attribute = xsi_geometry.GetICEAttributeFromName(m_xsi_attribute_name + "_min");
-	XSI::ICEAttribute max_attribute = xsi_geometry.GetICEAttributeFromName(m_xsi_attribute_name + "_max");
+	XSI::ICEAttribute size_attribute = xsi_geometry.GetICEAttributeFromName(attribute_name + "_size");
+	XSI::ICEAttribute min_attribute = xsi_geometry.GetICEAttributeFromName(attribute_name + "_min");
+	XSI::ICEAttribute max_attribute = xsi_geometry.GetICEAttributeFromName(attribute_name + "_max");
 
 	XSI::CICEAttributeDataArrayVector3f size_data;
 	size_attribute.GetDataArray(size_data);
@@ -35,12 +33,27 @@ ICEVolumeLoader::ICEVolumeLoader(VolumeAttributeType attribute_type, const XSI::
 	max_attribute.GetDataArray(max_data);
 
 	XSI::MATH::CVector3f size_value = size_data[0];
-	XSI::MATH::CVector3f min_value = min_data[0];
-	XSI::MATH::CVector3f max_value = max_data[0];
+	min_value = min_data[0];
+	max_value = max_data[0];
+
+	size_x = (size_t)(std::max(size_value.GetX(), 0.0f) + 0.5);
+	size_y = (size_t)(std::max(size_value.GetY(), 0.0f) + 0.5);
+	size_z = (size_t)(std::max(size_value.GetZ(), 0.0f) + 0.5);
+}
+
+ICEVolumeLoader::ICEVolumeLoader(VolumeAttributeType attribute_type, const XSI::Primitive& xsi_primitive, const std::string& attribute_name, const XSI::CTime& eval_time)
+{
+	m_xsi_primitive_id = xsi_primitive.GetObjectID();
+	m_xsi_attribute_name = XSI::CString(attribute_name.c_str());
+	m_attribute_type = attribute_type;
+
+	XSI::Geometry xsi_geometry = xsi_primitive.GetGeometry(eval_time);
+	m_xsi_attribute = xsi_geometry.GetICEAttributeFromName(m_xsi_attribute_name);
 
-	m_size_x = (size_t)(std::max(size_value.GetX(), 0.0f) + 0.5);
-	m_size_y = (size_t)(std::max(size_value.GetY(), 0.0f) + 0.5);
-	m_size_z = (size_t)(std::max(size_value.GetZ(), 0.0f) + 0.5);
+	// get size and corners attributes
+	XSI::MATH::CVector3f min_value;
+	XSI::MATH::CVector3f max_value;
+	read_ice_volume_bounds(xsi_geometry, m_xsi_attribute_name, m_size_x, m_size_y, m_size_z, min_value, max_value);
 
 	m_min_x = min_value.GetX();
 	m_min_y = min_value.GetY();
@@ -99,11 +112,10 @@ bool ICEVolumeLoader::load_pixels(const ccl::ImageMetaData& metadata, void* pixe
 		size_t floats_count = float_data.GetCount();
 		if (read_status == XSI::CStatus::OK && floats_count == pixels_size)
 		{
-			float* fpixels = (float*)pixels;
-			for (size_t i = 0; i < floats_count; i++)
+			// sub array is a plain buffer of floats, so copy it at once
+			if (floats_count > 0)
 			{
-				*fpixels = float_data[i];
-				fpixels++;
+				std::memcpy(pixels, &float_data[0], sizeof(float) * floats_count);
 			}
 
 			return true;
@@ -119,14 +131,10 @@ bool ICEVolumeLoader::load_pixels(const ccl::ImageMetaData& metadata, void* pixe
 		size_t vectors_count = vector_data.GetCount();
 		if (read_status == XSI::CStatus::OK && vectors_count * 3 == pixels_size)
 		{
-			float* fpixels = (float*)pixels;
-			for (size_t i = 0; i < vectors_count; i++)
+			// CVector3f is three floats, the same layout as three channels pixels
+			if (vectors_count > 0)
 			{
-				XSI::MATH::CVector3f vector = vector_data[i];
-				fpixels[0] = vector.GetX();
-				fpixels[1] = vector.GetY();
-				fpixels[2] = vector.GetZ();
-				fpixels += 3;
+				std::memcpy(pixels, &vector_data[0], sizeof(XSI::MATH::CVector3f) * vectors_count);
 			}
 
 			return true;
@@ -142,15 +150,10 @@ bool ICEVolumeLoader::load_pixels(const ccl::ImageMetaData& metadata, void* pixe
 		size_t colors_count = color_data.GetCount();
 		if (read_status == XSI::CStatus::OK && colors_count * 4 == pixels_size)
 		{
-			float* fpixels = (float*)pixels;
-			for (size_t i = 0; i < colors_count; i++)
+			// CColor4f is rgba floats
+			if (colors_count > 0)
 			{
-				XSI::MATH::CColor4f color = color_data[i];
-				fpixels[0] = color.GetR();
-				fpixels[1] = color.GetG();
-				fpixels[2] = color.GetB();
-				fpixels[3] = color.GetA();
-				fpixels += 4;
+				std::memcpy(pixels, &color_data[0], sizeof(XSI::MATH::CColor4f) * colors_count);
 			}
 
 			return true;
@@ -206,6 +209,136 @@ XSI::CString ICEVolumeLoader::get_attribute_name() const { return m_xsi_attribut
 ULONG ICEVolumeLoader::get_primitive_id() const { return m_xsi_primitive_id; }
 VolumeAttributeType ICEVolumeLoader::get_attribute_type() const { return m_attribute_type; }
 bool ICEVolumeLoader::is_empty() const
+{
+	return m_is_empty;
+}
+
+ICESparseVolumeLoader::ICESparseVolumeLoader(VolumeAttributeType attribute_type, const XSI::Primitive& xsi_primitive, const std::string& attribute_name, const XSI::CTime& eval_time, int volume_precision) : VDBImageLoader(attribute_name)
+{
+	m_xsi_primitive_id = xsi_primitive.GetObjectID();
+	m_xsi_attribute_name = XSI::CString(attribute_name.c_str());
+	m_attribute_type = attribute_type;
+	m_precision = volume_precision;
+#ifdef WITH_NANOVDB
+	precision = volume_precision;
+#endif
+
+	XSI::Geometry xsi_geometry = xsi_primitive.GetGeometry(eval_time);
+	m_xsi_attribute = xsi_geometry.GetICEAttributeFromName(m_xsi_attribute_name);
+
+	XSI::MATH::CVector3f min_value;
+	XSI::MATH::CVector3f max_value;
+	read_ice_volume_bounds(xsi_geometry, m_xsi_attribute_name, m_size_x, m_size_y, m_size_z, min_value, max_value);
+
+	m_min_x = min_value.GetX();
+	m_min_y = min_value.GetY();
+	m_min_z = min_value.GetZ();
+	m_max_x = max_value.GetX();
+	m_max_y = max_value.GetY();
+	m_max_z = max_value.GetZ();
+
+	m_is_empty = (m_size_x == 0 || m_size_y == 0 || m_size_z == 0) ||
+		!(m_attribute_type == VolumeAttributeType::VolumeAttributeType_Float || m_attribute_type == VolumeAttributeType::VolumeAttributeType_Vector);
+}
+
+ICESparseVolumeLoader::~ICESparseVolumeLoader()
+{
+
+}
+
+// copy dense array into the sparse grid, voxels with background (zero) values are skipped
+// ice data is ordered as x + y * size_x + z * size_x * size_y, this is LayoutXYZ in OpenVDB terms
+template<typename GridType, typename T>
+typename GridType::Ptr build_sparse_grid(const T* data, size_t size_x, size_t size_y, size_t size_z)
+{
+	openvdb::CoordBBox bbox(openvdb::Coord(0, 0, 0), openvdb::Coord((int)size_x - 1, (int)size_y - 1, (int)size_z - 1));
+	openvdb::tools::Dense<T, openvdb::tools::LayoutXYZ> dense(bbox, const_cast<T*>(data));
+
+	typename GridType::Ptr grid = GridType::create(openvdb::zeroVal<T>());
+	openvdb::tools::copyFromDense(dense, *grid, openvdb::zeroVal<T>());
+
+	return grid;
+}
+
+bool ICESparseVolumeLoader::build_grid()
+{
+	size_t voxels_count = m_size_x * m_size_y * m_size_z;
+	openvdb::GridBase::Ptr sparse_grid;
+	if (m_attribute_type == VolumeAttributeType::VolumeAttributeType_Float)
+	{
+		XSI::CICEAttributeDataArray2DFloat float_array_data;
+		XSI::CStatus read_status = m_xsi_attribute.GetDataArray2D(float_array_data);
+		XSI::CICEAttributeDataArrayFloat float_data;
+		float_array_data.GetSubArray(0, float_data);
+
+		if (read_status == XSI::CStatus::OK && float_data.GetCount() == voxels_count)
+		{
+			sparse_grid = build_sparse_grid<openvdb::FloatGrid, float>(&float_data[0], m_size_x, m_size_y, m_size_z);
+		}
+	}
+	else if (m_attribute_type == VolumeAttributeType::VolumeAttributeType_Vector)
+	{
+		XSI::CICEAttributeDataArray2DVector3f vector_array_data;
+		XSI::CStatus read_status = m_xsi_attribute.GetDataArray2D(vector_array_data);
+		XSI::CICEAttributeDataArrayVector3f vector_data;
+		vector_array_data.GetSubArray(0, vector_data);
+
+		if (read_status == XSI::CStatus::OK && vector_data.GetCount() == voxels_count)
+		{
+			// CVector3f and openvdb Vec3f have the same layout
+			sparse_grid = build_sparse_grid<openvdb::Vec3fGrid, openvdb::Vec3f>((const openvdb::Vec3f*)&vector_data[0], m_size_x, m_size_y, m_size_z);
+		}
+	}
+
+	if (!sparse_grid)
+	{
+		return false;
+	}
+
+	// voxel centers of the dense grid are placed in the middle of the cells between min and max corners
+	openvdb::Vec3d voxel_size((m_max_x - m_min_x) / (double)m_size_x, (m_max_y - m_min_y) / (double)m_size_y, (m_max_z - m_min_z) / (double)m_size_z);
+	openvdb::math::Mat4d matrix = openvdb::math::Mat4d::identity();
+	matrix.setToScale(voxel_size);
+	matrix.setTranslation(openvdb::Vec3d(m_min_x, m_min_y, m_min_z) + 0.5 * voxel_size);
+	sparse_grid->setTransform(openvdb::math::Transform::createLinearTransform(matrix));
+	sparse_grid->setName(grid_name);
+
+	grid = sparse_grid;
+
+	return true;
+}
+
+bool ICESparseVolumeLoader::load_metadata(const ccl::ImageDeviceFeatures& features, ccl::ImageMetaData& metadata)
+{
+	// the grid is released in cleanup after the loading, so build it again if the image is reloaded
+	if (!grid && !build_grid())
+	{
+		return false;
+	}
+
+	return VDBImageLoader::load_metadata(features, metadata);
+}
+
+bool ICESparseVolumeLoader::equals(const ImageLoader& other) const
+{
+	const ICESparseVolumeLoader& other_loader = (const ICESparseVolumeLoader&)other;
+
+	return m_size_x == other_loader.m_size_x
+		&& m_size_y == other_loader.m_size_y
+		&& m_size_z == other_loader.m_size_z
+		&& m_min_x == other_loader.m_min_x
+		&& m_min_y == other_loader.m_min_y
+		&& m_min_z == other_loader.m_min_z
+		&& m_max_x == other_loader.m_max_x
+		&& m_max_y == other_loader.m_max_y
+		&& m_max_z == other_loader.m_max_z
+		&& m_xsi_attribute_name == other_loader.m_xsi_attribute_name
+		&& m_xsi_primitive_id == other_loader.m_xsi_primitive_id
+		&& m_attribute_type == other_loader.m_attribute_type
+		&& m_precision == other_loader.m_precision;
+}
+
+bool ICESparseVolumeLoader::is_empty() const
 {
 	return m_is_empty;
 }
\ No newline at end of file
@@ -1,9 +1,37 @@
+#include "util/half.h"
+
 #include <xsi_arrayparameter.h>
 #include <xsi_parameter.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
 #include "cyc_loaders.h"
 #include "../../../utilities/logs.h"
 #include "../../../utilities/files_io.h"
+#include "../../../utilities/math.h"
+#include "../../../input/input.h"
+
+// clips with 2 bytes per channel contain either half floats (from exr files) or 16-bit integers (from png, tiff and other files)
+bool is_half_clip_file(const XSI::CString& file_path)
+{
+	ULONG point_pos = file_path.ReverseFindString(".");
+	if (point_pos == UINT_MAX)
+	{
+		return false;
+	}
+
+	XSI::CString ext = file_path.GetSubString(point_pos + 1);
+	ext.Lower();
+
+	return ext == "exr";
+}
 
 XSIImageLoader::XSIImageLoader(XSI::ImageClip2& xsi_clip, const ccl::ustring& selected_colorspace, int tile, const XSI::CString& image_path, const XSI::CTime& eval_time)
 {
@@ -12,7 +40,6 @@ XSIImageLoader::XSIImageLoader(XSI::ImageClip2& xsi_clip, const ccl::ustring& se
 	m_tile = tile;
 	m_image_path = image_path;
 
-	bool proper_source = false;
 	if (image_path.Length() == 0) {
 		m_use_clip = true;
 		m_xsi_clip_path = xsi_clip.GetFileName();
@@ -23,81 +50,419 @@ XSIImageLoader::XSIImageLoader(XSI::ImageClip2& xsi_clip, const ccl::ustring& se
 		m_width = m_xsi_image.GetResX();
 		m_height = m_xsi_image.GetResY();
 		m_channels = m_xsi_image.GetNumChannels();
-		m_channel_size = m_xsi_image.GetChannelSize();  // 1 for ldr, 4 for float hdr
-		proper_source = true;
+		m_channel_size = m_xsi_image.GetChannelSize();  // 1 for ldr, 2 for half or 16-bit integer, 4 for float hdr
+		m_is_half_clip = m_channel_size == 2 && is_half_clip_file(m_xsi_clip_path);
 	}
 	else {
+		// the file is not touched here, the header is read in load_metadata and pixels are decoded in load_pixels
+		// so, textures which Cycles never requests, are never loaded
 		m_use_clip = false;
+		m_width = 1;
+		m_height = 1;
+		m_channels = 1;
+		m_channel_size = 4;
+		m_is_half_clip = false;
+	}
+
+	m_texture_max_size = get_texture_max_size();
+	m_use_texture_cache = get_texture_use_cache();
+	m_scale = 1;
 
-		// read pixels and override texture size
-		bool is_sucess = false;
+	m_color_profile = selected_colorspace;
+}
+
+XSIImageLoader::~XSIImageLoader()
+{
+
+}
+
+bool XSIImageLoader::load_metadata(const ccl::ImageDeviceFeatures& features, ccl::ImageMetaData& metadata)
+{
+	if (!m_use_clip)
+	{
+		// read only the header of the image file
 		ULONG out_width = 0;
 		ULONG out_height = 0;
 		ULONG out_channels = 0;
-		m_image_pixels = load_image(image_path, out_width, out_height, out_channels, is_sucess);
-
-		if (is_sucess)
+		ULONG out_channel_size = 4;
+		if (load_image_info(m_image_path, out_width, out_height, out_channels, out_channel_size))
 		{
 			m_width = out_width;
 			m_height = out_height;
 			m_channels = out_channels;
-			m_use_clip = false;
-			proper_source = true;
+			m_channel_size = out_channel_size;
+		}
+		else
+		{
+			// fallback to one black pixel
+			m_width = 1;
+			m_height = 1;
+			m_channels = 1;
+			m_channel_size = 4;
 		}
 	}
 
-	if (!proper_source) {
-		m_width = 1;
-		m_height = 1;
-		m_channels = 1;
-		m_image_pixels.resize(1);
-		m_image_pixels[0] = 0.0;
+	// large textures are reduced by powers of two, if the texture size is limited in config
+	// half clips are always used in the full resolution
+	m_scale = m_channel_size == 2 ? 1 : get_image_reduce_scale(m_width, m_height, m_texture_max_size);
+
+	metadata.width = std::max((ULONG)1, m_width / m_scale);
+	metadata.height = std::max((ULONG)1, m_height / m_scale);
+	metadata.channels = m_channels;
+	metadata.depth = 1;
+	metadata.colorspace = m_color_profile;
+
+	// 8-bit images (from clips or from files) are stored as byte textures, Cycles apply color space conversion to it
+	if (m_channel_size == 1)
+	{
+		metadata.type = m_channels == 1 ? ccl::IMAGE_DATA_TYPE_BYTE : ccl::IMAGE_DATA_TYPE_BYTE4;
+	}
+	else if (m_channel_size == 2)
+	{
+		// 16-bit integer clips are converted to half in load_pixels
+		metadata.type = m_channels == 1 ? ccl::IMAGE_DATA_TYPE_HALF : ccl::IMAGE_DATA_TYPE_HALF4;
+	}
+	else if (m_channel_size == 4)
+	{
+		metadata.type = m_channels == 1 ? ccl::IMAGE_DATA_TYPE_FLOAT : ccl::IMAGE_DATA_TYPE_FLOAT4;
 	}
 
-	m_color_profile = selected_colorspace;
+	return true;
 }
 
-XSIImageLoader::~XSIImageLoader()
+// copy pixels of the image into the output buffer
+// output has the same number of channels as the image, or 4 channels, then missing channels are filled by one_value
+template<typename T>
+void copy_output_pixels(const T* image_pixels, ULONG pixels_count, ULONG image_channels, ULONG output_channels, T one_value, T* output)
+{
+	if (image_channels == output_channels)
+	{
+		memcpy(output, image_pixels, (size_t)pixels_count * output_channels * sizeof(T));
+	}
+	else
+	{
+		T* out_pixel = output;
+		for (ULONG i = 0; i < pixels_count; i++)
+		{
+			for (ULONG c = 0; c < image_channels; c++)
+			{
+				out_pixel[c] = image_pixels[image_channels * i + c];
+			}
+			for (ULONG c = image_channels; c < 4; c++)
+			{
+				out_pixel[c] = one_value;
+			}
+
+			out_pixel += 4;
+		}
+	}
+}
+
+// like in Blender, premultiply alpha
+void associate_pixels_alpha(unsigned char* pixels, ULONG pixels_count)
 {
-	m_image_pixels.clear();
-	m_image_pixels.shrink_to_fit();
+	unsigned char* out_pixel = pixels;
+	for (ULONG i = 0; i < pixels_count; i++)
+	{
+		out_pixel[0] = (out_pixel[0] * out_pixel[3]) / 255;
+		out_pixel[1] = (out_pixel[1] * out_pixel[3]) / 255;
+		out_pixel[2] = (out_pixel[2] * out_pixel[3]) / 255;
+
+		out_pixel += 4;
+	}
 }
 
-bool XSIImageLoader::load_metadata(const ccl::ImageDeviceFeatures& features, ccl::ImageMetaData& metadata)
+void associate_pixels_alpha(ccl::half* pixels, ULONG pixels_count)
 {
-	metadata.width = m_width;
-	metadata.height = m_height;
-	metadata.channels = m_channels;
-	metadata.depth = 1;
-	metadata.colorspace = m_color_profile;
+	ccl::half* out_pixel = pixels;
+	for (ULONG i = 0; i < pixels_count; i++)
+	{
+		float alpha = ccl::half_to_float(out_pixel[3]);
+		out_pixel[0] = ccl::float_to_half_image(ccl::half_to_float(out_pixel[0]) * alpha);
+		out_pixel[1] = ccl::float_to_half_image(ccl::half_to_float(out_pixel[1]) * alpha);
+		out_pixel[2] = ccl::float_to_half_image(ccl::half_to_float(out_pixel[2]) * alpha);
 
-	if (m_use_clip)
+		out_pixel += 4;
+	}
+}
+
+void associate_pixels_alpha(float* pixels, ULONG pixels_count)
+{
+	float* out_pixel = pixels;
+	for (ULONG i = 0; i < pixels_count; i++)
 	{
-		if (m_channel_size == 1)
+		out_pixel[0] = out_pixel[0] * out_pixel[3];
+		out_pixel[1] = out_pixel[1] * out_pixel[3];
+		out_pixel[2] = out_pixel[2] * out_pixel[3];
+
+		out_pixel += 4;
+	}
+}
+
+void decode_image_file(const XSI::CString& file_path, ULONG& out_width, ULONG& out_height, ULONG& out_channels, bool& out_sucess, std::vector<unsigned char>& out_pixels)
+{
+	out_pixels = load_image_bytes(file_path, out_width, out_height, out_channels, out_sucess);
+}
+
+void decode_image_file(const XSI::CString& file_path, ULONG& out_width, ULONG& out_height, ULONG& out_channels, bool& out_sucess, std::vector<float>& out_pixels)
+{
+	out_pixels = load_image(file_path, out_width, out_height, out_channels, out_sucess);
+}
+
+std::vector<unsigned char> reduce_file_pixels(const std::vector<unsigned char>& pixels, ULONG width, ULONG height, ULONG channels, ULONG scale, bool is_srgb)
+{
+	return reduce_pixels(pixels.data(), width, height, channels, scale, is_srgb);
+}
+
+std::vector<float> reduce_file_pixels(const std::vector<float>& pixels, ULONG width, ULONG height, ULONG channels, ULONG scale, bool is_srgb)
+{
+	// float pixels are always linear
+	return reduce_pixels(pixels.data(), width, height, channels, scale);
+}
+
+// read pixels of the image file and reduce it in scale times
+// reduced pixels are taken from the texture cache, if it contains the copy of the same file
+// is_srgb is true if 8-bit pixels are in sRGB color space, then these pixels are reduced in linear space
+// return false if the file is invalid or changed after metadata was read
+template<typename T>
+bool load_file_pixels(const XSI::CString& file_path, ULONG width, ULONG height, ULONG channels, ULONG scale, bool use_cache, bool is_srgb, std::vector<T>& out_pixels)
+{
+	ULONG out_width = std::max((ULONG)1, width / scale);
+	ULONG out_height = std::max((ULONG)1, height / scale);
+	XSI::CString cache_path = (scale > 1 && use_cache) ? get_texture_cache_path(file_path, scale, is_srgb && sizeof(T) == 1) : "";
+	if (cache_path.Length() > 0)
+	{
+		out_pixels.resize((size_t)out_width * out_height * channels);
+		if (read_texture_cache(cache_path, out_width, out_height, channels, sizeof(T), out_pixels.data()))
 		{
-			metadata.type = m_channels == 1 ? ccl::IMAGE_DATA_TYPE_BYTE : ccl::IMAGE_DATA_TYPE_BYTE4;
+			return true;
 		}
-		else if (m_channel_size == 2)
+	}
+
+	bool is_sucess = false;
+	ULONG image_width = 0;
+	ULONG image_height = 0;
+	ULONG image_channels = 0;
+	decode_image_file(file_path, image_width, image_height, image_channels, is_sucess, out_pixels);
+	if (!is_sucess || image_width != width || image_height != height || image_channels != channels)
+	{
+		return false;
+	}
+
+	if (scale > 1)
+	{
+		out_pixels = reduce_file_pixels(out_pixels, width, height, channels, scale, is_srgb);
+		if (cache_path.Length() > 0)
 		{
-			metadata.type = m_channels == 1 ? ccl::IMAGE_DATA_TYPE_HALF : ccl::IMAGE_DATA_TYPE_HALF4;
+			write_texture_cache(cache_path, out_width, out_height, channels, sizeof(T), out_pixels.data());
 		}
-		else if (m_channel_size == 4)
+	}
+
+	return true;
+}
+
+// background decoding of image files, used for the next frames of image sequences
+// pixels are decoded and reduced in the same way as in load_pixels, then the loader of this file takes it from here
+struct PrefetchRequest
+{
+	std::string file_path;
+	ULONG texture_max_size;
+	bool use_texture_cache;
+	bool is_srgb;
+};
+
+struct PrefetchedImage
+{
+	std::string file_path;
+	ULONG width;
+	ULONG height;
+	ULONG channels;
+	ULONG scale;
+	bool is_srgb;
+	std::vector<unsigned char> byte_pixels;
+	std::vector<float> float_pixels;
+
+	size_t get_memory() const
+	{
+		return byte_pixels.size() * sizeof(unsigned char) + float_pixels.size() * sizeof(float);
+	}
+};
+
+std::mutex prefetch_mutex;
+std::condition_variable prefetch_condition;
+std::thread prefetch_thread;
+bool prefetch_stop = false;
+std::deque<PrefetchRequest> prefetch_queue;
+// path of the file, which is decoded right now
+std::string prefetch_current_path;
+// the oldest images are at the begin of the list
+std::list<PrefetchedImage> prefetched_images;
+size_t prefetched_memory = 0;
+size_t prefetch_memory_limit = 0;
+bool use_prefetch = false;
+
+void prefetch_thread_loop()
+{
+	while (true)
+	{
+		PrefetchRequest request;
 		{
-			metadata.type = m_channels == 1 ? ccl::IMAGE_DATA_TYPE_FLOAT : ccl::IMAGE_DATA_TYPE_FLOAT4;
+			std::unique_lock<std::mutex> lock(prefetch_mutex);
+			prefetch_condition.wait(lock, [] { return prefetch_stop || prefetch_queue.size() > 0; });
+			if (prefetch_stop)
+			{
+				return;
+			}
+			request = prefetch_queue.front();
+			prefetch_queue.pop_front();
+			prefetch_current_path = request.file_path;
 		}
+
+		PrefetchedImage image;
+		image.file_path = request.file_path;
+		image.is_srgb = request.is_srgb;
+		XSI::CString file_path(request.file_path.c_str());
+		ULONG channel_size = 4;
+		bool is_success = load_image_info(file_path, image.width, image.height, image.channels, channel_size);
+		if (is_success)
+		{
+			image.scale = get_image_reduce_scale(image.width, image.height, request.texture_max_size);
+			if (channel_size == 1)
+			{
+				is_success = load_file_pixels(file_path, image.width, image.height, image.channels, image.scale, request.use_texture_cache, request.is_srgb, image.byte_pixels);
+			}
+			else
+			{
+				is_success = load_file_pixels(file_path, image.width, image.height, image.channels, image.scale, request.use_texture_cache, request.is_srgb, image.float_pixels);
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(prefetch_mutex);
+			prefetch_current_path = "";
+			size_t image_memory = image.get_memory();
+			if (is_success && image_memory <= prefetch_memory_limit)
+			{
+				// remove the oldest images, these are frames which are already rendered
+				while (prefetched_images.size() > 0 && prefetched_memory + image_memory > prefetch_memory_limit)
+				{
+					prefetched_memory -= prefetched_images.front().get_memory();
+					prefetched_images.pop_front();
+				}
+				prefetched_memory += image_memory;
+				prefetched_images.push_back(std::move(image));
+			}
+		}
+		prefetch_condition.notify_all();
 	}
-	else
+}
+
+void set_use_image_prefetch(bool value)
+{
+	use_prefetch = value;
+}
+
+void prefetch_image_file(const XSI::CString& file_path, bool is_srgb)
+{
+	ULONG memory_limit = get_texture_prefetch_memory();
+	if (!use_prefetch || memory_limit == 0 || file_path.Length() == 0)
 	{
-		metadata.type = m_channels == 1 ? ccl::IMAGE_DATA_TYPE_FLOAT : ccl::IMAGE_DATA_TYPE_FLOAT4;
+		return;
 	}
 
-	return true;
+	std::string file_path_str = file_path.GetAsciiString();
+	{
+		std::lock_guard<std::mutex> lock(prefetch_mutex);
+		prefetch_memory_limit = (size_t)memory_limit * 1024 * 1024;
+		if (prefetch_current_path == file_path_str)
+		{
+			return;
+		}
+		for (const PrefetchRequest& request : prefetch_queue)
+		{
+			if (request.file_path == file_path_str)
+			{
+				return;
+			}
+		}
+		for (const PrefetchedImage& image : prefetched_images)
+		{
+			if (image.file_path == file_path_str)
+			{
+				return;
+			}
+		}
+
+		prefetch_queue.push_back({ file_path_str, get_texture_max_size(), get_texture_use_cache(), is_srgb });
+		if (!prefetch_thread.joinable())
+		{
+			prefetch_stop = false;
+			prefetch_thread = std::thread(prefetch_thread_loop);
+		}
+	}
+	prefetch_condition.notify_all();
+}
+
+void stop_image_prefetch()
+{
+	{
+		std::lock_guard<std::mutex> lock(prefetch_mutex);
+		prefetch_stop = true;
+		prefetch_queue.clear();
+	}
+	prefetch_condition.notify_all();
+	if (prefetch_thread.joinable())
+	{
+		prefetch_thread.join();
+	}
+
+	prefetched_images.clear();
+	prefetched_memory = 0;
+}
+
+std::vector<unsigned char>& get_prefetched_pixels(PrefetchedImage& image, const std::vector<unsigned char>& type_tag)
+{
+	return image.byte_pixels;
+}
+
+std::vector<float>& get_prefetched_pixels(PrefetchedImage& image, const std::vector<float>& type_tag)
+{
+	return image.float_pixels;
+}
+
+// move prefetched pixels of the file to out_pixels, return false if there are no such pixels
+// if the file is decoded right now, then wait it
+template<typename T>
+bool take_prefetched_pixels(const XSI::CString& file_path, ULONG width, ULONG height, ULONG channels, ULONG scale, bool is_srgb, std::vector<T>& out_pixels)
+{
+	std::string file_path_str = file_path.GetAsciiString();
+	std::unique_lock<std::mutex> lock(prefetch_mutex);
+	prefetch_condition.wait(lock, [&] { return prefetch_current_path != file_path_str; });
+	for (auto it = prefetched_images.begin(); it != prefetched_images.end(); ++it)
+	{
+		if (it->file_path == file_path_str)
+		{
+			std::vector<T>& pixels = get_prefetched_pixels(*it, out_pixels);
+			bool is_valid = it->width == width && it->height == height && it->channels == channels && it->scale == scale && it->is_srgb == is_srgb && pixels.size() > 0;
+			if (is_valid)
+			{
+				out_pixels = std::move(pixels);
+			}
+			prefetched_memory -= it->get_memory();
+			prefetched_images.erase(it);
+
+			return is_valid;
+		}
+	}
+
+	return false;
 }
 
 bool XSIImageLoader::load_pixels(const ccl::ImageMetaData& metadata, void* pixels, const size_t pixels_size, const bool associate_alpha)
 {
 	// our image may contains some channels, but output pixels always either 1 or 4 channels
-	ULONG pixels_count = m_width * m_height;
+	// if the texture size is limited, then output size is smaller than the image size
+	ULONG pixels_count = metadata.width * metadata.height;
 	ULONG output_channels = pixels_size / pixels_count;
 
 	if (m_use_clip)
@@ -105,95 +470,63 @@ bool XSIImageLoader::load_pixels(const ccl::ImageMetaData& metadata, void* pixel
 		// use pixels from the clip
 		if (m_channel_size == 1)
 		{// image pixels are bytes
-			// in this case output pixels also set as bytes	
-			// get image pixels
+			// in this case output pixels also set as bytes
 			const unsigned char* image_pixels = (unsigned char*)m_xsi_image.GetPixelArray();
+			std::vector<unsigned char> reduced_pixels;
+			if (m_scale > 1)
+			{
+				reduced_pixels = reduce_pixels(image_pixels, m_width, m_height, m_channels, m_scale, m_color_profile == ccl::u_colorspace_srgb);
+				image_pixels = reduced_pixels.data();
+			}
 
-			if (output_channels == m_channels)
+			copy_output_pixels(image_pixels, pixels_count, m_channels, output_channels, (unsigned char)255, (unsigned char*)pixels);
+			if (associate_alpha && m_channels == 4)
 			{
-				// copy pixels data
-				memcpy(pixels, image_pixels, pixels_size * sizeof(unsigned char));
+				associate_pixels_alpha((unsigned char*)pixels, pixels_count);
 			}
-			else
-			{// output channels are greater than image channels
-				// this means that output has 4 channels, but image has less
-				// so, we should copy the data and fill other channels by 1.0 (or 255)
-				unsigned char* out_pixel = (unsigned char*)pixels;
-				for (ULONG i = 0; i < pixels_count; i++)
+
+			return true;
+		}
+		else if (m_channel_size == 2)
+		{// image pixels are half or 16-bit integers
+			// pass it to Cycles as half, so the texture use 16 bits per channel on the device
+			// 0x3C00 is 1.0 in half precision
+			const ccl::half* image_pixels = (ccl::half*)m_xsi_image.GetPixelArray();
+			std::vector<ccl::half> converted_pixels;
+			if (!m_is_half_clip)
+			{
+				// map integer values to [0, 1]
+				const unsigned short* integer_pixels = (const unsigned short*)m_xsi_image.GetPixelArray();
+				size_t values_count = (size_t)m_width * m_height * m_channels;
+				converted_pixels.resize(values_count);
+				for (size_t i = 0; i < values_count; i++)
 				{
-					for (ULONG c = 0; c < m_channels; c++)
-					{
-						out_pixel[c] = image_pixels[m_channels * i + c];
-					}
-					for (ULONG c = m_channels; 4; c++)
-					{
-						out_pixel[c] = 255;
-					}
-
-					out_pixel += 4;
+					converted_pixels[i] = ccl::float_to_half_image((float)integer_pixels[i] / 65535.0f);
 				}
+				image_pixels = converted_pixels.data();
 			}
-
+			copy_output_pixels(image_pixels, pixels_count, m_channels, output_channels, ccl::half(0x3C00), (ccl::half*)pixels);
 			if (associate_alpha && m_channels == 4)
 			{
-				// like in Blender, premultiply alpha
-				unsigned char* out_pixel = (unsigned char*)pixels;
-				for (size_t i = 0; i < pixels_count; i++)
-				{
-					out_pixel[0] = (out_pixel[0] * out_pixel[3]) / 255;
-					out_pixel[1] = (out_pixel[1] * out_pixel[3]) / 255;
-					out_pixel[2] = (out_pixel[2] * out_pixel[3]) / 255;
-
-					out_pixel += 4;
-				}
+				associate_pixels_alpha((ccl::half*)pixels, pixels_count);
 			}
 
 			return true;
 		}
-		else if (m_channel_size == 2)
-		{// image pixels are half
-			// does not support this
-			memset(pixels, 0, pixels_size * sizeof(ccl::half));
-			return false;
-		}
 		else if (m_channel_size == 4)
 		{// image pixels are float
 			const float* image_pixels = (float*)m_xsi_image.GetPixelArray();
-
-			if (output_channels == m_channels)
-			{
-				memcpy(pixels, image_pixels, pixels_size * sizeof(float));
-			}
-			else
+			std::vector<float> reduced_pixels;
+			if (m_scale > 1)
 			{
-				float* out_pixel = (float*)pixels;
-				for (ULONG i = 0; i < pixels_count; i++)
-				{
-					for (ULONG c = 0; c < m_channels; c++)
-					{
-						out_pixel[c] = image_pixels[m_channels * i + c];
-					}
-					for (ULONG c = m_channels; 4; c++)
-					{
-						out_pixel[c] = 1.0f;
-					}
-
-					out_pixel += 4;
-				}
+				reduced_pixels = reduce_pixels(image_pixels, m_width, m_height, m_channels, m_scale);
+				image_pixels = reduced_pixels.data();
 			}
 
+			copy_output_pixels(image_pixels, pixels_count, m_channels, output_channels, 1.0f, (float*)pixels);
 			if (associate_alpha && m_channels == 4)
 			{
-				// like in Blender, premultiply alpha
-				unsigned char* out_pixel = (unsigned char*)pixels;
-				for (size_t i = 0; i < pixels_count; i++)
-				{
-					out_pixel[0] = (out_pixel[0] * out_pixel[3]);
-					out_pixel[1] = (out_pixel[1] * out_pixel[3]);
-					out_pixel[2] = (out_pixel[2] * out_pixel[3]);
-
-					out_pixel += 4;
-				}
+				associate_pixels_alpha((float*)pixels, pixels_count);
 			}
 
 			return true;
@@ -201,30 +534,32 @@ bool XSIImageLoader::load_pixels(const ccl::ImageMetaData& metadata, void* pixel
 	}
 	else
 	{
-		// use already loaded pixels
-		if (m_channels == output_channels)
+		// decode the image file only now, when Cycles actually needs the pixels
+		bool is_srgb = m_color_profile == ccl::u_colorspace_srgb;
+		if (m_channel_size == 1)
 		{
-			// loaded pixels and output pixels contains the same number of channels (1 or 4)
-			memcpy(pixels, &m_image_pixels[0], pixels_size * sizeof(float));
+			// 8-bit image, keep pixels as bytes
+			std::vector<unsigned char> image_pixels;
+			if (!take_prefetched_pixels(m_image_path, m_width, m_height, m_channels, m_scale, is_srgb, image_pixels) &&
+				!load_file_pixels(m_image_path, m_width, m_height, m_channels, m_scale, m_use_texture_cache, is_srgb, image_pixels))
+			{
+				memset(pixels, 0, pixels_size * sizeof(unsigned char));
+				return true;
+			}
+
+			copy_output_pixels(image_pixels.data(), pixels_count, m_channels, output_channels, (unsigned char)255, (unsigned char*)pixels);
 		}
 		else
 		{
-			// output pixel channels different with loaded pixle channels
-			// loaded image may have 2 or 3 channels and output requires 4 channels
-			float* out_pixel = (float*)pixels;
-			for (ULONG i = 0; i < pixels_count; i++)
+			std::vector<float> image_pixels;
+			if (!take_prefetched_pixels(m_image_path, m_width, m_height, m_channels, m_scale, is_srgb, image_pixels) &&
+				!load_file_pixels(m_image_path, m_width, m_height, m_channels, m_scale, m_use_texture_cache, is_srgb, image_pixels))
 			{
-				for (ULONG c = 0; c < m_channels; c++)
-				{
-					out_pixel[c] = m_image_pixels[m_channels * i + c];
-				}
-				for (ULONG c = m_channels; 4; c++)
-				{
-					out_pixel[c] = 1.0f;
-				}
-
-				out_pixel += 4;
+				memset(pixels, 0, pixels_size * sizeof(float));
+				return true;
 			}
+
+			copy_output_pixels(image_pixels.data(), pixels_count, m_channels, output_channels, 1.0f, (float*)pixels);
 		}
 
 		return true;
@@ -235,8 +570,7 @@ bool XSIImageLoader::load_pixels(const ccl::ImageMetaData& metadata, void* pixel
 
 void XSIImageLoader::cleanup()
 {
-	m_image_pixels.clear();
-	m_image_pixels.shrink_to_fit();
+	// decoded pixels are not stored in the loader, so nothing to release
 }
 
 std::string XSIImageLoader::name() const
@@ -42,15 +42,32 @@ private:
 	ULONG m_height;
 	ULONG m_channels;
 	ULONG m_channel_size;
+	// true if the clip with 2 bytes per channel contains half floats, false for 16-bit integers
+	bool m_is_half_clip;
 	ccl::ustring m_color_profile;
 
 	int m_tile;
 	// this string is non-empty for non-default tile images
 	XSI::CString m_image_path;
 	bool m_use_clip;  // treu if we should extract pixels from the clip, false if read manualy by using image path
-	std::vector<float> m_image_pixels;
+
+	// texture size limit from config, 0 - no limit
+	ULONG m_texture_max_size;
+	bool m_use_texture_cache;
+	// the image is reduced in m_scale times, it's defined in load_metadata
+	ULONG m_scale;
 };
 
+// decode the image file in the background thread (used for the next frame of image sequences)
+// the loader of this file then takes ready pixels instead of decoding it again
+// is_srgb should be the same as the color space of the loader, because 8-bit pixels are reduced in linear space for sRGB images
+void prefetch_image_file(const XSI::CString& file_path, bool is_srgb);
+// prefetch is useful only for final renders, where the next frame is rendered after the current one
+// when it is disabled, prefetch_image_file does nothing
+void set_use_image_prefetch(bool value);
+// stop the prefetch thread and release all prefetched pixels
+void stop_image_prefetch();
+
 class ICEVolumeLoader : public ccl::ImageLoader
 {
 public:
@@ -101,6 +118,43 @@ private:
 	bool m_is_empty;
 };
 
+// build sparse OpenVDB grid from the dense ICE array
+// empty voxels (with zero values) are not stored in the grid, so Cycles creates the volume bounding mesh only around non-empty blocks
+// and the grid is converted to NanoVDB with selected precision on the device
+// supported only float and vector attributes
+class ICESparseVolumeLoader : public ccl::VDBImageLoader
+{
+public:
+	ICESparseVolumeLoader(VolumeAttributeType attribute_type, const XSI::Primitive& xsi_primitive, const std::string& attribute_name, const XSI::CTime& eval_time, int volume_precision);
+	~ICESparseVolumeLoader();
+
+	bool load_metadata(const ccl::ImageDeviceFeatures& features, ccl::ImageMetaData& metadata) override;
+	bool equals(const ImageLoader& other) const override;
+
+	bool is_empty() const;
+
+private:
+	bool build_grid();
+
+	size_t m_size_x;
+	size_t m_size_y;
+	size_t m_size_z;
+	float m_min_x;
+	float m_min_y;
+	float m_min_z;
+	float m_max_x;
+	float m_max_y;
+	float m_max_z;
+
+	VolumeAttributeType m_attribute_type;
+	ULONG m_xsi_primitive_id;
+	XSI::CString m_xsi_attribute_name;
+	XSI::ICEAttribute m_xsi_attribute;
+	int m_precision;
+
+	bool m_is_empty;
+};
+
 class XSIVDBLoader : public ccl::VDBImageLoader
 {
 public:
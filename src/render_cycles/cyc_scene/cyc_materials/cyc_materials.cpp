@@ -2,6 +2,8 @@
 #include "scene/shader.h"
 #include "scene/shader_graph.h"
 #include "scene/shader_nodes.h"
+#include "scene/osl.h"
+#include "util/md5.h"
 
 #include <xsi_material.h>
 #include <xsi_time.h>
@@ -11,6 +13,8 @@
 #include <xsi_scene.h>
 #include <xsi_materiallibrary.h>
 
+#include <unordered_set>
+
 #include "../../update_context.h"
 #include "../../../utilities/logs.h"
 #include "../../../utilities/strings.h"
@@ -406,11 +410,102 @@ void material_to_graph(ccl::Scene* scene, ccl::ShaderGraph* shader_graph, const
 	}
 }
 
+// hash of the node, its input values and connections
+// nodes_indexes used for identify source nodes of connections
+void add_shader_node_hash(ccl::ShaderNode* node, const std::unordered_map<ccl::ShaderNode*, size_t>& nodes_indexes, ccl::MD5Hash& md5)
+{
+	// type of the node and values of all sockets
+	node->hash(md5);
+
+	for (ccl::ShaderInput* input : node->inputs)
+	{
+		if (input->link != NULL)
+		{
+			auto it = nodes_indexes.find(input->link->parent);
+			size_t source_index = it != nodes_indexes.end() ? it->second : SIZE_MAX;
+			md5.append(input->name().string());
+			md5.append((const uint8_t*)&source_index, sizeof(size_t));
+			md5.append(input->link->name().string());
+		}
+	}
+
+	// images are not stored in sockets, so use slots of the image manager
+	// the same loaders reuse the same slots
+	ccl::ImageSlotTextureNode* image_node = dynamic_cast<ccl::ImageSlotTextureNode*>(node);
+	if (image_node != NULL)
+	{
+		for (int i = 0; i < image_node->handle.num_tiles(); i++)
+		{
+			int slot = image_node->handle.svm_slot(i);
+			md5.append((const uint8_t*)&slot, sizeof(int));
+		}
+	}
+
+	// osl nodes with the same parameters can use different scripts
+	ccl::OSLNode* osl_node = dynamic_cast<ccl::OSLNode*>(node);
+	if (osl_node != NULL)
+	{
+		md5.append(osl_node->filepath);
+		md5.append(osl_node->bytecode_hash);
+	}
+}
+
+// compute hashes of the exported graph before Cycles finalize it
+// out_graph_hash is the hash of all nodes, out_displacement_hash - only for nodes connected to the displacement output
+void compute_shader_graph_hash(ccl::ShaderGraph* shader_graph, std::string& out_graph_hash, std::string& out_displacement_hash)
+{
+	std::unordered_map<ccl::ShaderNode*, size_t> nodes_indexes;
+	for (const auto& node : shader_graph->nodes)
+	{
+		ccl::ShaderNode* node_ptr = &*node;
+		nodes_indexes[node_ptr] = nodes_indexes.size();
+	}
+
+	ccl::MD5Hash graph_md5;
+	for (const auto& node : shader_graph->nodes)
+	{
+		add_shader_node_hash(&*node, nodes_indexes, graph_md5);
+	}
+	out_graph_hash = graph_md5.get_hex();
+
+	// iterate over all nodes, connected to the displacement output
+	ccl::MD5Hash displacement_md5;
+	std::vector<ccl::ShaderNode*> nodes_stack;
+	std::unordered_set<ccl::ShaderNode*> visited_nodes;
+	ccl::ShaderInput* displacement_input = shader_graph->output()->input("Displacement");
+	if (displacement_input != NULL && displacement_input->link != NULL)
+	{
+		nodes_stack.push_back(displacement_input->link->parent);
+	}
+	while (nodes_stack.size() > 0)
+	{
+		ccl::ShaderNode* node = nodes_stack.back();
+		nodes_stack.pop_back();
+		if (visited_nodes.contains(node))
+		{
+			continue;
+		}
+		visited_nodes.insert(node);
+
+		add_shader_node_hash(node, nodes_indexes, displacement_md5);
+		for (ccl::ShaderInput* input : node->inputs)
+		{
+			if (input->link != NULL)
+			{
+				nodes_stack.push_back(input->link->parent);
+			}
+		}
+	}
+	out_displacement_hash = displacement_md5.get_hex();
+}
+
 // in this function we should crate the shader, add it to the shaders array and retun it index in this array
-int sync_material(ccl::Scene* scene, const XSI::Material &xsi_material, const XSI::CTime &eval_time, std::vector<XSI::CStringArray> &aovs)
+// hashes are computed before set_graph, because Cycles change the graph in it, so these hashes are comparable with hashes in update_material
+int sync_material(ccl::Scene* scene, const XSI::Material &xsi_material, const XSI::CTime &eval_time, std::vector<XSI::CStringArray> &aovs, std::string& out_graph_hash, std::string& out_displacement_hash)
 {
 	std::unique_ptr<ccl::ShaderGraph> shader_graph = std::make_unique<ccl::ShaderGraph>();
 	material_to_graph(scene, shader_graph.get(), xsi_material, eval_time, aovs);
+	compute_shader_graph_hash(shader_graph.get(), out_graph_hash, out_displacement_hash);
 
 	// create output shader
 	ccl::Shader* shader = scene->create_node<ccl::Shader>();
@@ -496,54 +591,42 @@ int sync_shaderball_texturenode(ccl::Scene* scene, const XSI::Texture& xsi_textu
 	return sync_shaderball_shadernode(scene, xsi_texture_shader, true, eval_time);
 }
 
-void sync_material_process(ccl::Scene* scene, UpdateContext* update_context, const XSI::Material& xsi_material, std::vector<XSI::CStringArray>& aovs, const XSI::CTime& eval_time, bool ignore_empty) {
+void sync_material_process(ccl::Scene* scene, UpdateContext* update_context, const XSI::Material& xsi_material, std::vector<XSI::CStringArray>& aovs, const XSI::CTime& eval_time) {
 	ULONG xsi_id = xsi_material.GetObjectID();
-	XSI::CRefArray used_objects = xsi_material.GetUsedBy();
-	if (ignore_empty || used_objects.GetCount() > 0)
+	std::string graph_hash;
+	std::string displacement_hash;
+	int shader_index = sync_material(scene, xsi_material, eval_time, aovs, graph_hash, displacement_hash);
+	if (shader_index >= 0)
 	{
-		int shader_index = sync_material(scene, xsi_material, eval_time, aovs);
-		if (shader_index >= 0)
-		{
-			update_context->add_material_index(xsi_id,
-				shader_index,
-				scene->shaders[shader_index]->has_displacement,
-				ShaderballType_Unknown);
-		}
-	}
-}
+		update_context->add_shader_graph_hash(shader_index, graph_hash, displacement_hash);
 
-void sync_scene_materials(ccl::Scene* scene, UpdateContext* update_context)
-{
-	XSI::Scene xsi_scene = XSI::Application().GetActiveProject().GetActiveScene();
-	XSI::CRefArray material_libs = xsi_scene.GetMaterialLibraries();
-	XSI::CTime eval_time = update_context->get_time();
-
-	std::vector<XSI::CStringArray> aovs(2);
-	aovs[0].Clear();  // for colors
-	aovs[1].Clear();  // for values
-
-	for (LONG lib_index = 0; lib_index < material_libs.GetCount(); lib_index++)
-	{
-		XSI::MaterialLibrary lib = material_libs.GetItem(lib_index);
-		XSI::CRefArray materials = lib.GetItems();
-		for (LONG mat_index = 0; mat_index < materials.GetCount(); mat_index++)
-		{
-			XSI::Material xsi_material = materials.GetItem(mat_index);
-			sync_material_process(scene, update_context, xsi_material, aovs, eval_time, false);
-		}
+		update_context->add_material_index(xsi_id,
+			shader_index,
+			scene->shaders[shader_index]->has_displacement,
+			ShaderballType_Unknown);
 	}
-
-	// add aov names to update context
-	// it will be used later in pass sync
-	update_context->add_aov_names(aovs[0], aovs[1]);
 }
 
-XSI::CStatus update_material(ccl::Scene* scene, const XSI::Material &xsi_material, size_t shader_index, const XSI::CTime &eval_time, std::vector<XSI::CStringArray> &aovs)
+XSI::CStatus update_material(ccl::Scene* scene, UpdateContext* update_context, const XSI::Material &xsi_material, size_t shader_index, const XSI::CTime &eval_time, std::vector<XSI::CStringArray> &aovs, bool& out_update_displacement)
 {
 	std::unique_ptr<ccl::ShaderGraph> shader_graph = std::make_unique<ccl::ShaderGraph>();
 	material_to_graph(scene, shader_graph.get(), xsi_material, eval_time, aovs);
 	ccl::Shader* shader = scene->shaders[shader_index];
 
+	// Cycles finalize the graph of the shader in-place (fold constants, remove unused nodes and so on)
+	// so, values of the existing nodes can not be changed, and we set the new graph
+	// but when the exported graph is the same (the change does not affect the export), then skip the update
+	std::string graph_hash;
+	std::string displacement_hash;
+	compute_shader_graph_hash(shader_graph.get(), graph_hash, displacement_hash);
+	if (update_context->is_shader_graph_hash_equal(shader_index, graph_hash))
+	{
+		out_update_displacement = false;
+		return XSI::CStatus::OK;
+	}
+	out_update_displacement = !update_context->is_shader_displacement_hash_equal(shader_index, displacement_hash);
+	update_context->add_shader_graph_hash(shader_index, graph_hash, displacement_hash);
+
 	// TODO: there is a bug
 	// when change background shader node intensity to zero with connected sky texture node, and then back to normal value,
 	// then the sun intensity is disabled (even if it enebled in the node)
@@ -619,8 +702,35 @@ XSI::CStatus sync_missed_material(ccl::Scene* scene, UpdateContext* update_conte
 	aovs[0].Clear();
 	aovs[1].Clear();
 
-	sync_material_process(scene, update_context, xsi_material, aovs, eval_time, true);
+	sync_material_process(scene, update_context, xsi_material, aovs, eval_time);
 	update_context->add_aov_names(aovs[0], aovs[1]);
 
 	return XSI::CStatus::OK;
+}
+
+// return true if the material is exported
+// materials are exported on demand, when an object requests it, so unused materials from scene libraries are not exported at all
+bool sync_used_material(ccl::Scene* scene, UpdateContext* update_context, const XSI::Material& xsi_material)
+{
+	ULONG xsi_material_id = xsi_material.GetObjectID();
+	if (update_context->is_material_exists(xsi_material_id))
+	{
+		return true;
+	}
+
+	if (!xsi_material.IsValid())
+	{
+		return false;
+	}
+
+	std::vector<XSI::CStringArray> aovs(2);
+	aovs[0].Clear();  // for colors
+	aovs[1].Clear();  // for values
+
+	sync_material_process(scene, update_context, xsi_material, aovs, update_context->get_time());
+	// add aov names to update context
+	// it will be used later in pass sync
+	update_context->add_aov_names(aovs[0], aovs[1]);
+
+	return update_context->is_material_exists(xsi_material_id);
 }
\ No newline at end of file
@@ -202,1329 +202,1559 @@ void form_ramp(std::vector<GradientPoint>& gradient, int size, ccl::array<ccl::f
 	}
 }
 
-ccl::ShaderNode* sync_cycles_shader(ccl::Scene* scene, 
-	const XSI::Shader& xsi_shader,
-	const XSI::CString &shader_type, 
-	const XSI::CParameterRefArray &xsi_parameters,
-	const XSI::CTime &eval_time, 
-	ccl::ShaderGraph* shader_graph, 
-	std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map,
-	std::vector<XSI::CStringArray>& aovs)
+ccl::ShaderNode* sync_cycles_diffuse_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
 {
-	if (shader_type == "DiffuseBSDF")
-	{
-		ccl::DiffuseBsdfNode* node = shader_graph->create_node<ccl::DiffuseBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		return node;
-	}
-	else if (shader_type == "MetallicBSDF") {
-		ccl::MetallicBsdfNode* node = shader_graph->create_node<ccl::MetallicBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	ccl::DiffuseBsdfNode* node = shader_graph->create_node<ccl::DiffuseBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString distribution = get_string_parameter_value(xsi_parameters, "distribution", eval_time);
-		XSI::CString fresnel_type = get_string_parameter_value(xsi_parameters, "fresnel_type", eval_time);
-		float ior_x = get_float_parameter_value(xsi_parameters, "ior_x", eval_time);
-		float ior_y = get_float_parameter_value(xsi_parameters, "ior_y", eval_time);
-		float ior_z = get_float_parameter_value(xsi_parameters, "ior_z", eval_time);
-		float extinction_x = get_float_parameter_value(xsi_parameters, "extinction_x", eval_time);
-		float extinction_y = get_float_parameter_value(xsi_parameters, "extinction_y", eval_time);
-		float extinction_z = get_float_parameter_value(xsi_parameters, "extinction_z", eval_time);
-
-		node->set_ior(ccl::make_float3(ior_x, ior_y, ior_z));
-		node->set_k(ccl::make_float3(extinction_x, extinction_y, extinction_z));
+	return node;
+}
 
-		node->set_distribution(get_distribution(distribution, DistributionModes_Glass));
-		node->set_fresnel_type(get_metallic_fresnel(fresnel_type));
+ccl::ShaderNode* sync_cycles_metallic_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MetallicBsdfNode* node = shader_graph->create_node<ccl::MetallicBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "PrincipledBSDF")
-	{
-		ccl::PrincipledBsdfNode* node = shader_graph->create_node<ccl::PrincipledBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString distribution = get_string_parameter_value(xsi_parameters, "distribution", eval_time);
+	XSI::CString fresnel_type = get_string_parameter_value(xsi_parameters, "fresnel_type", eval_time);
+	float ior_x = get_float_parameter_value(xsi_parameters, "ior_x", eval_time);
+	float ior_y = get_float_parameter_value(xsi_parameters, "ior_y", eval_time);
+	float ior_z = get_float_parameter_value(xsi_parameters, "ior_z", eval_time);
+	float extinction_x = get_float_parameter_value(xsi_parameters, "extinction_x", eval_time);
+	float extinction_y = get_float_parameter_value(xsi_parameters, "extinction_y", eval_time);
+	float extinction_z = get_float_parameter_value(xsi_parameters, "extinction_z", eval_time);
 
-		XSI::CString distribution = get_string_parameter_value(xsi_parameters, "Distribution", eval_time);
-		XSI::CString ssmethod = get_string_parameter_value(xsi_parameters, "subsurface_method", eval_time);
-		float radiusx = get_float_parameter_value(xsi_parameters, "RadiusX", eval_time);
-		float radiusy = get_float_parameter_value(xsi_parameters, "RadiusY", eval_time);
-		float radiusz = get_float_parameter_value(xsi_parameters, "RadiusZ", eval_time);
+	node->set_ior(ccl::make_float3(ior_x, ior_y, ior_z));
+	node->set_k(ccl::make_float3(extinction_x, extinction_y, extinction_z));
 
-		node->set_distribution(get_distribution(distribution, DistributionModes_Principle));
-		node->set_subsurface_method(get_subsurface_method(ssmethod));
-		node->set_subsurface_radius(ccl::make_float3(radiusx, radiusy, radiusz));
+	node->set_distribution(get_distribution(distribution, DistributionModes_Glass));
+	node->set_fresnel_type(get_metallic_fresnel(fresnel_type));
 
-		return node;
-	}
-	else if (shader_type == "TranslucentBSDF")
-	{
-		ccl::TranslucentBsdfNode* node = shader_graph->create_node<ccl::TranslucentBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-		return node;
-	}
-	else if (shader_type == "TransparentBSDF")
-	{
-		ccl::TransparentBsdfNode* node = shader_graph->create_node<ccl::TransparentBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-		return node;
-	}
-	else if (shader_type == "ToonBSDF")
-	{
-		ccl::ToonBsdfNode* node = shader_graph->create_node<ccl::ToonBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		XSI::CString component = get_string_parameter_value(xsi_parameters, "Component", eval_time);
-		node->set_component(get_distribution(component, DistributionModes_Toon));
+ccl::ShaderNode* sync_cycles_principled_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::PrincipledBsdfNode* node = shader_graph->create_node<ccl::PrincipledBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "GlossyBSDF")
-	{
-		ccl::GlossyBsdfNode* node = shader_graph->create_node<ccl::GlossyBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString distribution = get_string_parameter_value(xsi_parameters, "Distribution", eval_time);
+	XSI::CString ssmethod = get_string_parameter_value(xsi_parameters, "subsurface_method", eval_time);
+	float radiusx = get_float_parameter_value(xsi_parameters, "RadiusX", eval_time);
+	float radiusy = get_float_parameter_value(xsi_parameters, "RadiusY", eval_time);
+	float radiusz = get_float_parameter_value(xsi_parameters, "RadiusZ", eval_time);
 
-		XSI::CString distribution = get_string_parameter_value(xsi_parameters, "Distribution", eval_time);
-		node->set_distribution(get_distribution(distribution, DistributionModes_Glossy));
+	node->set_distribution(get_distribution(distribution, DistributionModes_Principle));
+	node->set_subsurface_method(get_subsurface_method(ssmethod));
+	node->set_subsurface_radius(ccl::make_float3(radiusx, radiusy, radiusz));
 
-		return node;
-	}
-	else if (shader_type == "GlassBSDF")
-	{
-		ccl::GlassBsdfNode* node = shader_graph->create_node<ccl::GlassBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		XSI::CString distribution = get_string_parameter_value(xsi_parameters, "Distribution", eval_time);
-		node->set_distribution(get_distribution(distribution, DistributionModes_Glass));
+ccl::ShaderNode* sync_cycles_translucent_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::TranslucentBsdfNode* node = shader_graph->create_node<ccl::TranslucentBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "RefractionBSDF")
-	{
-		ccl::RefractionBsdfNode* node = shader_graph->create_node<ccl::RefractionBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_transparent_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::TransparentBsdfNode* node = shader_graph->create_node<ccl::TransparentBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		XSI::CString distribution = get_string_parameter_value(xsi_parameters, "Distribution", eval_time);
-		node->set_distribution(get_distribution(distribution, DistributionModes_Refraction));
+ccl::ShaderNode* sync_cycles_toon_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::ToonBsdfNode* node = shader_graph->create_node<ccl::ToonBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "HairBSDF")
-	{
-		ccl::HairBsdfNode* node = shader_graph->create_node<ccl::HairBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString component = get_string_parameter_value(xsi_parameters, "Component", eval_time);
+	node->set_component(get_distribution(component, DistributionModes_Toon));
 
-		XSI::CString component = get_string_parameter_value(xsi_parameters, "Component", eval_time);
-		node->set_component(get_distribution(component, DistributionModes_Hair));
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "Emission")
-	{
-		ccl::EmissionNode* node = shader_graph->create_node<ccl::EmissionNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_glossy_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::GlossyBsdfNode* node = shader_graph->create_node<ccl::GlossyBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "AmbientOcclusion")
-	{
-		ccl::AmbientOcclusionNode* node = shader_graph->create_node<ccl::AmbientOcclusionNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString distribution = get_string_parameter_value(xsi_parameters, "Distribution", eval_time);
+	node->set_distribution(get_distribution(distribution, DistributionModes_Glossy));
 
-		int samples = get_int_parameter_value(xsi_parameters, "Samples", eval_time);
-		bool inside = get_bool_parameter_value(xsi_parameters, "Inside", eval_time);
-		bool local = get_bool_parameter_value(xsi_parameters, "OnlyLocal", eval_time);
+	return node;
+}
 
-		node->set_samples(samples);
-		node->set_inside(inside);
-		node->set_only_local(local);
+ccl::ShaderNode* sync_cycles_glass_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::GlassBsdfNode* node = shader_graph->create_node<ccl::GlassBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "Background")
-	{
-		ccl::BackgroundNode* node = shader_graph->create_node<ccl::BackgroundNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString distribution = get_string_parameter_value(xsi_parameters, "Distribution", eval_time);
+	node->set_distribution(get_distribution(distribution, DistributionModes_Glass));
 
-		return node;
-	}
-	else if (shader_type == "Holdout")
-	{
-		ccl::HoldoutNode* node = shader_graph->create_node<ccl::HoldoutNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "AbsorptionVolume")
-	{
-		ccl::AbsorptionVolumeNode* node = shader_graph->create_node<ccl::AbsorptionVolumeNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_refraction_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::RefractionBsdfNode* node = shader_graph->create_node<ccl::RefractionBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "ScatterVolume")
-	{
-		ccl::ScatterVolumeNode* node = shader_graph->create_node<ccl::ScatterVolumeNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString distribution = get_string_parameter_value(xsi_parameters, "Distribution", eval_time);
+	node->set_distribution(get_distribution(distribution, DistributionModes_Refraction));
 
-		XSI::CString phase = get_string_parameter_value(xsi_parameters, "phase", eval_time);
-		node->set_phase(get_scatter_phase(phase));
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "PrincipledVolume")
-	{
-		ccl::PrincipledVolumeNode* node = shader_graph->create_node<ccl::PrincipledVolumeNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_hair_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::HairBsdfNode* node = shader_graph->create_node<ccl::HairBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString density_attribute = get_string_parameter_value(xsi_parameters, "DensityAttribute", eval_time);
-		XSI::CString color_attribute = get_string_parameter_value(xsi_parameters, "ColorAttribute", eval_time);
-		XSI::CString temperature_attribute = get_string_parameter_value(xsi_parameters, "TemperatureAttribute", eval_time);
+	XSI::CString component = get_string_parameter_value(xsi_parameters, "Component", eval_time);
+	node->set_component(get_distribution(component, DistributionModes_Hair));
 
-		node->set_density_attribute(ccl::ustring(density_attribute.GetAsciiString()));
-		node->set_color_attribute(ccl::ustring(color_attribute.GetAsciiString()));
-		node->set_temperature_attribute(ccl::ustring(temperature_attribute.GetAsciiString()));
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "PrincipledHairBSDF")
-	{
-		ccl::PrincipledHairBsdfNode* node = shader_graph->create_node<ccl::PrincipledHairBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_emission(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::EmissionNode* node = shader_graph->create_node<ccl::EmissionNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString parameterization = get_string_parameter_value(xsi_parameters, "Parametrization", eval_time);
-		XSI::CString model = get_string_parameter_value(xsi_parameters, "Model", eval_time);
-		float abs_x = get_float_parameter_value(xsi_parameters, "AbsorptionCoefficientX", eval_time);
-		float abs_y = get_float_parameter_value(xsi_parameters, "AbsorptionCoefficientY", eval_time);
-		float abs_z = get_float_parameter_value(xsi_parameters, "AbsorptionCoefficientZ", eval_time);
+	return node;
+}
 
-		node->set_parametrization(principled_hair_parametrization(parameterization));
-		node->set_model(principled_hair_model(model));  // TODO: may be the method is named in another way
-		node->set_absorption_coefficient(ccl::make_float3(abs_x, abs_y, abs_z));
+ccl::ShaderNode* sync_cycles_ambient_occlusion(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::AmbientOcclusionNode* node = shader_graph->create_node<ccl::AmbientOcclusionNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "SheenBSDF")
-	{
-		ccl::SheenBsdfNode* node = shader_graph->create_node<ccl::SheenBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	int samples = get_int_parameter_value(xsi_parameters, "Samples", eval_time);
+	bool inside = get_bool_parameter_value(xsi_parameters, "Inside", eval_time);
+	bool local = get_bool_parameter_value(xsi_parameters, "OnlyLocal", eval_time);
 
-		XSI::CString distributeion = get_string_parameter_value(xsi_parameters, "distribution", eval_time);
-		node->set_distribution(sheen_distribution(distributeion));
+	node->set_samples(samples);
+	node->set_inside(inside);
+	node->set_only_local(local);
 
-		return node;
-	}
-	else if (shader_type == "RayPortalBSDF")
-	{
-		ccl::RayPortalBsdfNode* node = shader_graph->create_node<ccl::RayPortalBsdfNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "SubsurfaceScattering")
-	{
-		ccl::SubsurfaceScatteringNode* node = shader_graph->create_node<ccl::SubsurfaceScatteringNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_background(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::BackgroundNode* node = shader_graph->create_node<ccl::BackgroundNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString falloff = get_string_parameter_value(xsi_parameters, "Falloff", eval_time);
-		float radius_x = get_float_parameter_value(xsi_parameters, "RadiusX", eval_time);
-		float radius_y = get_float_parameter_value(xsi_parameters, "RadiusY", eval_time);
-		float radius_z = get_float_parameter_value(xsi_parameters, "RadiusZ", eval_time);
+	return node;
+}
 
-		if (falloff == "random_walk")
-		{
-			node->set_method(ccl::CLOSURE_BSSRDF_RANDOM_WALK_ID);
-		}
-		else if (falloff == "random_walk_fixed")
-		{
-			node->set_method(ccl::CLOSURE_BSSRDF_RANDOM_WALK_SKIN_ID);
-		}
-		else
-		{
-			node->set_method(ccl::CLOSURE_BSSRDF_BURLEY_ID);
-		}
-		node->set_radius(ccl::make_float3(radius_x, radius_y, radius_z));
+ccl::ShaderNode* sync_cycles_holdout(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::HoldoutNode* node = shader_graph->create_node<ccl::HoldoutNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "ImageTexture")
-	{
-		ccl::ImageTextureNode* node = shader_graph->create_node<ccl::ImageTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		XSI::ImageClip2 clip = get_clip_parameter_value(xsi_parameters, "image", eval_time);
-		XSI::CString file_path = "";
-		XSI::CString color_space = get_string_parameter_value(xsi_parameters, "ColorSpace", eval_time);
-		XSI::CString interpolation = get_string_parameter_value(xsi_parameters, "Interpolation", eval_time);
-		XSI::CString projection = get_string_parameter_value(xsi_parameters, "Projection", eval_time);
-		float projection_blend = get_float_parameter_value(xsi_parameters, "ProjectionBlend", eval_time);
-		XSI::CString extension = get_string_parameter_value(xsi_parameters, "Extension", eval_time);
-		bool premultiply_alpha = get_bool_parameter_value(xsi_parameters, "premultiply_alpha", eval_time);
-		XSI::CString image_source = get_string_parameter_value(xsi_parameters, "ImageSource", eval_time);
-		
-		int image_frames = get_int_parameter_value(xsi_parameters, "ImageFrames", eval_time);
-		int start_frame = get_int_parameter_value(xsi_parameters, "ImageStartFrame", eval_time);
-		int offset = get_int_parameter_value(xsi_parameters, "ImageOffset", eval_time);
-		bool cyclic = get_bool_parameter_value(xsi_parameters, "ImageCyclic", eval_time);
-
-		if (clip.IsValid())
-		{
-			file_path = clip.GetFileName();
-			if (image_source == "image_sequence") {
-				// change file path for image sequence mode
-				file_path = sync_image_file(file_path, image_frames, start_frame, offset, cyclic, eval_time);
-				clip = XSI::ImageClip2();
-			}
+	return node;
+}
 
-			ccl::ustring selected_colorscape = color_space == "color" ? ccl::u_colorspace_srgb : ccl::u_colorspace_raw;
+ccl::ShaderNode* sync_cycles_absorption_volume(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::AbsorptionVolumeNode* node = shader_graph->create_node<ccl::AbsorptionVolumeNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-			// we add each clip separately (without caching in update context)
-			// because one clip in different materials can have different effects (crop, blur and so on)
-			// so, we should use different images
-			// get tiles
-			std::map<int, XSI::CString> tile_to_path_map = sync_image_tiles(file_path);
-			ccl::array<int> tiles = exctract_tiles(tile_to_path_map);
+	return node;
+}
 
-			// set node parameters before loader, because it use these parameters for define alpha
-			node->set_colorspace(selected_colorscape);
-			node->set_projection(projection == "flat" ? ccl::NodeImageProjection::NODE_IMAGE_PROJ_FLAT : (projection == "box" ? ccl::NodeImageProjection::NODE_IMAGE_PROJ_BOX : (projection == "sphere" ? ccl::NodeImageProjection::NODE_IMAGE_PROJ_SPHERE : (projection == "tube" ? ccl::NodeImageProjection::NODE_IMAGE_PROJ_TUBE : ccl::NodeImageProjection::NODE_IMAGE_PROJ_FLAT))));
-			node->set_projection_blend(projection_blend);
-			node->set_interpolation(interpolation == "Smart" ? ccl::InterpolationType::INTERPOLATION_SMART : (interpolation == "Cubic" ? ccl::InterpolationType::INTERPOLATION_CUBIC : (interpolation == "Closest" ? ccl::InterpolationType::INTERPOLATION_CLOSEST : ccl::InterpolationType::INTERPOLATION_LINEAR)));
-			node->set_extension(extension == "Clip" ? ccl::ExtensionType::EXTENSION_CLIP : (extension == "Extend" ? ccl::ExtensionType::EXTENSION_EXTEND : ccl::ExtensionType::EXTENSION_REPEAT));
+ccl::ShaderNode* sync_cycles_scatter_volume(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::ScatterVolumeNode* node = shader_graph->create_node<ccl::ScatterVolumeNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-			node->set_alpha_type(premultiply_alpha ? ccl::ImageAlphaType::IMAGE_ALPHA_ASSOCIATED : ccl::ImageAlphaType::IMAGE_ALPHA_CHANNEL_PACKED);
-			node->set_animated(false);
+	XSI::CString phase = get_string_parameter_value(xsi_parameters, "phase", eval_time);
+	node->set_phase(get_scatter_phase(phase));
 
-			if(image_source == "tiled")
-			{
-				// we should create array of loaders
-				ccl::vector<std::unique_ptr<ccl::ImageLoader>> loaders;
-				loaders.reserve(tiles.size());
-				for (size_t i = 0; i < tiles.size(); i++)
-				{
-					int tile_value = tiles[i];
-					XSI::CString tile_path = tile_to_path_map[tile_value];
-					if (tile_path != file_path)
-					{
-						loaders.push_back(std::make_unique<XSIImageLoader>(clip, selected_colorscape, tile_value, tile_path, eval_time));
-					}
-					else
-					{
-						loaders.push_back(std::make_unique<XSIImageLoader>(clip, selected_colorscape, tile_value, "", eval_time));
-					}
-				}
+	return node;
+}
 
-				node->handle = scene->image_manager->add_image(std::move(loaders), node->image_params());
-			}
-			else
-			{
-				XSIImageLoader* image_loader = new XSIImageLoader(clip, selected_colorscape, 0, image_source == "image_sequence" ? file_path : "", eval_time);
-				node->handle = scene->image_manager->add_image(std::unique_ptr<ccl::ImageLoader>(image_loader), node->image_params());
-			}
+ccl::ShaderNode* sync_cycles_principled_volume(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::PrincipledVolumeNode* node = shader_graph->create_node<ccl::PrincipledVolumeNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-			node->set_tiles(tiles);
+	XSI::CString density_attribute = get_string_parameter_value(xsi_parameters, "DensityAttribute", eval_time);
+	XSI::CString color_attribute = get_string_parameter_value(xsi_parameters, "ColorAttribute", eval_time);
+	XSI::CString temperature_attribute = get_string_parameter_value(xsi_parameters, "TemperatureAttribute", eval_time);
 
-			return node;
-		}
-		else
-		{
-			return NULL;
-		}
-	}
-	else if (shader_type == "EnvironmentTexture")
-	{
-		ccl::EnvironmentTextureNode* node = shader_graph->create_node<ccl::EnvironmentTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	node->set_density_attribute(ccl::ustring(density_attribute.GetAsciiString()));
+	node->set_color_attribute(ccl::ustring(color_attribute.GetAsciiString()));
+	node->set_temperature_attribute(ccl::ustring(temperature_attribute.GetAsciiString()));
 
-		node->tex_mapping.rotation = ccl::make_float3(-0.5f * XSI::MATH::PI, 0.0f, 0.0f);
+	return node;
+}
 
-		XSI::ImageClip2 clip = get_clip_parameter_value(xsi_parameters, "image", eval_time);
-		XSI::CString file_path = "";
+ccl::ShaderNode* sync_cycles_principled_hair_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::PrincipledHairBsdfNode* node = shader_graph->create_node<ccl::PrincipledHairBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString color_space = get_string_parameter_value(xsi_parameters, "ColorSpace", eval_time);
-		XSI::CString interpolation = get_string_parameter_value(xsi_parameters, "Interpolation", eval_time);
-		XSI::CString projection = get_string_parameter_value(xsi_parameters, "Projection", eval_time);
-		bool premultiply_alpha = get_bool_parameter_value(xsi_parameters, "premultiply_alpha", eval_time);
+	XSI::CString parameterization = get_string_parameter_value(xsi_parameters, "Parametrization", eval_time);
+	XSI::CString model = get_string_parameter_value(xsi_parameters, "Model", eval_time);
+	float abs_x = get_float_parameter_value(xsi_parameters, "AbsorptionCoefficientX", eval_time);
+	float abs_y = get_float_parameter_value(xsi_parameters, "AbsorptionCoefficientY", eval_time);
+	float abs_z = get_float_parameter_value(xsi_parameters, "AbsorptionCoefficientZ", eval_time);
 
-		XSI::CString image_source = get_string_parameter_value(xsi_parameters, "ImageSource", eval_time);
-		int image_frames = get_int_parameter_value(xsi_parameters, "ImageFrames", eval_time);
-		int start_frame = get_int_parameter_value(xsi_parameters, "ImageStartFrame", eval_time);
-		int offset = get_int_parameter_value(xsi_parameters, "ImageOffset", eval_time);
-		bool cyclic = get_bool_parameter_value(xsi_parameters, "ImageCyclic", eval_time);
+	node->set_parametrization(principled_hair_parametrization(parameterization));
+	node->set_model(principled_hair_model(model));  // TODO: may be the method is named in another way
+	node->set_absorption_coefficient(ccl::make_float3(abs_x, abs_y, abs_z));
 
-		if (clip.IsValid())
-		{
-			file_path = clip.GetFileName();
-			if (image_source == "image_sequence") {
-				// change file path for image sequence mode
-				file_path = sync_image_file(file_path, image_frames, start_frame, offset, cyclic, eval_time);
-				clip = XSI::ImageClip2();
-			}
+	return node;
+}
 
-			bool temp_flag = false;
-			std::string filename = build_source_image_path(file_path, image_source, cyclic, start_frame, image_frames, offset, eval_time, false, temp_flag);
-			ccl::ustring selected_colorscape = color_space == "color" ? ccl::u_colorspace_srgb : ccl::u_colorspace_raw;
+ccl::ShaderNode* sync_cycles_sheen_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::SheenBsdfNode* node = shader_graph->create_node<ccl::SheenBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-			node->set_colorspace(selected_colorscape);
-			node->set_interpolation(interpolation == "Smart" ? ccl::InterpolationType::INTERPOLATION_SMART : (interpolation == "Cubic" ? ccl::InterpolationType::INTERPOLATION_CUBIC : (interpolation == "Closest" ? ccl::InterpolationType::INTERPOLATION_CLOSEST : ccl::InterpolationType::INTERPOLATION_LINEAR)));
-			node->set_projection(projection == "equirectangular" ? ccl::NodeEnvironmentProjection::NODE_ENVIRONMENT_EQUIRECTANGULAR : (projection == "mirrorball" ? ccl::NodeEnvironmentProjection::NODE_ENVIRONMENT_MIRROR_BALL : ccl::NodeEnvironmentProjection::NODE_ENVIRONMENT_EQUIRECTANGULAR));
-			node->set_alpha_type(premultiply_alpha ? ccl::ImageAlphaType::IMAGE_ALPHA_ASSOCIATED : ccl::ImageAlphaType::IMAGE_ALPHA_CHANNEL_PACKED);
+	XSI::CString distributeion = get_string_parameter_value(xsi_parameters, "distribution", eval_time);
+	node->set_distribution(sheen_distribution(distributeion));
 
-			XSIImageLoader* image_loader = new XSIImageLoader(clip, selected_colorscape, 0, image_source == "image_sequence" ? file_path : "", eval_time);
-			node->handle = scene->image_manager->add_image(std::unique_ptr<ccl::ImageLoader>(image_loader), node->image_params());
+	return node;
+}
 
-			return node;
-		}
-		else
-		{
-			return NULL;
-		}
-	}
-	else if (shader_type == "SkyTexture")
-	{
-		ccl::SkyTextureNode* node = shader_graph->create_node<ccl::SkyTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		float sun_direction_x = get_float_parameter_value(xsi_parameters, "SunDirectionX", eval_time);
-		float sun_direction_y = get_float_parameter_value(xsi_parameters, "SunDirectionY", eval_time);
-		float sun_direction_z = get_float_parameter_value(xsi_parameters, "SunDirectionZ", eval_time);
-		float turbidity = get_float_parameter_value(xsi_parameters, "Turbidity", eval_time);
-		float ground_albedo = get_float_parameter_value(xsi_parameters, "GroundAlbedo", eval_time);
-		float sun_size = get_float_parameter_value(xsi_parameters, "SunSize", eval_time) * XSI::MATH::PI / 180.0;
-		float sun_intensity = get_float_parameter_value(xsi_parameters, "SunIntensity", eval_time);
-		float sun_elevation = get_float_parameter_value(xsi_parameters, "SunElevation", eval_time) * XSI::MATH::PI / 180.0f;
-		float sun_rotation = get_float_parameter_value(xsi_parameters, "SunRotation", eval_time) * XSI::MATH::PI / 180.0f;
-		float altitude = get_float_parameter_value(xsi_parameters, "Altitude", eval_time);
-		float air = get_float_parameter_value(xsi_parameters, "Air", eval_time);
-		float dust = get_float_parameter_value(xsi_parameters, "Dust", eval_time);
-		float ozone = get_float_parameter_value(xsi_parameters, "Ozone", eval_time);
-		bool sun_disc = get_bool_parameter_value(xsi_parameters, "SunDisc", eval_time);
-
-		float sun_x;
-		float sun_y;
-		float sun_z;
-		bool is_subsun = obtain_subsub_directions(xsi_shader, sun_x, sun_y, sun_z, eval_time);
-
-		float dirSquare = sun_direction_x * sun_direction_x + sun_direction_y * sun_direction_y + sun_direction_z * sun_direction_z;
-		if (dirSquare > 0.01)
-		{// normalize direction
-			float s = sqrtf(dirSquare);
-			sun_direction_x = sun_direction_x / s;
-			sun_direction_y = sun_direction_y / s;
-			sun_direction_z = sun_direction_z / s;
-		}
-		// apply shift transformation to sun direction
-		float dx = sun_direction_x;
-		float dy = -1 * sun_direction_z;
-		float dz = sun_direction_y;
-
-		node->tex_mapping.rotation = ccl::make_float3(-0.5 * XSI::MATH::PI, 0, 0);
-		node->set_sky_type(type == "preetham" ? ccl::NodeSkyType::NODE_SKY_PREETHAM : (type == "hosekwilkil" ? ccl::NodeSkyType::NODE_SKY_HOSEK : ccl::NodeSkyType::NODE_SKY_NISHITA));
-		if (is_subsun)
-		{
-			node->set_sun_direction(ccl::make_float3(sun_x, -1 * sun_z, sun_y));
-			float a_sin_z = std::asin(sun_z);
-			float xz_length = sqrtf(sun_x * sun_x + sun_z * sun_z);
-			sun_x = sun_x / xz_length;
-			sun_rotation = a_sin_z > 0 ? -std::asin(sun_x) + XSI::MATH::PI : asin(sun_x);
-			sun_elevation = std::asin(sun_y);
-		}
-		else
-		{
-			node->set_sun_direction(ccl::make_float3(dx, dy, dz));
-		}
+ccl::ShaderNode* sync_cycles_ray_portal_bsdf(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::RayPortalBsdfNode* node = shader_graph->create_node<ccl::RayPortalBsdfNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		node->set_turbidity(turbidity);
-		node->set_ground_albedo(ground_albedo);
+	return node;
+}
 
-		node->set_sun_disc(sun_disc);
-		node->set_sun_size(sun_size);
-		node->set_sun_intensity(sun_intensity);
-		node->set_sun_elevation(sun_elevation);
-		node->set_sun_rotation(sun_rotation);
-		node->set_altitude(altitude);
-		node->set_air_density(air);
-		node->set_dust_density(dust);
-		node->set_ozone_density(ozone);
+ccl::ShaderNode* sync_cycles_subsurface_scattering(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::SubsurfaceScatteringNode* node = shader_graph->create_node<ccl::SubsurfaceScatteringNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
+	XSI::CString falloff = get_string_parameter_value(xsi_parameters, "Falloff", eval_time);
+	float radius_x = get_float_parameter_value(xsi_parameters, "RadiusX", eval_time);
+	float radius_y = get_float_parameter_value(xsi_parameters, "RadiusY", eval_time);
+	float radius_z = get_float_parameter_value(xsi_parameters, "RadiusZ", eval_time);
 
-	}
-	else if (shader_type == "NoiseTexture")
+	if (falloff == "random_walk")
 	{
-		ccl::NoiseTextureNode* node = shader_graph->create_node<ccl::NoiseTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		XSI::CString noise_dimensions = get_string_parameter_value(xsi_parameters, "NoiseDimensions", eval_time);
-		node->set_dimensions(get_dimensions_type(noise_dimensions));
-		XSI::CString noise_type = get_string_parameter_value(xsi_parameters, "type", eval_time);
-		node->set_type(get_noise_type(noise_type));
-		bool normalize = get_bool_parameter_value(xsi_parameters, "normalize", eval_time);
-		node->set_use_normalize(normalize);
-
-		return node;
+		node->set_method(ccl::CLOSURE_BSSRDF_RANDOM_WALK_ID);
 	}
-	else if (shader_type == "CheckerTexture")
+	else if (falloff == "random_walk_fixed")
 	{
-		ccl::CheckerTextureNode* node = shader_graph->create_node<ccl::CheckerTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		return node;
+		node->set_method(ccl::CLOSURE_BSSRDF_RANDOM_WALK_SKIN_ID);
 	}
-	else if (shader_type == "BrickTexture")
+	else
 	{
-		ccl::BrickTextureNode* node = shader_graph->create_node<ccl::BrickTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		float offset = get_float_parameter_value(xsi_parameters, "Offset", eval_time);
-		int offset_frequency = get_int_parameter_value(xsi_parameters, "OffsetFrequency", eval_time);
-		float squash = get_float_parameter_value(xsi_parameters, "Squash", eval_time);
-		int squash_frequency = get_int_parameter_value(xsi_parameters, "SquashFrequency", eval_time);
-		node->set_offset(offset);
-		node->set_offset_frequency(offset_frequency);
-		node->set_squash(squash);
-		node->set_squash_frequency(squash_frequency);
-
-		return node;
+		node->set_method(ccl::CLOSURE_BSSRDF_BURLEY_ID);
 	}
-	else if (shader_type == "GradientTexture")
-	{
-		ccl::GradientTextureNode* node = shader_graph->create_node<ccl::GradientTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	node->set_radius(ccl::make_float3(radius_x, radius_y, radius_z));
 
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		node->set_gradient_type(get_gradient_type(type));
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "VoronoiTexture")
-	{
-		ccl::VoronoiTextureNode* node = shader_graph->create_node<ccl::VoronoiTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		XSI::CString dimensions = get_string_parameter_value(xsi_parameters, "VoronoiDimensions", eval_time);
-		XSI::CString distance = get_string_parameter_value(xsi_parameters, "Distance", eval_time);
-		XSI::CString feature = get_string_parameter_value(xsi_parameters, "Feature", eval_time);
-		bool normalize = get_bool_parameter_value(xsi_parameters, "normalize", eval_time);
-		node->set_dimensions(get_dimensions_type(dimensions));
-		node->set_metric(voronoi_distance(distance));
-		node->set_feature(voronoi_feature(feature));
-		node->set_use_normalize(normalize);
+ccl::ShaderNode* sync_cycles_image_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::ImageTextureNode* node = shader_graph->create_node<ccl::ImageTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::ImageClip2 clip = get_clip_parameter_value(xsi_parameters, "image", eval_time);
+	XSI::CString file_path = "";
+	XSI::CString color_space = get_string_parameter_value(xsi_parameters, "ColorSpace", eval_time);
+	XSI::CString interpolation = get_string_parameter_value(xsi_parameters, "Interpolation", eval_time);
+	XSI::CString projection = get_string_parameter_value(xsi_parameters, "Projection", eval_time);
+	float projection_blend = get_float_parameter_value(xsi_parameters, "ProjectionBlend", eval_time);
+	XSI::CString extension = get_string_parameter_value(xsi_parameters, "Extension", eval_time);
+	bool premultiply_alpha = get_bool_parameter_value(xsi_parameters, "premultiply_alpha", eval_time);
+	XSI::CString image_source = get_string_parameter_value(xsi_parameters, "ImageSource", eval_time);
+	
+	int image_frames = get_int_parameter_value(xsi_parameters, "ImageFrames", eval_time);
+	int start_frame = get_int_parameter_value(xsi_parameters, "ImageStartFrame", eval_time);
+	int offset = get_int_parameter_value(xsi_parameters, "ImageOffset", eval_time);
+	bool cyclic = get_bool_parameter_value(xsi_parameters, "ImageCyclic", eval_time);
+
+	if (clip.IsValid())
+	{
+		file_path = clip.GetFileName();
+		if (image_source == "image_sequence") {
+			// change file path for image sequence mode
+			XSI::CString clip_path = file_path;
+			file_path = sync_image_file(clip_path, image_frames, start_frame, offset, cyclic, eval_time);
+			clip = XSI::ImageClip2();
+
+			// start to decode the image for the next frame, it will be ready when this frame is rendered
+			XSI::CString next_file_path = sync_image_file(clip_path, image_frames, start_frame, offset, cyclic, get_next_frame_time(eval_time));
+			if (next_file_path != file_path)
+			{
+				prefetch_image_file(next_file_path, color_space == "color");
+			}
+		}
 
-		return node;
-	}
-	else if (shader_type == "MagicTexture")
-	{
-		ccl::MagicTextureNode* node = shader_graph->create_node<ccl::MagicTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+		ccl::ustring selected_colorscape = color_space == "color" ? ccl::u_colorspace_srgb : ccl::u_colorspace_raw;
 
-		int depth = get_int_parameter_value(xsi_parameters, "Depth", eval_time);
-		node->set_depth(depth);
+		// we add each clip separately (without caching in update context)
+		// because one clip in different materials can have different effects (crop, blur and so on)
+		// so, we should use different images
+		// get tiles
+		std::map<int, XSI::CString> tile_to_path_map = sync_image_tiles(file_path);
+		ccl::array<int> tiles = exctract_tiles(tile_to_path_map);
 
-		return node;
-	}
-	else if (shader_type == "WaveTexture")
-	{
-		ccl::WaveTextureNode* node = shader_graph->create_node<ccl::WaveTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		XSI::CString bands_direction = get_string_parameter_value(xsi_parameters, "bands_direction", eval_time);
-		XSI::CString rings_direction = get_string_parameter_value(xsi_parameters, "rings_direction", eval_time);
-		XSI::CString profile = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		node->set_wave_type(get_wave_type(type));
-		node->set_profile(get_wave_profile(profile));
-		node->set_bands_direction(get_wave_bands_direction(bands_direction));
-		node->set_rings_direction(get_wave_rings_direction(rings_direction));
+		// set node parameters before loader, because it use these parameters for define alpha
+		node->set_colorspace(selected_colorscape);
+		node->set_projection(projection == "flat" ? ccl::NodeImageProjection::NODE_IMAGE_PROJ_FLAT : (projection == "box" ? ccl::NodeImageProjection::NODE_IMAGE_PROJ_BOX : (projection == "sphere" ? ccl::NodeImageProjection::NODE_IMAGE_PROJ_SPHERE : (projection == "tube" ? ccl::NodeImageProjection::NODE_IMAGE_PROJ_TUBE : ccl::NodeImageProjection::NODE_IMAGE_PROJ_FLAT))));
+		node->set_projection_blend(projection_blend);
+		node->set_interpolation(interpolation == "Smart" ? ccl::InterpolationType::INTERPOLATION_SMART : (interpolation == "Cubic" ? ccl::InterpolationType::INTERPOLATION_CUBIC : (interpolation == "Closest" ? ccl::InterpolationType::INTERPOLATION_CLOSEST : ccl::InterpolationType::INTERPOLATION_LINEAR)));
+		node->set_extension(extension == "Clip" ? ccl::ExtensionType::EXTENSION_CLIP : (extension == "Extend" ? ccl::ExtensionType::EXTENSION_EXTEND : ccl::ExtensionType::EXTENSION_REPEAT));
 
-		return node;
-	}
-	else if (shader_type == "IESTexture")
-	{
-		ccl::IESLightNode* node = shader_graph->create_node<ccl::IESLightNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+		node->set_alpha_type(premultiply_alpha ? ccl::ImageAlphaType::IMAGE_ALPHA_ASSOCIATED : ccl::ImageAlphaType::IMAGE_ALPHA_CHANNEL_PACKED);
+		node->set_animated(false);
 
-		XSI::CString file_path = get_string_parameter_value(xsi_parameters, "FilePath", eval_time);
-		if (file_path.Length() > 0 && !XSI::CUtils::IsAbsolutePath(file_path))
-		{
-			file_path = XSI::CUtils::ResolvePath(XSI::CUtils::BuildPath(get_project_path(), file_path));
-		}
-		if (file_path.Length() > 0)
+		if(image_source == "tiled")
 		{
-			node->set_filename(OIIO::ustring(file_path.GetAsciiString()));
+			// we should create array of loaders
+			ccl::vector<std::unique_ptr<ccl::ImageLoader>> loaders;
+			loaders.reserve(tiles.size());
+			for (size_t i = 0; i < tiles.size(); i++)
+			{
+				int tile_value = tiles[i];
+				XSI::CString tile_path = tile_to_path_map[tile_value];
+				if (tile_path != file_path)
+				{
+					loaders.push_back(std::make_unique<XSIImageLoader>(clip, selected_colorscape, tile_value, tile_path, eval_time));
+				}
+				else
+				{
+					loaders.push_back(std::make_unique<XSIImageLoader>(clip, selected_colorscape, tile_value, "", eval_time));
+				}
+			}
+
+			node->handle = scene->image_manager->add_image(std::move(loaders), node->image_params());
 		}
 		else
 		{
-			return NULL;
+			XSIImageLoader* image_loader = new XSIImageLoader(clip, selected_colorscape, 0, image_source == "image_sequence" ? file_path : "", eval_time);
+			node->handle = scene->image_manager->add_image(std::unique_ptr<ccl::ImageLoader>(image_loader), node->image_params());
 		}
 
+		node->set_tiles(tiles);
+
 		return node;
 	}
-	else if (shader_type == "WhiteNoiseTexture")
+	else
 	{
-		ccl::WhiteNoiseTextureNode* node = shader_graph->create_node<ccl::WhiteNoiseTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+		return NULL;
+	}
+}
 
-		XSI::CString dimensions = get_string_parameter_value(xsi_parameters, "NoiseDimensions", eval_time);
-		float vector_x = get_float_parameter_value(xsi_parameters, "VectorX", eval_time);
-		float vector_y = get_float_parameter_value(xsi_parameters, "VectorY", eval_time);
-		float vector_z = get_float_parameter_value(xsi_parameters, "VectorZ", eval_time);
+ccl::ShaderNode* sync_cycles_environment_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::EnvironmentTextureNode* node = shader_graph->create_node<ccl::EnvironmentTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		node->set_dimensions(get_dimensions_type(dimensions));
-		node->set_vector(ccl::make_float3(vector_x, vector_y, vector_z));
+	node->tex_mapping.rotation = ccl::make_float3(-0.5f * XSI::MATH::PI, 0.0f, 0.0f);
 
-		return node;
-	}
-	else if (shader_type == "GaborTexture")
-	{
-		ccl::GaborTextureNode* node = shader_graph->create_node<ccl::GaborTextureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-		XSI::CString gabor_type = get_string_parameter_value(xsi_parameters, "gabor_type", eval_time);
-		float orientation_3d_x = get_float_parameter_value(xsi_parameters, "orientation_3d_x", eval_time);
-		float orientation_3d_y = get_float_parameter_value(xsi_parameters, "orientation_3d_y", eval_time);
-		float orientation_3d_z = get_float_parameter_value(xsi_parameters, "orientation_3d_z", eval_time);
+	XSI::ImageClip2 clip = get_clip_parameter_value(xsi_parameters, "image", eval_time);
+	XSI::CString file_path = "";
 
-		node->set_type(get_gabor_type(gabor_type));
-		node->set_orientation_3d(ccl::make_float3(orientation_3d_x, orientation_3d_y, orientation_3d_z));
+	XSI::CString color_space = get_string_parameter_value(xsi_parameters, "ColorSpace", eval_time);
+	XSI::CString interpolation = get_string_parameter_value(xsi_parameters, "Interpolation", eval_time);
+	XSI::CString projection = get_string_parameter_value(xsi_parameters, "Projection", eval_time);
+	bool premultiply_alpha = get_bool_parameter_value(xsi_parameters, "premultiply_alpha", eval_time);
 
-		return node;
-	}
-	else if (shader_type == "Normal")
+	XSI::CString image_source = get_string_parameter_value(xsi_parameters, "ImageSource", eval_time);
+	int image_frames = get_int_parameter_value(xsi_parameters, "ImageFrames", eval_time);
+	int start_frame = get_int_parameter_value(xsi_parameters, "ImageStartFrame", eval_time);
+	int offset = get_int_parameter_value(xsi_parameters, "ImageOffset", eval_time);
+	bool cyclic = get_bool_parameter_value(xsi_parameters, "ImageCyclic", eval_time);
+
+	if (clip.IsValid())
 	{
-		ccl::NormalNode* node = shader_graph->create_node<ccl::NormalNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+		file_path = clip.GetFileName();
+		if (image_source == "image_sequence") {
+			// change file path for image sequence mode
+			XSI::CString clip_path = file_path;
+			file_path = sync_image_file(clip_path, image_frames, start_frame, offset, cyclic, eval_time);
+			clip = XSI::ImageClip2();
 
-		float direction_x = get_float_parameter_value(xsi_parameters, "DirectionX", eval_time);
-		float direction_y = get_float_parameter_value(xsi_parameters, "DirectionY", eval_time);
-		float direction_z = get_float_parameter_value(xsi_parameters, "DirectionZ", eval_time);
-		float normal_x = get_float_parameter_value(xsi_parameters, "NormalX", eval_time);
-		float normal_y = get_float_parameter_value(xsi_parameters, "NormalY", eval_time);
-		float normal_z = get_float_parameter_value(xsi_parameters, "NormalZ", eval_time);
+			// start to decode the image for the next frame, it will be ready when this frame is rendered
+			XSI::CString next_file_path = sync_image_file(clip_path, image_frames, start_frame, offset, cyclic, get_next_frame_time(eval_time));
+			if (next_file_path != file_path)
+			{
+				prefetch_image_file(next_file_path, color_space == "color");
+			}
+		}
 
-		node->set_direction(ccl::make_float3(direction_x, direction_y, direction_z));
-		node->set_normal(ccl::make_float3(normal_x, normal_y, normal_z));
+		bool temp_flag = false;
+		std::string filename = build_source_image_path(file_path, image_source, cyclic, start_frame, image_frames, offset, eval_time, false, temp_flag);
+		ccl::ustring selected_colorscape = color_space == "color" ? ccl::u_colorspace_srgb : ccl::u_colorspace_raw;
 
-		return node;
-	}
-	else if (shader_type == "Bump")
-	{
-		ccl::BumpNode* node = shader_graph->create_node<ccl::BumpNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+		node->set_colorspace(selected_colorscape);
+		node->set_interpolation(interpolation == "Smart" ? ccl::InterpolationType::INTERPOLATION_SMART : (interpolation == "Cubic" ? ccl::InterpolationType::INTERPOLATION_CUBIC : (interpolation == "Closest" ? ccl::InterpolationType::INTERPOLATION_CLOSEST : ccl::InterpolationType::INTERPOLATION_LINEAR)));
+		node->set_projection(projection == "equirectangular" ? ccl::NodeEnvironmentProjection::NODE_ENVIRONMENT_EQUIRECTANGULAR : (projection == "mirrorball" ? ccl::NodeEnvironmentProjection::NODE_ENVIRONMENT_MIRROR_BALL : ccl::NodeEnvironmentProjection::NODE_ENVIRONMENT_EQUIRECTANGULAR));
+		node->set_alpha_type(premultiply_alpha ? ccl::ImageAlphaType::IMAGE_ALPHA_ASSOCIATED : ccl::ImageAlphaType::IMAGE_ALPHA_CHANNEL_PACKED);
 
-		bool invert = get_bool_parameter_value(xsi_parameters, "Invert", eval_time);
-		bool use_object_space = get_bool_parameter_value(xsi_parameters, "use_object_space", eval_time);
-		node->set_invert(invert);
-		node->set_use_object_space(use_object_space);
+		XSIImageLoader* image_loader = new XSIImageLoader(clip, selected_colorscape, 0, image_source == "image_sequence" ? file_path : "", eval_time);
+		node->handle = scene->image_manager->add_image(std::unique_ptr<ccl::ImageLoader>(image_loader), node->image_params());
 
 		return node;
 	}
-	else if (shader_type == "Mapping")
+	else
 	{
-		ccl::MappingNode* node = shader_graph->create_node<ccl::MappingNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		float translation_x = get_float_parameter_value(xsi_parameters, "TranslationX", eval_time);
-		float translation_y = get_float_parameter_value(xsi_parameters, "TranslationY", eval_time);
-		float translation_z = get_float_parameter_value(xsi_parameters, "TranslationZ", eval_time);
+		return NULL;
+	}
+}
 
-		float rotation_x = get_float_parameter_value(xsi_parameters, "RotationX", eval_time);
-		float rotation_y = get_float_parameter_value(xsi_parameters, "RotationY", eval_time);
-		float rotation_z = get_float_parameter_value(xsi_parameters, "RotationZ", eval_time);
+ccl::ShaderNode* sync_cycles_sky_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::SkyTextureNode* node = shader_graph->create_node<ccl::SkyTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	float sun_direction_x = get_float_parameter_value(xsi_parameters, "SunDirectionX", eval_time);
+	float sun_direction_y = get_float_parameter_value(xsi_parameters, "SunDirectionY", eval_time);
+	float sun_direction_z = get_float_parameter_value(xsi_parameters, "SunDirectionZ", eval_time);
+	float turbidity = get_float_parameter_value(xsi_parameters, "Turbidity", eval_time);
+	float ground_albedo = get_float_parameter_value(xsi_parameters, "GroundAlbedo", eval_time);
+	float sun_size = get_float_parameter_value(xsi_parameters, "SunSize", eval_time) * XSI::MATH::PI / 180.0;
+	float sun_intensity = get_float_parameter_value(xsi_parameters, "SunIntensity", eval_time);
+	float sun_elevation = get_float_parameter_value(xsi_parameters, "SunElevation", eval_time) * XSI::MATH::PI / 180.0f;
+	float sun_rotation = get_float_parameter_value(xsi_parameters, "SunRotation", eval_time) * XSI::MATH::PI / 180.0f;
+	float altitude = get_float_parameter_value(xsi_parameters, "Altitude", eval_time);
+	float air = get_float_parameter_value(xsi_parameters, "Air", eval_time);
+	float dust = get_float_parameter_value(xsi_parameters, "Dust", eval_time);
+	float ozone = get_float_parameter_value(xsi_parameters, "Ozone", eval_time);
+	bool sun_disc = get_bool_parameter_value(xsi_parameters, "SunDisc", eval_time);
+
+	float sun_x;
+	float sun_y;
+	float sun_z;
+	bool is_subsun = obtain_subsub_directions(xsi_shader, sun_x, sun_y, sun_z, eval_time);
+
+	float dirSquare = sun_direction_x * sun_direction_x + sun_direction_y * sun_direction_y + sun_direction_z * sun_direction_z;
+	if (dirSquare > 0.01)
+	{// normalize direction
+		float s = sqrtf(dirSquare);
+		sun_direction_x = sun_direction_x / s;
+		sun_direction_y = sun_direction_y / s;
+		sun_direction_z = sun_direction_z / s;
+	}
+	// apply shift transformation to sun direction
+	float dx = sun_direction_x;
+	float dy = -1 * sun_direction_z;
+	float dz = sun_direction_y;
+
+	node->tex_mapping.rotation = ccl::make_float3(-0.5 * XSI::MATH::PI, 0, 0);
+	node->set_sky_type(type == "preetham" ? ccl::NodeSkyType::NODE_SKY_PREETHAM : (type == "hosekwilkil" ? ccl::NodeSkyType::NODE_SKY_HOSEK : ccl::NodeSkyType::NODE_SKY_NISHITA));
+	if (is_subsun)
+	{
+		node->set_sun_direction(ccl::make_float3(sun_x, -1 * sun_z, sun_y));
+		float a_sin_z = std::asin(sun_z);
+		float xz_length = sqrtf(sun_x * sun_x + sun_z * sun_z);
+		sun_x = sun_x / xz_length;
+		sun_rotation = a_sin_z > 0 ? -std::asin(sun_x) + XSI::MATH::PI : asin(sun_x);
+		sun_elevation = std::asin(sun_y);
+	}
+	else
+	{
+		node->set_sun_direction(ccl::make_float3(dx, dy, dz));
+	}
+
+	node->set_turbidity(turbidity);
+	node->set_ground_albedo(ground_albedo);
+
+	node->set_sun_disc(sun_disc);
+	node->set_sun_size(sun_size);
+	node->set_sun_intensity(sun_intensity);
+	node->set_sun_elevation(sun_elevation);
+	node->set_sun_rotation(sun_rotation);
+	node->set_altitude(altitude);
+	node->set_air_density(air);
+	node->set_dust_density(dust);
+	node->set_ozone_density(ozone);
+
+	return node;
 
-		float scale_x = get_float_parameter_value(xsi_parameters, "ScaleX", eval_time);
-		float scale_y = get_float_parameter_value(xsi_parameters, "ScaleY", eval_time);
-		float scale_z = get_float_parameter_value(xsi_parameters, "ScaleZ", eval_time);
+}
 
-		node->set_location(ccl::make_float3(translation_x, translation_y, translation_z));
-		node->set_rotation(ccl::make_float3(DEG2RADF(rotation_x), DEG2RADF(rotation_y), DEG2RADF(rotation_z)));
-		node->set_scale(ccl::make_float3(scale_x, scale_y, scale_z));
-		node->set_mapping_type(type == "Point" ? ccl::NodeMappingType::NODE_MAPPING_TYPE_POINT :
-			(type == "Texture" ? ccl::NodeMappingType::NODE_MAPPING_TYPE_TEXTURE :
-				(type == "Vector" ? ccl::NodeMappingType::NODE_MAPPING_TYPE_VECTOR : ccl::NodeMappingType::NODE_MAPPING_TYPE_NORMAL)));
+ccl::ShaderNode* sync_cycles_noise_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::NoiseTextureNode* node = shader_graph->create_node<ccl::NoiseTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "SetNormal") {
-		ccl::SetNormalNode* node = shader_graph->create_node<ccl::SetNormalNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString noise_dimensions = get_string_parameter_value(xsi_parameters, "NoiseDimensions", eval_time);
+	node->set_dimensions(get_dimensions_type(noise_dimensions));
+	XSI::CString noise_type = get_string_parameter_value(xsi_parameters, "type", eval_time);
+	node->set_type(get_noise_type(noise_type));
+	bool normalize = get_bool_parameter_value(xsi_parameters, "normalize", eval_time);
+	node->set_use_normalize(normalize);
 
-		float direction_x = get_float_parameter_value(xsi_parameters, "direction_x", eval_time);
-		float direction_y = get_float_parameter_value(xsi_parameters, "direction_y", eval_time);
-		float direction_z = get_float_parameter_value(xsi_parameters, "direction_z", eval_time);
+	return node;
+}
 
-		node->set_direction(ccl::make_float3(direction_x, direction_y, direction_z));
+ccl::ShaderNode* sync_cycles_checker_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::CheckerTextureNode* node = shader_graph->create_node<ccl::CheckerTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "NormalMap")
-	{
-		ccl::NormalMapNode* node = shader_graph->create_node<ccl::NormalMapNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		XSI::CString space = get_string_parameter_value(xsi_parameters, "Space", eval_time);
-		XSI::CString attribute = get_string_parameter_value(xsi_parameters, "Attribute", eval_time);
+ccl::ShaderNode* sync_cycles_brick_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::BrickTextureNode* node = shader_graph->create_node<ccl::BrickTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	float offset = get_float_parameter_value(xsi_parameters, "Offset", eval_time);
+	int offset_frequency = get_int_parameter_value(xsi_parameters, "OffsetFrequency", eval_time);
+	float squash = get_float_parameter_value(xsi_parameters, "Squash", eval_time);
+	int squash_frequency = get_int_parameter_value(xsi_parameters, "SquashFrequency", eval_time);
+	node->set_offset(offset);
+	node->set_offset_frequency(offset_frequency);
+	node->set_squash(squash);
+	node->set_squash_frequency(squash_frequency);
+
+	return node;
+}
 
-		node->set_space(get_normal_map_space(space));
-		node->set_attribute(OIIO::ustring(attribute.GetAsciiString()));
+ccl::ShaderNode* sync_cycles_gradient_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::GradientTextureNode* node = shader_graph->create_node<ccl::GradientTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "VectorTransform")
-	{
-		ccl::VectorTransformNode* node = shader_graph->create_node<ccl::VectorTransformNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	node->set_gradient_type(get_gradient_type(type));
 
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		XSI::CString convert_from = get_string_parameter_value(xsi_parameters, "ConvertFrom", eval_time);
-		XSI::CString convert_to = get_string_parameter_value(xsi_parameters, "ConvertTo", eval_time);
-		float vector_x = get_float_parameter_value(xsi_parameters, "VectorX", eval_time);
-		float vector_y = get_float_parameter_value(xsi_parameters, "VectorY", eval_time);
-		float vector_z = get_float_parameter_value(xsi_parameters, "VectorZ", eval_time);
+	return node;
+}
 
-		node->set_transform_type(get_vector_transform_type(type));
-		node->set_convert_from(get_vector_transform_convert_space(convert_from));
-		node->set_convert_to(get_vector_transform_convert_space(convert_to));
-		node->set_vector(ccl::make_float3(vector_x, vector_y, vector_z));
+ccl::ShaderNode* sync_cycles_voronoi_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VoronoiTextureNode* node = shader_graph->create_node<ccl::VoronoiTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString dimensions = get_string_parameter_value(xsi_parameters, "VoronoiDimensions", eval_time);
+	XSI::CString distance = get_string_parameter_value(xsi_parameters, "Distance", eval_time);
+	XSI::CString feature = get_string_parameter_value(xsi_parameters, "Feature", eval_time);
+	bool normalize = get_bool_parameter_value(xsi_parameters, "normalize", eval_time);
+	node->set_dimensions(get_dimensions_type(dimensions));
+	node->set_metric(voronoi_distance(distance));
+	node->set_feature(voronoi_feature(feature));
+	node->set_use_normalize(normalize);
+
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "VectorRotate")
-	{
-		ccl::VectorRotateNode* node = shader_graph->create_node<ccl::VectorRotateNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_magic_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MagicTextureNode* node = shader_graph->create_node<ccl::MagicTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		bool invert = get_bool_parameter_value(xsi_parameters, "Invert", eval_time);
-		float center_x = get_float_parameter_value(xsi_parameters, "CenterX", eval_time);
-		float center_y = get_float_parameter_value(xsi_parameters, "CenterY", eval_time);
-		float center_z = get_float_parameter_value(xsi_parameters, "CenterZ", eval_time);
+	int depth = get_int_parameter_value(xsi_parameters, "Depth", eval_time);
+	node->set_depth(depth);
 
-		float axis_x = get_float_parameter_value(xsi_parameters, "AxisX", eval_time);
-		float axis_y = get_float_parameter_value(xsi_parameters, "AxisY", eval_time);
-		float axis_z = get_float_parameter_value(xsi_parameters, "AxisZ", eval_time);
+	return node;
+}
 
-		float rotation_x = get_float_parameter_value(xsi_parameters, "VectorRotationX", eval_time);
-		float rotation_y = get_float_parameter_value(xsi_parameters, "VectorRotationY", eval_time);
-		float rotation_z = get_float_parameter_value(xsi_parameters, "VectorRotationZ", eval_time);
+ccl::ShaderNode* sync_cycles_wave_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::WaveTextureNode* node = shader_graph->create_node<ccl::WaveTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	XSI::CString bands_direction = get_string_parameter_value(xsi_parameters, "bands_direction", eval_time);
+	XSI::CString rings_direction = get_string_parameter_value(xsi_parameters, "rings_direction", eval_time);
+	XSI::CString profile = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	node->set_wave_type(get_wave_type(type));
+	node->set_profile(get_wave_profile(profile));
+	node->set_bands_direction(get_wave_bands_direction(bands_direction));
+	node->set_rings_direction(get_wave_rings_direction(rings_direction));
+
+	return node;
+}
 
-		node->set_rotate_type(get_vector_rotate_type(type));
-		node->set_invert(invert);
-		node->set_center(ccl::make_float3(center_x, center_y, center_z));
-		node->set_axis(ccl::make_float3(axis_x, axis_y, axis_z));
-		node->set_rotation(ccl::make_float3(rotation_x, rotation_y, rotation_z));
+ccl::ShaderNode* sync_cycles_ies_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::IESLightNode* node = shader_graph->create_node<ccl::IESLightNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
+	XSI::CString file_path = get_string_parameter_value(xsi_parameters, "FilePath", eval_time);
+	if (file_path.Length() > 0 && !XSI::CUtils::IsAbsolutePath(file_path))
+	{
+		file_path = XSI::CUtils::ResolvePath(XSI::CUtils::BuildPath(get_project_path(), file_path));
 	}
-	else if (shader_type == "VectorCurves")
+	if (file_path.Length() > 0)
 	{
-		ccl::VectorCurvesNode* node = shader_graph->create_node<ccl::VectorCurvesNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		XSI::FCurve x_curve = get_fcurve_parameter_value(xsi_parameters, "xCurve", eval_time);
-		XSI::FCurve y_curve = get_fcurve_parameter_value(xsi_parameters, "yCurve", eval_time);
-		XSI::FCurve z_curve = get_fcurve_parameter_value(xsi_parameters, "zCurve", eval_time);
-
-		std::array<float, 2> min_max = get_min_and_max(x_curve, y_curve, z_curve);
-		node->set_min_x(min_max[0]);
-		node->set_max_x(min_max[1]);
-		ccl::array<ccl::float3> curves_array = three_curves_to_array(x_curve, y_curve, z_curve, min_max[0], min_max[1], RAMP_TABLE_SIZE);
-		node->set_curves(curves_array);
-
-		return node;
+		node->set_filename(OIIO::ustring(file_path.GetAsciiString()));
 	}
-	else if (shader_type == "Displacement")
+	else
 	{
-		ccl::DisplacementNode* node = shader_graph->create_node<ccl::DisplacementNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+		return NULL;
+	}
 
-		XSI::CString space = get_string_parameter_value(xsi_parameters, "Space", eval_time);
-		node->set_space(space == "object" ? ccl::NODE_NORMAL_MAP_OBJECT : ccl::NODE_NORMAL_MAP_WORLD);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "VectorDisplacement")
-	{
-		ccl::VectorDisplacementNode* node = shader_graph->create_node<ccl::VectorDisplacementNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_white_noise_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::WhiteNoiseTextureNode* node = shader_graph->create_node<ccl::WhiteNoiseTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString space = get_string_parameter_value(xsi_parameters, "Space", eval_time);
-		node->set_space(space == "object" ? ccl::NODE_NORMAL_MAP_OBJECT : (space == "tangent" ? ccl::NODE_NORMAL_MAP_TANGENT : ccl::NODE_NORMAL_MAP_WORLD));
+	XSI::CString dimensions = get_string_parameter_value(xsi_parameters, "NoiseDimensions", eval_time);
+	float vector_x = get_float_parameter_value(xsi_parameters, "VectorX", eval_time);
+	float vector_y = get_float_parameter_value(xsi_parameters, "VectorY", eval_time);
+	float vector_z = get_float_parameter_value(xsi_parameters, "VectorZ", eval_time);
 
-		return node;
-	}
-	else if (shader_type == "Geometry")
-	{
-		ccl::GeometryNode* node = shader_graph->create_node<ccl::GeometryNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	node->set_dimensions(get_dimensions_type(dimensions));
+	node->set_vector(ccl::make_float3(vector_x, vector_y, vector_z));
 
-		return node;
-	}
-	else if (shader_type == "TextureCoordinate")
-	{
-		ccl::TextureCoordinateNode* node = shader_graph->create_node<ccl::TextureCoordinateNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "LightPath")
-	{
-		ccl::LightPathNode* node = shader_graph->create_node<ccl::LightPathNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_gabor_texture(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::GaborTextureNode* node = shader_graph->create_node<ccl::GaborTextureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString gabor_type = get_string_parameter_value(xsi_parameters, "gabor_type", eval_time);
+	float orientation_3d_x = get_float_parameter_value(xsi_parameters, "orientation_3d_x", eval_time);
+	float orientation_3d_y = get_float_parameter_value(xsi_parameters, "orientation_3d_y", eval_time);
+	float orientation_3d_z = get_float_parameter_value(xsi_parameters, "orientation_3d_z", eval_time);
 
-		return node;
-	}
-	else if (shader_type == "ObjectInfo")
-	{
-		ccl::ObjectInfoNode* node = shader_graph->create_node<ccl::ObjectInfoNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	node->set_type(get_gabor_type(gabor_type));
+	node->set_orientation_3d(ccl::make_float3(orientation_3d_x, orientation_3d_y, orientation_3d_z));
 
-		return node;
-	}
-	else if (shader_type == "VolumeInfo")
-	{
-		ccl::VolumeInfoNode* node = shader_graph->create_node<ccl::VolumeInfoNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "PointInfo")
-	{
-		ccl::PointInfoNode* node = shader_graph->create_node<ccl::PointInfoNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_normal(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::NormalNode* node = shader_graph->create_node<ccl::NormalNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "ParticleInfo")
-	{
-		ccl::ParticleInfoNode* node = shader_graph->create_node<ccl::ParticleInfoNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	float direction_x = get_float_parameter_value(xsi_parameters, "DirectionX", eval_time);
+	float direction_y = get_float_parameter_value(xsi_parameters, "DirectionY", eval_time);
+	float direction_z = get_float_parameter_value(xsi_parameters, "DirectionZ", eval_time);
+	float normal_x = get_float_parameter_value(xsi_parameters, "NormalX", eval_time);
+	float normal_y = get_float_parameter_value(xsi_parameters, "NormalY", eval_time);
+	float normal_z = get_float_parameter_value(xsi_parameters, "NormalZ", eval_time);
 
-		return node;
-	}
-	else if (shader_type == "HairInfo")
-	{
-		ccl::HairInfoNode* node = shader_graph->create_node<ccl::HairInfoNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	node->set_direction(ccl::make_float3(direction_x, direction_y, direction_z));
+	node->set_normal(ccl::make_float3(normal_x, normal_y, normal_z));
 
-		return node;
-	}
-	else if (shader_type == "Value")
-	{
-		ccl::ValueNode* node = shader_graph->create_node<ccl::ValueNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		float value_in = get_float_parameter_value(xsi_parameters, "ValueIn", eval_time);
-		node->set_value(value_in);
+ccl::ShaderNode* sync_cycles_bump(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::BumpNode* node = shader_graph->create_node<ccl::BumpNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "Color")
-	{
-		ccl::ColorNode* node = shader_graph->create_node<ccl::ColorNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	bool invert = get_bool_parameter_value(xsi_parameters, "Invert", eval_time);
+	bool use_object_space = get_bool_parameter_value(xsi_parameters, "use_object_space", eval_time);
+	node->set_invert(invert);
+	node->set_use_object_space(use_object_space);
 
-		XSI::MATH::CColor4f color = get_color_parameter_value(xsi_parameters, "ColorIn", eval_time);
-		node->set_value(color4_to_float3(color));
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "Attribute")
-	{
-		ccl::AttributeNode* node = shader_graph->create_node<ccl::AttributeNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_mapping(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MappingNode* node = shader_graph->create_node<ccl::MappingNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	float translation_x = get_float_parameter_value(xsi_parameters, "TranslationX", eval_time);
+	float translation_y = get_float_parameter_value(xsi_parameters, "TranslationY", eval_time);
+	float translation_z = get_float_parameter_value(xsi_parameters, "TranslationZ", eval_time);
+
+	float rotation_x = get_float_parameter_value(xsi_parameters, "RotationX", eval_time);
+	float rotation_y = get_float_parameter_value(xsi_parameters, "RotationY", eval_time);
+	float rotation_z = get_float_parameter_value(xsi_parameters, "RotationZ", eval_time);
+
+	float scale_x = get_float_parameter_value(xsi_parameters, "ScaleX", eval_time);
+	float scale_y = get_float_parameter_value(xsi_parameters, "ScaleY", eval_time);
+	float scale_z = get_float_parameter_value(xsi_parameters, "ScaleZ", eval_time);
+
+	node->set_location(ccl::make_float3(translation_x, translation_y, translation_z));
+	node->set_rotation(ccl::make_float3(DEG2RADF(rotation_x), DEG2RADF(rotation_y), DEG2RADF(rotation_z)));
+	node->set_scale(ccl::make_float3(scale_x, scale_y, scale_z));
+	node->set_mapping_type(type == "Point" ? ccl::NodeMappingType::NODE_MAPPING_TYPE_POINT :
+		(type == "Texture" ? ccl::NodeMappingType::NODE_MAPPING_TYPE_TEXTURE :
+			(type == "Vector" ? ccl::NodeMappingType::NODE_MAPPING_TYPE_VECTOR : ccl::NodeMappingType::NODE_MAPPING_TYPE_NORMAL)));
+
+	return node;
+}
 
-		XSI::CString attribute = get_string_parameter_value(xsi_parameters, "Attribute", eval_time);
-		node->set_attribute(ccl::ustring(attribute.GetAsciiString()));
+ccl::ShaderNode* sync_cycles_set_normal(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::SetNormalNode* node = shader_graph->create_node<ccl::SetNormalNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "OutputColorAOV")
-	{
-		ccl::OutputAOVNode* node = shader_graph->create_node<ccl::OutputAOVNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	float direction_x = get_float_parameter_value(xsi_parameters, "direction_x", eval_time);
+	float direction_y = get_float_parameter_value(xsi_parameters, "direction_y", eval_time);
+	float direction_z = get_float_parameter_value(xsi_parameters, "direction_z", eval_time);
 
-		XSI::CString channel_name = get_string_parameter_value(xsi_parameters, "aov_name", eval_time);
-		node->set_name(OIIO::ustring(add_prefix_to_aov_name(channel_name, true).GetAsciiString()));
-		aovs[0].Add(channel_name);
+	node->set_direction(ccl::make_float3(direction_x, direction_y, direction_z));
 
-		return node;
-	}
-	else if (shader_type == "OutputValueAOV")
-	{
-		ccl::OutputAOVNode* node = shader_graph->create_node<ccl::OutputAOVNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		XSI::CString channel_name = get_string_parameter_value(xsi_parameters, "aov_name", eval_time);
-		node->set_name(OIIO::ustring(add_prefix_to_aov_name(channel_name, false).GetAsciiString()));
-		aovs[1].Add(channel_name);
+ccl::ShaderNode* sync_cycles_normal_map(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::NormalMapNode* node = shader_graph->create_node<ccl::NormalMapNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "VertexColor")
-	{
-		ccl::VertexColorNode* node = shader_graph->create_node<ccl::VertexColorNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString space = get_string_parameter_value(xsi_parameters, "Space", eval_time);
+	XSI::CString attribute = get_string_parameter_value(xsi_parameters, "Attribute", eval_time);
 
-		XSI::CString name = get_string_parameter_value(xsi_parameters, "LayerName", eval_time);
-		node->set_layer_name(ccl::ustring(name.GetAsciiString()));
+	node->set_space(get_normal_map_space(space));
+	node->set_attribute(OIIO::ustring(attribute.GetAsciiString()));
 
-		return node;
-	}
-	else if (shader_type == "Bevel")
-	{
-		ccl::BevelNode* node = shader_graph->create_node<ccl::BevelNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		int samples = get_int_parameter_value(xsi_parameters, "Samples", eval_time);
-		node->set_samples(samples);
+ccl::ShaderNode* sync_cycles_vector_transform(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VectorTransformNode* node = shader_graph->create_node<ccl::VectorTransformNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	XSI::CString convert_from = get_string_parameter_value(xsi_parameters, "ConvertFrom", eval_time);
+	XSI::CString convert_to = get_string_parameter_value(xsi_parameters, "ConvertTo", eval_time);
+	float vector_x = get_float_parameter_value(xsi_parameters, "VectorX", eval_time);
+	float vector_y = get_float_parameter_value(xsi_parameters, "VectorY", eval_time);
+	float vector_z = get_float_parameter_value(xsi_parameters, "VectorZ", eval_time);
+
+	node->set_transform_type(get_vector_transform_type(type));
+	node->set_convert_from(get_vector_transform_convert_space(convert_from));
+	node->set_convert_to(get_vector_transform_convert_space(convert_to));
+	node->set_vector(ccl::make_float3(vector_x, vector_y, vector_z));
+
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "UVMap")
-	{
-		ccl::UVMapNode* node = shader_graph->create_node<ccl::UVMapNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_vector_rotate(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VectorRotateNode* node = shader_graph->create_node<ccl::VectorRotateNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	bool invert = get_bool_parameter_value(xsi_parameters, "Invert", eval_time);
+	float center_x = get_float_parameter_value(xsi_parameters, "CenterX", eval_time);
+	float center_y = get_float_parameter_value(xsi_parameters, "CenterY", eval_time);
+	float center_z = get_float_parameter_value(xsi_parameters, "CenterZ", eval_time);
+
+	float axis_x = get_float_parameter_value(xsi_parameters, "AxisX", eval_time);
+	float axis_y = get_float_parameter_value(xsi_parameters, "AxisY", eval_time);
+	float axis_z = get_float_parameter_value(xsi_parameters, "AxisZ", eval_time);
+
+	float rotation_x = get_float_parameter_value(xsi_parameters, "VectorRotationX", eval_time);
+	float rotation_y = get_float_parameter_value(xsi_parameters, "VectorRotationY", eval_time);
+	float rotation_z = get_float_parameter_value(xsi_parameters, "VectorRotationZ", eval_time);
+
+	node->set_rotate_type(get_vector_rotate_type(type));
+	node->set_invert(invert);
+	node->set_center(ccl::make_float3(center_x, center_y, center_z));
+	node->set_axis(ccl::make_float3(axis_x, axis_y, axis_z));
+	node->set_rotation(ccl::make_float3(rotation_x, rotation_y, rotation_z));
+
+	return node;
+}
 
-		XSI::CString attribute = get_string_parameter_value(xsi_parameters, "Attribute", eval_time);
-		node->set_attribute(ccl::ustring(attribute.GetAsciiString()));
+ccl::ShaderNode* sync_cycles_vector_curves(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VectorCurvesNode* node = shader_graph->create_node<ccl::VectorCurvesNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "Camera")
-	{
-		ccl::CameraNode* node = shader_graph->create_node<ccl::CameraNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::FCurve x_curve = get_fcurve_parameter_value(xsi_parameters, "xCurve", eval_time);
+	XSI::FCurve y_curve = get_fcurve_parameter_value(xsi_parameters, "yCurve", eval_time);
+	XSI::FCurve z_curve = get_fcurve_parameter_value(xsi_parameters, "zCurve", eval_time);
 
-		return node;
-	}
-	else if (shader_type == "Fresnel")
-	{
-		ccl::FresnelNode* node = shader_graph->create_node<ccl::FresnelNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	std::array<float, 2> min_max = get_min_and_max(x_curve, y_curve, z_curve);
+	node->set_min_x(min_max[0]);
+	node->set_max_x(min_max[1]);
+	ccl::array<ccl::float3> curves_array = three_curves_to_array(x_curve, y_curve, z_curve, min_max[0], min_max[1], RAMP_TABLE_SIZE);
+	node->set_curves(curves_array);
 
-		return node;
-	}
-	else if (shader_type == "LayerWeight")
-	{
-		ccl::LayerWeightNode* node = shader_graph->create_node<ccl::LayerWeightNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "Wireframe")
-	{
-		ccl::WireframeNode* node = shader_graph->create_node<ccl::WireframeNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_displacement(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::DisplacementNode* node = shader_graph->create_node<ccl::DisplacementNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		bool use_pixel = get_bool_parameter_value(xsi_parameters, "UsePixelSize", eval_time);
-		node->set_use_pixel_size(use_pixel);
+	XSI::CString space = get_string_parameter_value(xsi_parameters, "Space", eval_time);
+	node->set_space(space == "object" ? ccl::NODE_NORMAL_MAP_OBJECT : ccl::NODE_NORMAL_MAP_WORLD);
 
-		return node;
-	}
-	else if (shader_type == "Tangent")
-	{
-		ccl::TangentNode* node = shader_graph->create_node<ccl::TangentNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		XSI::CString direction_type = get_string_parameter_value(xsi_parameters, "DirectionType", eval_time);
-		XSI::CString axis = get_string_parameter_value(xsi_parameters, "Axis", eval_time);
-		XSI::CString attribute = get_string_parameter_value(xsi_parameters, "Attribute", eval_time);
+ccl::ShaderNode* sync_cycles_vector_displacement(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VectorDisplacementNode* node = shader_graph->create_node<ccl::VectorDisplacementNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		node->set_direction_type(get_tangent_direction_type(direction_type));
-		node->set_axis(get_tangent_axis(axis));
-		node->set_attribute(OIIO::ustring(attribute.GetAsciiString()));
+	XSI::CString space = get_string_parameter_value(xsi_parameters, "Space", eval_time);
+	node->set_space(space == "object" ? ccl::NODE_NORMAL_MAP_OBJECT : (space == "tangent" ? ccl::NODE_NORMAL_MAP_TANGENT : ccl::NODE_NORMAL_MAP_WORLD));
 
-		return node;
-	}
-	else if (shader_type == "LightFalloff")
-	{
-		ccl::LightFalloffNode* node = shader_graph->create_node<ccl::LightFalloffNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "Invert")
-	{
-		ccl::InvertNode* node = shader_graph->create_node<ccl::InvertNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_geometry(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::GeometryNode* node = shader_graph->create_node<ccl::GeometryNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "MixRGB")
-	{
-		ccl::MixNode* node = shader_graph->create_node<ccl::MixNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
+ccl::ShaderNode* sync_cycles_texture_coordinate(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::TextureCoordinateNode* node = shader_graph->create_node<ccl::TextureCoordinateNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		node->set_mix_type(get_mix_type(type));
-		node->set_use_clamp(use_clamp);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "MixColor")
-	{
-		ccl::MixColorNode* node = shader_graph->create_node<ccl::MixColorNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_light_path(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::LightPathNode* node = shader_graph->create_node<ccl::LightPathNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
-		bool use_clamp_result = get_bool_parameter_value(xsi_parameters, "UseClampResult", eval_time);
+	return node;
+}
 
-		node->set_blend_type(get_mix_type(type));
-		node->set_use_clamp(use_clamp);
-		node->set_use_clamp_result(use_clamp_result);
+ccl::ShaderNode* sync_cycles_object_info(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::ObjectInfoNode* node = shader_graph->create_node<ccl::ObjectInfoNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "MixFloat")
-	{
-		ccl::MixFloatNode* node = shader_graph->create_node<ccl::MixFloatNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
-		node->set_use_clamp(use_clamp);
-		return node;
-	}
-	else if (shader_type == "MixVector")
-	{
-		ccl::MixVectorNode* node = shader_graph->create_node<ccl::MixVectorNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_volume_info(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VolumeInfoNode* node = shader_graph->create_node<ccl::VolumeInfoNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
-		node->set_use_clamp(use_clamp);
-		return node;
-	}
-	else if (shader_type == "MixVectorNonUniform")
-	{
-		ccl::MixVectorNonUniformNode* node = shader_graph->create_node<ccl::MixVectorNonUniformNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
-		node->set_use_clamp(use_clamp);
-		return node;
-	}
-	else if (shader_type == "Gamma")
-	{
-		ccl::GammaNode* node = shader_graph->create_node<ccl::GammaNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_point_info(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::PointInfoNode* node = shader_graph->create_node<ccl::PointInfoNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "BrightContrast")
-	{
-		ccl::BrightContrastNode* node = shader_graph->create_node<ccl::BrightContrastNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "HSV")
-	{
-		ccl::HSVNode* node = shader_graph->create_node<ccl::HSVNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_particle_info(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::ParticleInfoNode* node = shader_graph->create_node<ccl::ParticleInfoNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "RGBCurves")
-	{
-		ccl::RGBCurvesNode* node = shader_graph->create_node<ccl::RGBCurvesNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		XSI::FCurve r_curve = get_fcurve_parameter_value(xsi_parameters, "rCurve", eval_time);
-		XSI::FCurve g_curve = get_fcurve_parameter_value(xsi_parameters, "gCurve", eval_time);
-		XSI::FCurve b_curve = get_fcurve_parameter_value(xsi_parameters, "bCurve", eval_time);
+ccl::ShaderNode* sync_cycles_hair_info(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::HairInfoNode* node = shader_graph->create_node<ccl::HairInfoNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		std::array<float, 2> min_max = get_min_and_max(r_curve, g_curve, b_curve);
-		node->set_min_x(min_max[0]);
-		node->set_max_x(min_max[1]);
-		ccl::array<ccl::float3> curves = three_curves_to_array(r_curve, g_curve, b_curve, min_max[0], min_max[1], RAMP_TABLE_SIZE);
-		node->set_curves(curves);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "ColorCurves")
-	{
-		ccl::RGBCurvesNode* node = shader_graph->create_node<ccl::RGBCurvesNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_value(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::ValueNode* node = shader_graph->create_node<ccl::ValueNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::FCurve curve = get_fcurve_parameter_value(xsi_parameters, "Curve", eval_time);
+	float value_in = get_float_parameter_value(xsi_parameters, "ValueIn", eval_time);
+	node->set_value(value_in);
 
-		std::array<float, 2> min_max = get_min_and_max(curve, curve, curve);
-		node->set_min_x(min_max[0]);
-		node->set_max_x(min_max[1]);
-		ccl::array<ccl::float3> curves = three_curves_to_array(curve, curve, curve, min_max[0], min_max[1], RAMP_TABLE_SIZE);
-		node->set_curves(curves);
+	return node;
+}
 
-		return node;	
-	}
-	else if (shader_type == "Wavelength")
-	{
-		ccl::WavelengthNode* node = shader_graph->create_node<ccl::WavelengthNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_color(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::ColorNode* node = shader_graph->create_node<ccl::ColorNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "Blackbody")
-	{
-		ccl::BlackbodyNode* node = shader_graph->create_node<ccl::BlackbodyNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::MATH::CColor4f color = get_color_parameter_value(xsi_parameters, "ColorIn", eval_time);
+	node->set_value(color4_to_float3(color));
 
-		return node;
-	}
-	else if (shader_type == "MixClosure")
-	{
-		ccl::MixClosureNode* node = shader_graph->create_node<ccl::MixClosureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "AddClosure")
-	{
-		ccl::AddClosureNode* node = shader_graph->create_node<ccl::AddClosureNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_attribute(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::AttributeNode* node = shader_graph->create_node<ccl::AttributeNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "CombineColor")
-	{
-		ccl::CombineColorNode* node = shader_graph->create_node<ccl::CombineColorNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString attribute = get_string_parameter_value(xsi_parameters, "Attribute", eval_time);
+	node->set_attribute(ccl::ustring(attribute.GetAsciiString()));
 
-		XSI::CString mode = get_string_parameter_value(xsi_parameters, "mode", eval_time);
-		node->set_color_type(mode == "rgb" ? ccl::NODE_COMBSEP_COLOR_RGB : (mode == "hsv" ? ccl::NODE_COMBSEP_COLOR_HSV : ccl::NODE_COMBSEP_COLOR_HSL));
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "CombineRGB")
-	{
-		ccl::CombineRGBNode* node = shader_graph->create_node<ccl::CombineRGBNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_output_color_aov(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::OutputAOVNode* node = shader_graph->create_node<ccl::OutputAOVNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "CombineHSV")
-	{
-		ccl::CombineHSVNode* node = shader_graph->create_node<ccl::CombineHSVNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString channel_name = get_string_parameter_value(xsi_parameters, "aov_name", eval_time);
+	node->set_name(OIIO::ustring(add_prefix_to_aov_name(channel_name, true).GetAsciiString()));
+	aovs[0].Add(channel_name);
 
-		return node;
-	}
-	else if (shader_type == "CombineXYZ")
-	{
-		ccl::CombineXYZNode* node = shader_graph->create_node<ccl::CombineXYZNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "SeparateColor")
-	{
-		ccl::SeparateColorNode* node = shader_graph->create_node<ccl::SeparateColorNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_output_value_aov(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::OutputAOVNode* node = shader_graph->create_node<ccl::OutputAOVNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		XSI::CString mode = get_string_parameter_value(xsi_parameters, "mode", eval_time);
-		node->set_color_type(mode == "rgb" ? ccl::NODE_COMBSEP_COLOR_RGB : (mode == "hsv" ? ccl::NODE_COMBSEP_COLOR_HSV : ccl::NODE_COMBSEP_COLOR_HSL));
+	XSI::CString channel_name = get_string_parameter_value(xsi_parameters, "aov_name", eval_time);
+	node->set_name(OIIO::ustring(add_prefix_to_aov_name(channel_name, false).GetAsciiString()));
+	aovs[1].Add(channel_name);
 
-		return node;
-	}
-	else if (shader_type == "SeparateRGB")
-	{
-		ccl::SeparateRGBNode* node = shader_graph->create_node<ccl::SeparateRGBNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "SeparateHSV")
-	{
-		ccl::SeparateHSVNode* node = shader_graph->create_node<ccl::SeparateHSVNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_vertex_color(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VertexColorNode* node = shader_graph->create_node<ccl::VertexColorNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "SeparateXYZ")
-	{
-		ccl::SeparateXYZNode* node = shader_graph->create_node<ccl::SeparateXYZNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString name = get_string_parameter_value(xsi_parameters, "LayerName", eval_time);
+	node->set_layer_name(ccl::ustring(name.GetAsciiString()));
 
-		float vector_x = get_float_parameter_value(xsi_parameters, "VectorX", eval_time);
-		float vector_y = get_float_parameter_value(xsi_parameters, "VectorY", eval_time);
-		float vector_z = get_float_parameter_value(xsi_parameters, "VectorZ", eval_time);
+	return node;
+}
 
-		node->set_vector(ccl::make_float3(vector_x, vector_y, vector_z));
+ccl::ShaderNode* sync_cycles_bevel(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::BevelNode* node = shader_graph->create_node<ccl::BevelNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "Math")
-	{
-		ccl::MathNode* node = shader_graph->create_node<ccl::MathNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	int samples = get_int_parameter_value(xsi_parameters, "Samples", eval_time);
+	node->set_samples(samples);
 
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		bool clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
+	return node;
+}
 
-		node->set_math_type(get_math_type(type));
-		node->set_use_clamp(clamp);
+ccl::ShaderNode* sync_cycles_uv_map(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::UVMapNode* node = shader_graph->create_node<ccl::UVMapNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "VectorMath")
-	{
-		ccl::VectorMathNode* node = shader_graph->create_node<ccl::VectorMathNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	XSI::CString attribute = get_string_parameter_value(xsi_parameters, "Attribute", eval_time);
+	node->set_attribute(ccl::ustring(attribute.GetAsciiString()));
 
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-	
-		float vector1_x = get_float_parameter_value(xsi_parameters, "Vector1X", eval_time);
-		float vector1_y = get_float_parameter_value(xsi_parameters, "Vector1Y", eval_time);
-		float vector1_z = get_float_parameter_value(xsi_parameters, "Vector1Z", eval_time);
+	return node;
+}
 
-		float vector2_x = get_float_parameter_value(xsi_parameters, "Vector2X", eval_time);
-		float vector2_y = get_float_parameter_value(xsi_parameters, "Vector2Y", eval_time);
-		float vector2_z = get_float_parameter_value(xsi_parameters, "Vector2Z", eval_time);
+ccl::ShaderNode* sync_cycles_camera(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::CameraNode* node = shader_graph->create_node<ccl::CameraNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		float vector3_x = get_float_parameter_value(xsi_parameters, "Vector3X", eval_time);
-		float vector3_y = get_float_parameter_value(xsi_parameters, "Vector3Y", eval_time);
-		float vector3_z = get_float_parameter_value(xsi_parameters, "Vector3Z", eval_time);
+	return node;
+}
 
-		node->set_math_type(get_vector_math(type));
-		node->set_vector1(ccl::make_float3(vector1_x, vector1_y, vector1_z));
-		node->set_vector2(ccl::make_float3(vector2_x, vector2_y, vector2_z));
-		node->set_vector3(ccl::make_float3(vector3_x, vector3_y, vector3_z));
+ccl::ShaderNode* sync_cycles_fresnel(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::FresnelNode* node = shader_graph->create_node<ccl::FresnelNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "ColorRamp")
-	{
-		ccl::RGBRampNode* node = shader_graph->create_node<ccl::RGBRampNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		node->set_interpolate(true);
-		XSI::ShaderParameter gradient_parameter = xsi_parameters.GetItem("Gradient");
-		XSI::ShaderParameter gradient_parameter_final = get_source_parameter(gradient_parameter);
-
-		XSI::CParameterRefArray g_params = gradient_parameter_final.GetParameters();
-		XSI::Parameter markers_parameter = g_params.GetItem("markers");
-		XSI::CParameterRefArray m_params = markers_parameter.GetParameters();
-		std::vector<GradientPoint> gradient_data;
-		for (int i = 0; i < m_params.GetCount(); i++)
-		{
-			XSI::ShaderParameter p = m_params[i];
-			float pos = p.GetParameterValue("pos");
-			float mid = p.GetParameterValue("mid");
-			float r = p.GetParameterValue("red");
-			float g = p.GetParameterValue("green");
-			float b = p.GetParameterValue("blue");
-			float a = p.GetParameterValue("alpha");
-			if (pos > -1)
-			{
-				GradientPoint new_data;
-				new_data.pos = pos;
-				new_data.mid = mid;
-				new_data.color = XSI::MATH::CColor4f(r, g, b, a);
-				gradient_data.push_back(new_data);
-			}
-		}
-		ccl::array<ccl::float3> ramp;
-		ccl::array<float> ramp_alpha;
-		form_ramp(gradient_data, RAMP_TABLE_SIZE, ramp, ramp_alpha);
-		node->set_ramp(ramp);
-		node->set_ramp_alpha(ramp_alpha);
+	return node;
+}
 
-		return node;
-	}
-	else if (shader_type == "MapRange")
-	{
-		ccl::MapRangeNode* node = shader_graph->create_node<ccl::MapRangeNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+ccl::ShaderNode* sync_cycles_layer_weight(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::LayerWeightNode* node = shader_graph->create_node<ccl::LayerWeightNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		bool clamp = get_bool_parameter_value(xsi_parameters, "Clamp", eval_time);
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	return node;
+}
 
-		node->set_clamp(clamp);
-		node->set_range_type(get_map_range_type(type));
+ccl::ShaderNode* sync_cycles_wireframe(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::WireframeNode* node = shader_graph->create_node<ccl::WireframeNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "VectorMapRange")
-	{
-		ccl::VectorMapRangeNode* node = shader_graph->create_node<ccl::VectorMapRangeNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	bool use_pixel = get_bool_parameter_value(xsi_parameters, "UsePixelSize", eval_time);
+	node->set_use_pixel_size(use_pixel);
 
-		bool clamp = get_bool_parameter_value(xsi_parameters, "Clamp", eval_time);
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	return node;
+}
 
-		float from_min_x = get_float_parameter_value(xsi_parameters, "FromMinX", eval_time);
-		float from_min_y = get_float_parameter_value(xsi_parameters, "FromMinY", eval_time);
-		float from_min_z = get_float_parameter_value(xsi_parameters, "FromMinZ", eval_time);
+ccl::ShaderNode* sync_cycles_tangent(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::TangentNode* node = shader_graph->create_node<ccl::TangentNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		float from_max_x = get_float_parameter_value(xsi_parameters, "FromMaxX", eval_time);
-		float from_max_y = get_float_parameter_value(xsi_parameters, "FromMaxY", eval_time);
-		float from_max_z = get_float_parameter_value(xsi_parameters, "FromMaxZ", eval_time);
+	XSI::CString direction_type = get_string_parameter_value(xsi_parameters, "DirectionType", eval_time);
+	XSI::CString axis = get_string_parameter_value(xsi_parameters, "Axis", eval_time);
+	XSI::CString attribute = get_string_parameter_value(xsi_parameters, "Attribute", eval_time);
 
-		float to_min_x = get_float_parameter_value(xsi_parameters, "ToMinX", eval_time);
-		float to_min_y = get_float_parameter_value(xsi_parameters, "ToMinY", eval_time);
-		float to_min_z = get_float_parameter_value(xsi_parameters, "ToMinZ", eval_time);
+	node->set_direction_type(get_tangent_direction_type(direction_type));
+	node->set_axis(get_tangent_axis(axis));
+	node->set_attribute(OIIO::ustring(attribute.GetAsciiString()));
 
-		float to_max_x = get_float_parameter_value(xsi_parameters, "ToMaxX", eval_time);
-		float to_max_y = get_float_parameter_value(xsi_parameters, "ToMaxY", eval_time);
-		float to_max_z = get_float_parameter_value(xsi_parameters, "ToMaxZ", eval_time);
+	return node;
+}
 
-		float step_x = get_float_parameter_value(xsi_parameters, "StepsX", eval_time);
-		float step_y = get_float_parameter_value(xsi_parameters, "StepsY", eval_time);
-		float step_z = get_float_parameter_value(xsi_parameters, "StepsZ", eval_time);
+ccl::ShaderNode* sync_cycles_light_falloff(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::LightFalloffNode* node = shader_graph->create_node<ccl::LightFalloffNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		node->set_use_clamp(clamp);
-		node->set_range_type(get_map_range_type(type));
+	return node;
+}
 
-		node->set_from_min(ccl::make_float3(from_min_x, from_min_y, from_min_z));
-		node->set_from_max(ccl::make_float3(from_max_x, from_max_y, from_max_z));
-		node->set_to_min(ccl::make_float3(to_min_x, to_min_y, to_min_z));
-		node->set_to_max(ccl::make_float3(to_max_x, to_max_y, to_max_z));
-		node->set_steps(ccl::make_float3(step_x, step_y, step_z));
+ccl::ShaderNode* sync_cycles_invert(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::InvertNode* node = shader_graph->create_node<ccl::InvertNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "FloatCurve")
-	{
-		ccl::FloatCurveNode* node = shader_graph->create_node<ccl::FloatCurveNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
-
-		XSI::FCurve curve = get_fcurve_parameter_value(xsi_parameters, "Curve", eval_time);
-		float min = curve.GetKeyAtIndex(0).GetTime();
-		float max = curve.GetKeyAtIndex(curve.GetNumKeys() - 1).GetTime();
-		node->set_min_x(min);
-		node->set_max_x(max);
-
-		ccl::array<float> curve_mapping_curve;
-		int steps = 256;// RAMP_TABLE_SIZE;
-		curve_mapping_curve.resize(steps);
-		const float range = max - min;
-		for (int i = 0; i < steps; i++)
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_mix_rgb(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MixNode* node = shader_graph->create_node<ccl::MixNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
+
+	node->set_mix_type(get_mix_type(type));
+	node->set_use_clamp(use_clamp);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_mix_color(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MixColorNode* node = shader_graph->create_node<ccl::MixColorNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
+	bool use_clamp_result = get_bool_parameter_value(xsi_parameters, "UseClampResult", eval_time);
+
+	node->set_blend_type(get_mix_type(type));
+	node->set_use_clamp(use_clamp);
+	node->set_use_clamp_result(use_clamp_result);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_mix_float(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MixFloatNode* node = shader_graph->create_node<ccl::MixFloatNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
+	node->set_use_clamp(use_clamp);
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_mix_vector(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MixVectorNode* node = shader_graph->create_node<ccl::MixVectorNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
+	node->set_use_clamp(use_clamp);
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_mix_vector_non_uniform(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MixVectorNonUniformNode* node = shader_graph->create_node<ccl::MixVectorNonUniformNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	bool use_clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
+	node->set_use_clamp(use_clamp);
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_gamma(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::GammaNode* node = shader_graph->create_node<ccl::GammaNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_bright_contrast(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::BrightContrastNode* node = shader_graph->create_node<ccl::BrightContrastNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_hsv(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::HSVNode* node = shader_graph->create_node<ccl::HSVNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_rgb_curves(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::RGBCurvesNode* node = shader_graph->create_node<ccl::RGBCurvesNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::FCurve r_curve = get_fcurve_parameter_value(xsi_parameters, "rCurve", eval_time);
+	XSI::FCurve g_curve = get_fcurve_parameter_value(xsi_parameters, "gCurve", eval_time);
+	XSI::FCurve b_curve = get_fcurve_parameter_value(xsi_parameters, "bCurve", eval_time);
+
+	std::array<float, 2> min_max = get_min_and_max(r_curve, g_curve, b_curve);
+	node->set_min_x(min_max[0]);
+	node->set_max_x(min_max[1]);
+	ccl::array<ccl::float3> curves = three_curves_to_array(r_curve, g_curve, b_curve, min_max[0], min_max[1], RAMP_TABLE_SIZE);
+	node->set_curves(curves);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_color_curves(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::RGBCurvesNode* node = shader_graph->create_node<ccl::RGBCurvesNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::FCurve curve = get_fcurve_parameter_value(xsi_parameters, "Curve", eval_time);
+
+	std::array<float, 2> min_max = get_min_and_max(curve, curve, curve);
+	node->set_min_x(min_max[0]);
+	node->set_max_x(min_max[1]);
+	ccl::array<ccl::float3> curves = three_curves_to_array(curve, curve, curve, min_max[0], min_max[1], RAMP_TABLE_SIZE);
+	node->set_curves(curves);
+
+	return node;	
+}
+
+ccl::ShaderNode* sync_cycles_wavelength(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::WavelengthNode* node = shader_graph->create_node<ccl::WavelengthNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_blackbody(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::BlackbodyNode* node = shader_graph->create_node<ccl::BlackbodyNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_mix_closure(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MixClosureNode* node = shader_graph->create_node<ccl::MixClosureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_add_closure(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::AddClosureNode* node = shader_graph->create_node<ccl::AddClosureNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_combine_color(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::CombineColorNode* node = shader_graph->create_node<ccl::CombineColorNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString mode = get_string_parameter_value(xsi_parameters, "mode", eval_time);
+	node->set_color_type(mode == "rgb" ? ccl::NODE_COMBSEP_COLOR_RGB : (mode == "hsv" ? ccl::NODE_COMBSEP_COLOR_HSV : ccl::NODE_COMBSEP_COLOR_HSL));
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_combine_rgb(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::CombineRGBNode* node = shader_graph->create_node<ccl::CombineRGBNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_combine_hsv(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::CombineHSVNode* node = shader_graph->create_node<ccl::CombineHSVNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_combine_xyz(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::CombineXYZNode* node = shader_graph->create_node<ccl::CombineXYZNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_separate_color(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::SeparateColorNode* node = shader_graph->create_node<ccl::SeparateColorNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString mode = get_string_parameter_value(xsi_parameters, "mode", eval_time);
+	node->set_color_type(mode == "rgb" ? ccl::NODE_COMBSEP_COLOR_RGB : (mode == "hsv" ? ccl::NODE_COMBSEP_COLOR_HSV : ccl::NODE_COMBSEP_COLOR_HSL));
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_separate_rgb(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::SeparateRGBNode* node = shader_graph->create_node<ccl::SeparateRGBNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_separate_hsv(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::SeparateHSVNode* node = shader_graph->create_node<ccl::SeparateHSVNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_separate_xyz(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::SeparateXYZNode* node = shader_graph->create_node<ccl::SeparateXYZNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	float vector_x = get_float_parameter_value(xsi_parameters, "VectorX", eval_time);
+	float vector_y = get_float_parameter_value(xsi_parameters, "VectorY", eval_time);
+	float vector_z = get_float_parameter_value(xsi_parameters, "VectorZ", eval_time);
+
+	node->set_vector(ccl::make_float3(vector_x, vector_y, vector_z));
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_math(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MathNode* node = shader_graph->create_node<ccl::MathNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	bool clamp = get_bool_parameter_value(xsi_parameters, "UseClamp", eval_time);
+
+	node->set_math_type(get_math_type(type));
+	node->set_use_clamp(clamp);
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_vector_math(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VectorMathNode* node = shader_graph->create_node<ccl::VectorMathNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+
+	float vector1_x = get_float_parameter_value(xsi_parameters, "Vector1X", eval_time);
+	float vector1_y = get_float_parameter_value(xsi_parameters, "Vector1Y", eval_time);
+	float vector1_z = get_float_parameter_value(xsi_parameters, "Vector1Z", eval_time);
+
+	float vector2_x = get_float_parameter_value(xsi_parameters, "Vector2X", eval_time);
+	float vector2_y = get_float_parameter_value(xsi_parameters, "Vector2Y", eval_time);
+	float vector2_z = get_float_parameter_value(xsi_parameters, "Vector2Z", eval_time);
+
+	float vector3_x = get_float_parameter_value(xsi_parameters, "Vector3X", eval_time);
+	float vector3_y = get_float_parameter_value(xsi_parameters, "Vector3Y", eval_time);
+	float vector3_z = get_float_parameter_value(xsi_parameters, "Vector3Z", eval_time);
+
+	node->set_math_type(get_vector_math(type));
+	node->set_vector1(ccl::make_float3(vector1_x, vector1_y, vector1_z));
+	node->set_vector2(ccl::make_float3(vector2_x, vector2_y, vector2_z));
+	node->set_vector3(ccl::make_float3(vector3_x, vector3_y, vector3_z));
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_color_ramp(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::RGBRampNode* node = shader_graph->create_node<ccl::RGBRampNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	node->set_interpolate(true);
+	XSI::ShaderParameter gradient_parameter = xsi_parameters.GetItem("Gradient");
+	XSI::ShaderParameter gradient_parameter_final = get_source_parameter(gradient_parameter);
+
+	XSI::CParameterRefArray g_params = gradient_parameter_final.GetParameters();
+	XSI::Parameter markers_parameter = g_params.GetItem("markers");
+	XSI::CParameterRefArray m_params = markers_parameter.GetParameters();
+	std::vector<GradientPoint> gradient_data;
+	for (int i = 0; i < m_params.GetCount(); i++)
+	{
+		XSI::ShaderParameter p = m_params[i];
+		float pos = p.GetParameterValue("pos");
+		float mid = p.GetParameterValue("mid");
+		float r = p.GetParameterValue("red");
+		float g = p.GetParameterValue("green");
+		float b = p.GetParameterValue("blue");
+		float a = p.GetParameterValue("alpha");
+		if (pos > -1)
 		{
-			float t = min + (float)i * range / (float)(steps - 1);
-			curve_mapping_curve[i] = curve.Eval(t);
+			GradientPoint new_data;
+			new_data.pos = pos;
+			new_data.mid = mid;
+			new_data.color = XSI::MATH::CColor4f(r, g, b, a);
+			gradient_data.push_back(new_data);
 		}
-		node->set_curve(curve_mapping_curve);
-
-		return node;
 	}
-	else if (shader_type == "Clamp")
-	{
-		ccl::ClampNode* node = shader_graph->create_node<ccl::ClampNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+	ccl::array<ccl::float3> ramp;
+	ccl::array<float> ramp_alpha;
+	form_ramp(gradient_data, RAMP_TABLE_SIZE, ramp, ramp_alpha);
+	node->set_ramp(ramp);
+	node->set_ramp_alpha(ramp_alpha);
+
+	return node;
+}
 
-		XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
-		node->set_clamp_type(get_clamp_type(type));
+ccl::ShaderNode* sync_cycles_map_range(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::MapRangeNode* node = shader_graph->create_node<ccl::MapRangeNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
 
-		return node;
-	}
-	else if (shader_type == "RGBToBW")
+	bool clamp = get_bool_parameter_value(xsi_parameters, "Clamp", eval_time);
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+
+	node->set_clamp(clamp);
+	node->set_range_type(get_map_range_type(type));
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_vector_map_range(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::VectorMapRangeNode* node = shader_graph->create_node<ccl::VectorMapRangeNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	bool clamp = get_bool_parameter_value(xsi_parameters, "Clamp", eval_time);
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+
+	float from_min_x = get_float_parameter_value(xsi_parameters, "FromMinX", eval_time);
+	float from_min_y = get_float_parameter_value(xsi_parameters, "FromMinY", eval_time);
+	float from_min_z = get_float_parameter_value(xsi_parameters, "FromMinZ", eval_time);
+
+	float from_max_x = get_float_parameter_value(xsi_parameters, "FromMaxX", eval_time);
+	float from_max_y = get_float_parameter_value(xsi_parameters, "FromMaxY", eval_time);
+	float from_max_z = get_float_parameter_value(xsi_parameters, "FromMaxZ", eval_time);
+
+	float to_min_x = get_float_parameter_value(xsi_parameters, "ToMinX", eval_time);
+	float to_min_y = get_float_parameter_value(xsi_parameters, "ToMinY", eval_time);
+	float to_min_z = get_float_parameter_value(xsi_parameters, "ToMinZ", eval_time);
+
+	float to_max_x = get_float_parameter_value(xsi_parameters, "ToMaxX", eval_time);
+	float to_max_y = get_float_parameter_value(xsi_parameters, "ToMaxY", eval_time);
+	float to_max_z = get_float_parameter_value(xsi_parameters, "ToMaxZ", eval_time);
+
+	float step_x = get_float_parameter_value(xsi_parameters, "StepsX", eval_time);
+	float step_y = get_float_parameter_value(xsi_parameters, "StepsY", eval_time);
+	float step_z = get_float_parameter_value(xsi_parameters, "StepsZ", eval_time);
+
+	node->set_use_clamp(clamp);
+	node->set_range_type(get_map_range_type(type));
+
+	node->set_from_min(ccl::make_float3(from_min_x, from_min_y, from_min_z));
+	node->set_from_max(ccl::make_float3(from_max_x, from_max_y, from_max_z));
+	node->set_to_min(ccl::make_float3(to_min_x, to_min_y, to_min_z));
+	node->set_to_max(ccl::make_float3(to_max_x, to_max_y, to_max_z));
+	node->set_steps(ccl::make_float3(step_x, step_y, step_z));
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_float_curve(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::FloatCurveNode* node = shader_graph->create_node<ccl::FloatCurveNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::FCurve curve = get_fcurve_parameter_value(xsi_parameters, "Curve", eval_time);
+	float min = curve.GetKeyAtIndex(0).GetTime();
+	float max = curve.GetKeyAtIndex(curve.GetNumKeys() - 1).GetTime();
+	node->set_min_x(min);
+	node->set_max_x(max);
+
+	ccl::array<float> curve_mapping_curve;
+	int steps = 256;// RAMP_TABLE_SIZE;
+	curve_mapping_curve.resize(steps);
+	const float range = max - min;
+	for (int i = 0; i < steps; i++)
 	{
-		ccl::RGBToBWNode* node = shader_graph->create_node<ccl::RGBToBWNode>();
-		common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+		float t = min + (float)i * range / (float)(steps - 1);
+		curve_mapping_curve[i] = curve.Eval(t);
+	}
+	node->set_curve(curve_mapping_curve);
 
-		return node;
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_clamp(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::ClampNode* node = shader_graph->create_node<ccl::ClampNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	XSI::CString type = get_string_parameter_value(xsi_parameters, "Type", eval_time);
+	node->set_clamp_type(get_clamp_type(type));
+
+	return node;
+}
+
+ccl::ShaderNode* sync_cycles_rgb_to_bw(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs)
+{
+	ccl::RGBToBWNode* node = shader_graph->create_node<ccl::RGBToBWNode>();
+	common_routine(scene, node, shader_graph, nodes_map, xsi_shader, xsi_parameters, eval_time, aovs);
+
+	return node;
+}
+
+// builders for all Cycles shader nodes, key - short name of the node (without Cycles prefix)
+typedef ccl::ShaderNode* (*CyclesShaderBuilder)(ccl::Scene* scene, const XSI::Shader& xsi_shader, const XSI::CString& shader_type, const XSI::CParameterRefArray& xsi_parameters, const XSI::CTime& eval_time, ccl::ShaderGraph* shader_graph, std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map, std::vector<XSI::CStringArray>& aovs);
+
+const std::unordered_map<std::string, CyclesShaderBuilder>& get_cycles_shader_builders()
+{
+	// the map is created once, at the first call
+	static const std::unordered_map<std::string, CyclesShaderBuilder> builders = {
+		{ "DiffuseBSDF", sync_cycles_diffuse_bsdf },
+		{ "MetallicBSDF", sync_cycles_metallic_bsdf },
+		{ "PrincipledBSDF", sync_cycles_principled_bsdf },
+		{ "TranslucentBSDF", sync_cycles_translucent_bsdf },
+		{ "TransparentBSDF", sync_cycles_transparent_bsdf },
+		{ "ToonBSDF", sync_cycles_toon_bsdf },
+		{ "GlossyBSDF", sync_cycles_glossy_bsdf },
+		{ "GlassBSDF", sync_cycles_glass_bsdf },
+		{ "RefractionBSDF", sync_cycles_refraction_bsdf },
+		{ "HairBSDF", sync_cycles_hair_bsdf },
+		{ "Emission", sync_cycles_emission },
+		{ "AmbientOcclusion", sync_cycles_ambient_occlusion },
+		{ "Background", sync_cycles_background },
+		{ "Holdout", sync_cycles_holdout },
+		{ "AbsorptionVolume", sync_cycles_absorption_volume },
+		{ "ScatterVolume", sync_cycles_scatter_volume },
+		{ "PrincipledVolume", sync_cycles_principled_volume },
+		{ "PrincipledHairBSDF", sync_cycles_principled_hair_bsdf },
+		{ "SheenBSDF", sync_cycles_sheen_bsdf },
+		{ "RayPortalBSDF", sync_cycles_ray_portal_bsdf },
+		{ "SubsurfaceScattering", sync_cycles_subsurface_scattering },
+		{ "ImageTexture", sync_cycles_image_texture },
+		{ "EnvironmentTexture", sync_cycles_environment_texture },
+		{ "SkyTexture", sync_cycles_sky_texture },
+		{ "NoiseTexture", sync_cycles_noise_texture },
+		{ "CheckerTexture", sync_cycles_checker_texture },
+		{ "BrickTexture", sync_cycles_brick_texture },
+		{ "GradientTexture", sync_cycles_gradient_texture },
+		{ "VoronoiTexture", sync_cycles_voronoi_texture },
+		{ "MagicTexture", sync_cycles_magic_texture },
+		{ "WaveTexture", sync_cycles_wave_texture },
+		{ "IESTexture", sync_cycles_ies_texture },
+		{ "WhiteNoiseTexture", sync_cycles_white_noise_texture },
+		{ "GaborTexture", sync_cycles_gabor_texture },
+		{ "Normal", sync_cycles_normal },
+		{ "Bump", sync_cycles_bump },
+		{ "Mapping", sync_cycles_mapping },
+		{ "SetNormal", sync_cycles_set_normal },
+		{ "NormalMap", sync_cycles_normal_map },
+		{ "VectorTransform", sync_cycles_vector_transform },
+		{ "VectorRotate", sync_cycles_vector_rotate },
+		{ "VectorCurves", sync_cycles_vector_curves },
+		{ "Displacement", sync_cycles_displacement },
+		{ "VectorDisplacement", sync_cycles_vector_displacement },
+		{ "Geometry", sync_cycles_geometry },
+		{ "TextureCoordinate", sync_cycles_texture_coordinate },
+		{ "LightPath", sync_cycles_light_path },
+		{ "ObjectInfo", sync_cycles_object_info },
+		{ "VolumeInfo", sync_cycles_volume_info },
+		{ "PointInfo", sync_cycles_point_info },
+		{ "ParticleInfo", sync_cycles_particle_info },
+		{ "HairInfo", sync_cycles_hair_info },
+		{ "Value", sync_cycles_value },
+		{ "Color", sync_cycles_color },
+		{ "Attribute", sync_cycles_attribute },
+		{ "OutputColorAOV", sync_cycles_output_color_aov },
+		{ "OutputValueAOV", sync_cycles_output_value_aov },
+		{ "VertexColor", sync_cycles_vertex_color },
+		{ "Bevel", sync_cycles_bevel },
+		{ "UVMap", sync_cycles_uv_map },
+		{ "Camera", sync_cycles_camera },
+		{ "Fresnel", sync_cycles_fresnel },
+		{ "LayerWeight", sync_cycles_layer_weight },
+		{ "Wireframe", sync_cycles_wireframe },
+		{ "Tangent", sync_cycles_tangent },
+		{ "LightFalloff", sync_cycles_light_falloff },
+		{ "Invert", sync_cycles_invert },
+		{ "MixRGB", sync_cycles_mix_rgb },
+		{ "MixColor", sync_cycles_mix_color },
+		{ "MixFloat", sync_cycles_mix_float },
+		{ "MixVector", sync_cycles_mix_vector },
+		{ "MixVectorNonUniform", sync_cycles_mix_vector_non_uniform },
+		{ "Gamma", sync_cycles_gamma },
+		{ "BrightContrast", sync_cycles_bright_contrast },
+		{ "HSV", sync_cycles_hsv },
+		{ "RGBCurves", sync_cycles_rgb_curves },
+		{ "ColorCurves", sync_cycles_color_curves },
+		{ "Wavelength", sync_cycles_wavelength },
+		{ "Blackbody", sync_cycles_blackbody },
+		{ "MixClosure", sync_cycles_mix_closure },
+		{ "AddClosure", sync_cycles_add_closure },
+		{ "CombineColor", sync_cycles_combine_color },
+		{ "CombineRGB", sync_cycles_combine_rgb },
+		{ "CombineHSV", sync_cycles_combine_hsv },
+		{ "CombineXYZ", sync_cycles_combine_xyz },
+		{ "SeparateColor", sync_cycles_separate_color },
+		{ "SeparateRGB", sync_cycles_separate_rgb },
+		{ "SeparateHSV", sync_cycles_separate_hsv },
+		{ "SeparateXYZ", sync_cycles_separate_xyz },
+		{ "Math", sync_cycles_math },
+		{ "VectorMath", sync_cycles_vector_math },
+		{ "ColorRamp", sync_cycles_color_ramp },
+		{ "MapRange", sync_cycles_map_range },
+		{ "VectorMapRange", sync_cycles_vector_map_range },
+		{ "FloatCurve", sync_cycles_float_curve },
+		{ "Clamp", sync_cycles_clamp },
+		{ "RGBToBW", sync_cycles_rgb_to_bw },
+	};
+
+	return builders;
+}
+
+ccl::ShaderNode* sync_cycles_shader(ccl::Scene* scene, 
+	const XSI::Shader& xsi_shader,
+	const XSI::CString &shader_type, 
+	const XSI::CParameterRefArray &xsi_parameters,
+	const XSI::CTime &eval_time, 
+	ccl::ShaderGraph* shader_graph, 
+	std::unordered_map<ULONG, ccl::ShaderNode*>& nodes_map,
+	std::vector<XSI::CStringArray>& aovs)
+{
+	const std::unordered_map<std::string, CyclesShaderBuilder>& builders = get_cycles_shader_builders();
+	auto it = builders.find(shader_type.GetAsciiString());
+	if (it != builders.end())
+	{
+		return it->second(scene, xsi_shader, shader_type, xsi_parameters, eval_time, shader_graph, nodes_map, aovs);
 	}
 
 	return NULL;
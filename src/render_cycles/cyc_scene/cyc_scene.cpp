@@ -8,8 +8,10 @@
 #include "scene/pointcloud.h"
 #include "scene//light.h"
 #include "util/hash.h"
+#include "util/tbb.h"
 
 #include <unordered_set>
+#include <unordered_map>
 
 #include <xsi_renderercontext.h>
 #include <xsi_primitive.h>
@@ -295,7 +297,13 @@ void sync_shaderball_scene(ccl::Scene* scene, UpdateContext* update_context, con
 
 			xsi_material_id = xsi_material.GetObjectID();
 
-			shader_index = sync_material(scene, xsi_material, eval_time, aovs);
+			std::string graph_hash;
+			std::string displacement_hash;
+			shader_index = sync_material(scene, xsi_material, eval_time, aovs, graph_hash, displacement_hash);
+			if (shader_index >= 0)
+			{
+				update_context->add_shader_graph_hash(shader_index, graph_hash, displacement_hash);
+			}
 		}
 		else if (shaderball_type == ShaderballType_SurfaceShader)
 		{
@@ -532,7 +540,7 @@ void sync_instance_children(ccl::Scene* scene, UpdateContext* update_context, co
 			{
 				ccl::Object* vdb_object = scene->create_node<ccl::Object>();
 				XSI::CustomPrimitive xsi_prim(xsi_object.GetActivePrimitive(eval_time));
-				ccl::Volume* vdb_geom = sync_vdb_volume_object(scene, vdb_object, update_context, xsi_object, get_vdb_data(xsi_prim));
+				ccl::Volume* vdb_geom = sync_vdb_volume_object(scene, vdb_object, update_context, xsi_object, *get_vdb_data(xsi_prim, eval_time));
 				vdb_object->set_geometry(vdb_geom);
 
 				size_t object_index = scene->objects.size() - 1;
@@ -640,6 +648,15 @@ void sync_instance_model(ccl::Scene* scene, UpdateContext* update_context, const
 	sync_instance_model(scene, update_context, instance_model, { XSI::MATH::CTransformation() }, {}, 0);
 }
 
+// cached data for reference shapes of the pointcloud
+// all points with the same reference shape use the same master object, so, get children and kinematics only once
+struct PointcloudInstanceReference
+{
+	XSI::CRefArray children;
+	XSI::KinematicState master_kine;
+	ULONG master_id;
+};
+
 void sync_poitcloud_instances(ccl::Scene* scene, UpdateContext* update_context, XSI::X3DObject& xsi_object, const std::vector<XSI::MATH::CTransformation>& root_tfms)
 {
 	XSI::CTime eval_time = update_context->get_time();
@@ -669,22 +686,10 @@ void sync_poitcloud_instances(ccl::Scene* scene, UpdateContext* update_context,
 	XSI::CICEAttributeDataArrayShape shape_data;
 	shape_attribute.GetDataArray(shape_data);
 
-	XSI::ICEAttribute position_attribute = xsi_geometry.GetICEAttributeFromName("PointPosition");
-	XSI::CICEAttributeDataArrayVector3f position_data;
-	position_attribute.GetDataArray(position_data);
-
-	XSI::ICEAttribute orientation_attribute = xsi_geometry.GetICEAttributeFromName("Orientation");
-	XSI::CICEAttributeDataArrayRotationf rotation_data;
-	orientation_attribute.GetDataArray(rotation_data);
-
 	XSI::ICEAttribute size_attribute = xsi_geometry.GetICEAttributeFromName("Size");
 	XSI::CICEAttributeDataArrayFloat size_data;
 	size_attribute.GetDataArray(size_data);
 
-	XSI::ICEAttribute scale_attribute = xsi_geometry.GetICEAttributeFromName("Scale");
-	XSI::CICEAttributeDataArrayVector3f scale_data;
-	scale_attribute.GetDataArray(scale_data);
-
 	XSI::ICEAttribute color_attribute = xsi_geometry.GetICEAttributeFromName("Color");
 	XSI::CICEAttributeDataArrayColor4f color_data;
 	color_attribute.GetDataArray(color_data);
@@ -709,144 +714,184 @@ void sync_poitcloud_instances(ccl::Scene* scene, UpdateContext* update_context,
 	angular_velocity_attribute.GetDataArray(angular_velocity_data);
 	ULONG angular_velocity_data_count = angular_velocity_data.GetCount();
 
-	size_t shape_data_count = shape_data.GetCount();
-	int scale_count = scale_attribute.GetElementCount();
-	bool is_scale_define = scale_attribute.IsDefined();
+	// transforms of all valid points at the current time, computed in parallel
+	std::vector<ULONG> valid_points;
+	std::vector<XSI::MATH::CTransformation> current_points_tfms = build_points_transforms(xsi_geometry, valid_points);
+	size_t valid_points_count = valid_points.size();
+	if (valid_points_count == 0)
+	{
+		return;
+	}
 
 	// array of transforms for points
 	// the first array - for the first motion step (contains all point), the second array - for the second step and so on
 	// if array contains only one array, then there are no motions
 	std::vector<std::vector<XSI::MATH::CTransformation>> time_points_tfms = build_time_points_transforms(xsi_object, motion_times);
 
-	XSI::KinematicState pointcloud_kine = xsi_object.GetKinematics().GetGlobal();
+	// root transforms are the same for all points, so get it once for each time
+	std::vector<XSI::MATH::CTransformation> time_root_tfms(motion_times_count);
+	for (size_t t = 0; t < motion_times_count; t++)
+	{
+		// if root transforms are not empty, then use it instead of real pointcloud root transfrom
+		// because it contains particles transforms
+		time_root_tfms[t] = use_root_tfm ? root_tfms[t] : xsi_object.GetKinematics().GetGlobal().GetTransform(motion_times[t]);
+	}
+
+	// apply root transforms to all point transforms in parallel
+	for (size_t t = 0; t < motion_times_count; t++)
+	{
+		std::vector<XSI::MATH::CTransformation>& tfms = time_points_tfms[t];
+		const XSI::MATH::CTransformation& root_tfm = time_root_tfms[t];
+		ccl::parallel_for((size_t)0, tfms.size(), [&](size_t k)
+		{
+			tfms[k].MulInPlace(root_tfm);
+		});
+	}
 
 	// create the particle system for pointcloud
 	ccl::ParticleSystem* psys = scene->create_node<ccl::ParticleSystem>();
 	psys->particles.clear();
+	// each point creates at least one object and one particle
+	psys->particles.reserve(valid_points_count);
+	scene->objects.reserve(scene->objects.size() + valid_points_count);
 	psys->tag_update(scene);
-	
-	size_t export_point_index = 0;
-	for (size_t i = 0; i < shape_data_count; i++)
+
+	size_t shader_index = get_pointcloud_shader_index(scene, update_context, xsi_object);
+	ccl::Object* shape_template_object = NULL;
+	bool unique_pass_id = update_context->get_current_render_parameters().GetValue("output_pass_assign_unique_pass_id", eval_time);
+	std::unordered_map<ULONG, PointcloudInstanceReference> references_map;
+	std::unordered_map<ccl::Geometry*, bool> need_particle_map;
+
+	std::vector<XSI::MATH::CTransformation> point_tfms(motion_times_count);
+	for (size_t export_point_index = 0; export_point_index < valid_points_count; export_point_index++)
 	{
-		XSI::siICEShapeType shape_type = shape_data[i].GetType();
-		if (is_valid_shape(shape_type))
+		ULONG i = valid_points[export_point_index];
+		XSI::MATH::CShape shape = shape_data[i];
+		XSI::siICEShapeType shape_type = shape.GetType();
+
+		// if time_points_tfms contains only one array, then elements of this array are actual transforms for all points
+		// if it contains several arrays, then these arrays are transforms for all valid points in different times
+		// index i is index of the point in pointcloud, but it can be invalid
+		// so, we should check with export_point_index index value in predefined transforms array
+		// time_points_tfms contains array of times, each time contains array of point transforms
+		const XSI::MATH::CTransformation& current_point_tfm = current_points_tfms[export_point_index];
+		for (size_t t = 0; t < motion_times_count; t++)
 		{
-			// if time_points_tfms contains only one array, then elements of this array are actual transforms for all points
-			// if it contains several arrays, then these arrays are transforms for all valid points in different times
-			// index i is index of the point in pointcloud, but it can be invalid
-			// so, we should check with export_point_index index value in predefined transforms array
-			// time_points_tfms contains array of times, each time contains array of point transforms
-			XSI::MATH::CTransformation current_point_tfm = build_point_transform(position_data[i], rotation_data[i], size_data[i], i < scale_count ? scale_data[i] : XSI::MATH::CVector3f(1.0f, 1.0f, 1.0f), is_scale_define);
-
-			std::vector<XSI::MATH::CTransformation> point_tfms(motion_times_count);
-			for (size_t t = 0; t < motion_times_count; t++)
+			// use array of transforms at time t
+			if (time_points_tfms[t].size() > export_point_index)
 			{
-				// use array of transforms at time t
-				if (time_points_tfms[t].size() > export_point_index)
-				{
-					point_tfms[t] = time_points_tfms[t][export_point_index];
-				}
-				else
-				{
-					// there is no point transform at time t
-					// at time t the number of valid points less then current index export_point_index
-					// use current transform
-					// WARNING: this produce incorrect result when there are different number of particels during the time
-					// all particles rendered at the end position without motion blur
-					point_tfms[t] = current_point_tfm;
-				}
-				
-				if (use_root_tfm)
-				{
-					// if root transforms are not empty, then use it instead of real pointcloud root transfrom
-					// because it contains particles transforms
-					point_tfms[t].MulInPlace(root_tfms[t]);
-				}
-				else
-				{
-					// apply pointcloud root transform to each time transform
-					point_tfms[t].MulInPlace(xsi_object.GetKinematics().GetGlobal().GetTransform(motion_times[t]));
-				}
+				point_tfms[t] = time_points_tfms[t][export_point_index];
 			}
+			else
+			{
+				// there is no point transform at time t
+				// at time t the number of valid points less then current index export_point_index
+				// use current transform
+				// WARNING: this produce incorrect result when there are different number of particels during the time
+				// all particles rendered at the end position without motion blur
+				point_tfms[t] = current_point_tfm;
+				point_tfms[t].MulInPlace(time_root_tfms[t]);
+			}
+		}
 
-			XSI::MATH::CColor4f point_color = color_data[i];
-
-			// increase index of exported point
-			export_point_index++;
+		XSI::MATH::CColor4f point_color = color_data[i];
 
-			size_t start_objects_index = scene->objects.size();
-			if (shape_type == XSI::siICEShapeReference)
+		size_t start_objects_index = scene->objects.size();
+		if (shape_type == XSI::siICEShapeReference)
+		{
+			bool is_branch_selected = shape.IsBranchSelected();  // if true, then we should export the whole hierarchy, if false - then only the root object
+			ULONG shape_ref_id = shape.GetReferenceID();
+			// use different keys for branch and non-branch selection of the same object
+			ULONG reference_key = 2 * shape_ref_id + (is_branch_selected ? 1 : 0);
+			auto reference_it = references_map.find(reference_key);
+			if (reference_it == references_map.end())
 			{
-				XSI::MATH::CShape shape = shape_data[i];
-				bool is_branch_selected = shape.IsBranchSelected();  // if true, then we should export the whole hierarchy, if false - then only the root object
-				ULONG shape_ref_id = shape.GetReferenceID();
 				XSI::X3DObject master_root = (XSI::X3DObject)XSI::Application().GetObjectFromID(shape_ref_id);
 
-				// now we are ready to create instance of the root object
-				XSI::CRefArray children = get_instance_children(master_root, is_branch_selected);
+				PointcloudInstanceReference reference;
+				reference.children = get_instance_children(master_root, is_branch_selected);
+				reference.master_kine = master_root.GetKinematics().GetGlobal();
+				reference.master_id = master_root.GetObjectID();
+
 				// add all children ids to abort update transforms inside update context
-				update_context->add_abort_update_transform_id(children);
-
-				sync_instance_children(scene,  // scene
-					update_context,  // update context
-					children,  // children array
-					master_root.GetKinematics().GetGlobal(),  // masster object kine
-					master_root.GetObjectID(),  // master object id
-					point_tfms,  // array with global transforms of the instance root
-					{},  // path for nested instances, contains master ids
-					xsi_object.GetObjectID(),  // instance root object id
-					// here is a problem, because one pointcloud play the role of several root instances
-					// there are no actual instance root, because this is a point in the cloud
-					// this id used to construct the path for update instance transforms
-					update_context->get_need_motion(),  // use motion
-					update_context->get_motion_times(),  // motion times
-					update_context->get_main_motion_step(),  // main motion step
-					eval_time);
+				update_context->add_abort_update_transform_id(reference.children);
+
+				reference_it = references_map.emplace(reference_key, reference).first;
 			}
-			else
+			const PointcloudInstanceReference& reference = reference_it->second;
+
+			// now we are ready to create instance of the root object
+			sync_instance_children(scene,  // scene
+				update_context,  // update context
+				reference.children,  // children array
+				reference.master_kine,  // masster object kine
+				reference.master_id,  // master object id
+				point_tfms,  // array with global transforms of the instance root
+				{},  // path for nested instances, contains master ids
+				xsi_object.GetObjectID(),  // instance root object id
+				// here is a problem, because one pointcloud play the role of several root instances
+				// there are no actual instance root, because this is a point in the cloud
+				// this id used to construct the path for update instance transforms
+				update_context->get_need_motion(),  // use motion
+				motion_times,  // motion times
+				update_context->get_main_motion_step(),  // main motion step
+				eval_time);
+		}
+		else
+		{
+			// the first primitive shape read object parameters from the pointcloud, all others copy it
+			ccl::Object* point_object = scene->create_node<ccl::Object>();
+			sync_point_primitive_shape(scene, point_object, update_context, shape_type, shader_index, point_color, point_tfms, xsi_object, eval_time, unique_pass_id, shape_template_object);
+			if (shape_template_object == NULL)
 			{
-				ccl::Object* point_object = scene->create_node<ccl::Object>();
-				sync_point_primitive_shape(scene, point_object, update_context, shape_type, point_color, point_tfms, xsi_object, eval_time);
+				shape_template_object = point_object;
 			}
+		}
 
-			// add additional attributes to all newly created objects
-			size_t objects_count = scene->objects.size();
-			for (size_t object_index = start_objects_index; object_index < objects_count; object_index++)
-			{
-				ccl::Object* new_object = scene->objects[object_index];
+		// add additional attributes to all newly created objects
+		size_t objects_count = scene->objects.size();
+		for (size_t object_index = start_objects_index; object_index < objects_count; object_index++)
+		{
+			ccl::Object* new_object = scene->objects[object_index];
 
-				// if we would like not override colors for child pointclouds, then use custom property
-				// it's hard properly define when override should be by default
-				if (override_color)
-				{
-					// override object colors by color from the point
-					// for primitives we will make it twise, it does not matter
-					new_object->set_color(color4_to_float3(point_color));
-					new_object->set_alpha(point_color.GetA());
+			// if we would like not override colors for child pointclouds, then use custom property
+			// it's hard properly define when override should be by default
+			if (override_color)
+			{
+				// override object colors by color from the point
+				// for primitives we will make it twise, it does not matter
+				new_object->set_color(color4_to_float3(point_color));
+				new_object->set_alpha(point_color.GetA());
 
-					new_object->tag_color_modified();
-					new_object->tag_alpha_modified();
-				}
+				new_object->tag_color_modified();
+				new_object->tag_alpha_modified();
+			}
 
-				// next define particle attributes
-				if (new_object->get_geometry()->need_attribute(scene, ccl::ATTR_STD_PARTICLE))
-				{
-					ccl::Particle pa;
-					pa.index = i;
-					if (i < age_data_count) { pa.age = age_data[i]; } else { pa.age = 0.0f; }
-					if (i < lifetime_data_count) { pa.lifetime = lifetime_data[i]; } else { pa.lifetime = 0.0f; }
-					pa.location = vector3_to_float3(current_point_tfm.GetTranslation());
-					XSI::MATH::CQuaternion q = current_point_tfm.GetRotationQuaternion();
-					pa.rotation = quaternion_to_float4(q);
-					pa.size = size_data[i];
-					if (i < velocity_data_count) { pa.velocity = vector3_to_float3(velocity_data[i]); } else { pa.velocity = ccl::make_float3(0.0, 0.0, 0.0); }
-					if (i < angular_velocity_data_count) { pa.angular_velocity = rotation_to_float3(angular_velocity_data[i]); } else { pa.angular_velocity = ccl::make_float3(0.0, 0.0, 0.0); }
-
-					psys->particles.push_back_slow(pa);
-
-					new_object->set_particle_system(psys);
-					new_object->set_particle_index(psys->particles.size() - 1);
-				}
+			// next define particle attributes
+			// many objects share the same geometry, so check it only once for each geometry
+			ccl::Geometry* new_geometry = new_object->get_geometry();
+			auto need_particle_it = need_particle_map.find(new_geometry);
+			if (need_particle_it == need_particle_map.end())
+			{
+				need_particle_it = need_particle_map.emplace(new_geometry, new_geometry->need_attribute(scene, ccl::ATTR_STD_PARTICLE)).first;
+			}
+			if (need_particle_it->second)
+			{
+				ccl::Particle pa;
+				pa.index = i;
+				if (i < age_data_count) { pa.age = age_data[i]; } else { pa.age = 0.0f; }
+				if (i < lifetime_data_count) { pa.lifetime = lifetime_data[i]; } else { pa.lifetime = 0.0f; }
+				pa.location = vector3_to_float3(current_point_tfm.GetTranslation());
+				XSI::MATH::CQuaternion q = current_point_tfm.GetRotationQuaternion();
+				pa.rotation = quaternion_to_float4(q);
+				pa.size = size_data[i];
+				if (i < velocity_data_count) { pa.velocity = vector3_to_float3(velocity_data[i]); } else { pa.velocity = ccl::make_float3(0.0, 0.0, 0.0); }
+				if (i < angular_velocity_data_count) { pa.angular_velocity = rotation_to_float3(angular_velocity_data[i]); } else { pa.angular_velocity = ccl::make_float3(0.0, 0.0, 0.0); }
+
+				psys->particles.push_back_slow(pa);
+
+				new_object->set_particle_system(psys);
+				new_object->set_particle_index(psys->particles.size() - 1);
 			}
 		}
 	}
@@ -994,7 +1039,7 @@ void sync_scene_object(ccl::Scene* scene, UpdateContext* update_context, const X
 			{
 				ccl::Object* vdb_object = scene->create_node<ccl::Object>();
 				XSI::CustomPrimitive xsi_prim(xsi_object.GetActivePrimitive(eval_time));
-				ccl::Volume* vdb_geom = sync_vdb_volume_object(scene, vdb_object, update_context, xsi_object, get_vdb_data(xsi_prim));
+				ccl::Volume* vdb_geom = sync_vdb_volume_object(scene, vdb_object, update_context, xsi_object, *get_vdb_data(xsi_prim, eval_time));
 				vdb_object->set_geometry(vdb_geom);
 
 				update_context->add_object_index(xsi_id, scene->objects.size() - 1);
@@ -1026,8 +1071,6 @@ void sync_scene(ccl::Scene* scene, UpdateContext* update_context, const XSI::CRe
 	XSI::CTime eval_time = update_context->get_time();
 	XSI::CParameterRefArray render_parameters = update_context->get_current_render_parameters();
 
-	sync_scene_materials(scene, update_context);
-
 	sync_camera(scene, update_context);
 
 	if (isolation_list.GetCount() > 0)
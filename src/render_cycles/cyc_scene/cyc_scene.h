@@ -56,14 +56,18 @@ void log_all_shaders();
 // for test only, create some default shader and return the index in the sahders array
 int create_default_shader(ccl::Scene* scene);
 int create_emission_checker(ccl::Scene* scene, float checker_scale);
-int sync_material(ccl::Scene* scene, const XSI::Material& xsi_material, const XSI::CTime& eval_time, std::vector<XSI::CStringArray>& aovs);  // return shader index in the Cycles shaders array
+// return shader index in the Cycles shaders array, out hashes are the same as update_material compares
+int sync_material(ccl::Scene* scene, const XSI::Material& xsi_material, const XSI::CTime& eval_time, std::vector<XSI::CStringArray>& aovs, std::string& out_graph_hash, std::string& out_displacement_hash);
 int sync_shaderball_shadernode(ccl::Scene* scene, const XSI::Shader& xsi_shader, bool is_surface, const XSI::CTime& eval_time);
 int sync_shaderball_texturenode(ccl::Scene* scene, const XSI::Texture& xsi_texture, const XSI::CTime& eval_time);
-void sync_scene_materials(ccl::Scene* scene, UpdateContext* update_context);
-XSI::CStatus update_material(ccl::Scene* scene, const XSI::Material& xsi_material, size_t shader_index, const XSI::CTime& eval_time, std::vector<XSI::CStringArray>& aovs);
+// if the exported graph is the same as the current graph of the shader, then the shader is not changed
+// out_update_displacement is true if the part of the graph, connected to the displacement output, is changed
+XSI::CStatus update_material(ccl::Scene* scene, UpdateContext* update_context, const XSI::Material& xsi_material, size_t shader_index, const XSI::CTime& eval_time, std::vector<XSI::CStringArray>& aovs, bool& out_update_displacement);
 XSI::CStatus update_shaderball_shadernode(ccl::Scene* scene, ULONG xsi_id, ShaderballType shaderball_type, size_t shader_index, const XSI::CTime& eval_time);
 bool get_material_id_from_name(const XSI::CString& material_identificator, ULONG& io_id);
 XSI::CStatus sync_missed_material(ccl::Scene* scene, UpdateContext* update_context, int material_id);
+// export the material, if it is not exported yet, return true if the material is exported (and can be used by the object)
+bool sync_used_material(ccl::Scene* scene, UpdateContext* update_context, const XSI::Material& xsi_material);
 
 // cyc_shaderball
 void sync_shaderball_background_object(ccl::Scene* scene, UpdateContext* update_context, const XSI::X3DObject& xsi_object, ShaderballType shaderball_type);
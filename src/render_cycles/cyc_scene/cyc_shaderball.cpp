@@ -101,9 +101,12 @@ void sync_shaderball_background_object(ccl::Scene* scene, UpdateContext* update_
 			if (!update_context->is_material_exists(xsi_material_id))
 			{
 				// sync this material
-				int shader_index = sync_material(scene, xsi_material, eval_time, aovs);
+				std::string graph_hash;
+				std::string displacement_hash;
+				int shader_index = sync_material(scene, xsi_material, eval_time, aovs, graph_hash, displacement_hash);
 				if (shader_index >= 0)
 				{
+					update_context->add_shader_graph_hash(shader_index, graph_hash, displacement_hash);
 					// here we assume that background object use material without displacement
 					// in any case it never updates, because it's impossible to change material of the background object in the shaderball
 					update_context->add_material_index(xsi_material_id, shader_index, false, ShaderballType_Unknown);
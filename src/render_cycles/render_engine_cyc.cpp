@@ -18,6 +18,7 @@
 #include "cyc_scene/cyc_scene.h"
 #include "cyc_output/output_drivers.h"
 #include "cyc_scene/cyc_geometry/cyc_geometry.h"
+#include "cyc_scene/cyc_loaders/cyc_loaders.h"
 #include "../utilities/logs.h"
 #include "../output/write_image.h"
 #include "../utilities/arrays.h"
@@ -50,6 +51,7 @@ RenderEngineCyc::RenderEngineCyc()
 RenderEngineCyc::~RenderEngineCyc()
 {
 	clear_session();
+	stop_image_prefetch();
 	delete output_context;
 	delete labels_context;
 	delete color_transform_context;
@@ -77,6 +79,12 @@ void RenderEngineCyc::path_init(const XSI::CString& plugin_path)
 void RenderEngineCyc::clear_session()
 {
 	update_context->clear_temp_path();
+	// prefetched images are used only by the next frame of the final render
+	// for all other render types release them together with the session
+	if (render_type != RenderType_Pass)
+	{
+		stop_image_prefetch();
+	}
 	if (is_session)
 	{
 		session->cancel(true);
@@ -753,9 +761,11 @@ XSI::CStatus RenderEngineCyc::update_scene(XSI::Material& xsi_material, bool mat
 		std::vector<XSI::CStringArray> aovs(2);
 		aovs[0].Clear();
 		aovs[1].Clear();
-		is_update = update_material(session->scene.get(), xsi_material, update_context->get_xsi_material_cycles_index(material_id), update_context->get_time(), aovs);
+		bool is_update_displacement = false;
+		is_update = update_material(session->scene.get(), update_context, xsi_material, update_context->get_xsi_material_cycles_index(material_id), update_context->get_time(), aovs, is_update_displacement);
 
-		if (update_context->is_displacement_material(material_id))
+		// re-export objects only if the displacement part of the material is changed
+		if (is_update_displacement && update_context->is_displacement_material(material_id))
 		{
 			// get all objects, used by this material
 			XSI::CRefArray used_objects = xsi_material.GetUsedBy();
@@ -830,8 +840,16 @@ XSI::CStatus RenderEngineCyc::update_scene_render()
 // here we create the scene for rendering from scratch
 XSI::CStatus RenderEngineCyc::create_scene()
 {
+	// before removing the old scene move exported geometries into the cache
+	// if the data of some objects is not changed, then these geometries will be reused in the new scene
+	if (is_session && render_type != RenderType_Shaderball)
+	{
+		update_context->store_geometry_cache(session->scene.get());
+	}
 	clear_session();
 	session = create_session(session_params, scene_params);
+	// prefetch the next frame of image sequences only when the render sequence has this frame
+	set_use_image_prefetch(render_type == RenderType_Pass && m_render_context.GetSequenceIndex() + 1 < m_render_context.GetSequenceLength());
 
 	is_session = true;
 	create_new_scene = true;
@@ -863,6 +881,7 @@ XSI::CStatus RenderEngineCyc::create_scene()
 			sync_baking(session->scene.get(), update_context, baking_context, baking_object, baking_uv, image_full_size_width, image_full_size_height);
 		}
 	}
+	update_context->finish_geometry_cache();
 	is_update_camera = true;
 
 	// setup callbacks
@@ -1082,6 +1101,12 @@ XSI::CStatus RenderEngineCyc::post_render_engine()
 	// remove temp directory (if it exists)
 	// remove_temp_path(temp_path);
 
+	// when the final render or the last frame of the sequence is done, prefetched images will not be used
+	if (render_type == RenderType_Pass && m_render_context.GetSequenceIndex() + 1 >= m_render_context.GetSequenceLength())
+	{
+		stop_image_prefetch();
+	}
+
 	// clear output context object
 	output_context->reset();
 
@@ -1113,4 +1138,5 @@ void RenderEngineCyc::abort()
 void RenderEngineCyc::clear_engine()
 {
 	clear_session();
+	stop_image_prefetch();
 }
\ No newline at end of file
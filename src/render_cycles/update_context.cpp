@@ -65,6 +65,8 @@ void UpdateContext::reset()
 	xsi_geometry_from_instance_map.clear();
 	xsi_geometry_id_to_instance_map.clear();
 	geometry_xsi_to_cyc.clear();
+	geometry_xsi_hash.clear();
+	shader_graph_hashes.clear();
 	object_xsi_to_cyc.clear();
 
 	abort_update_transforms_ids.clear();
@@ -552,6 +554,69 @@ size_t UpdateContext::get_geometry_index(ULONG xsi_id)
 	return geometry_xsi_to_cyc[xsi_id];
 }
 
+void UpdateContext::add_geometry_hash(ULONG xsi_id, uint64_t hash)
+{
+	geometry_xsi_hash[xsi_id] = hash;
+}
+
+bool UpdateContext::is_geometry_hash_equal(ULONG xsi_id, uint64_t hash)
+{
+	auto it = geometry_xsi_hash.find(xsi_id);
+	return it != geometry_xsi_hash.end() && it->second == hash;
+}
+
+void UpdateContext::add_shader_graph_hash(size_t shader_index, const std::string& graph_hash, const std::string& displacement_hash)
+{
+	shader_graph_hashes[shader_index] = { graph_hash, displacement_hash };
+}
+
+bool UpdateContext::is_shader_graph_hash_equal(size_t shader_index, const std::string& graph_hash)
+{
+	auto it = shader_graph_hashes.find(shader_index);
+	return it != shader_graph_hashes.end() && it->second.first == graph_hash;
+}
+
+bool UpdateContext::is_shader_displacement_hash_equal(size_t shader_index, const std::string& displacement_hash)
+{
+	auto it = shader_graph_hashes.find(shader_index);
+	return it != shader_graph_hashes.end() && it->second.second == displacement_hash;
+}
+
+void UpdateContext::store_geometry_cache(ccl::Scene* scene)
+{
+	geometry_cache.clear();
+	for (const auto& [xsi_id, hash] : geometry_xsi_hash)
+	{
+		if (geometry_xsi_to_cyc.contains(xsi_id))
+		{
+			size_t geo_index = geometry_xsi_to_cyc[xsi_id];
+			if (geo_index < scene->geometry.size())
+			{
+				geometry_cache.add(xsi_id, hash, scene->geometry[geo_index]);
+			}
+		}
+	}
+}
+
+bool UpdateContext::restore_cached_geometry(ULONG xsi_id, uint64_t hash, ccl::Geometry* geometry)
+{
+	return geometry_cache.restore(xsi_id, hash, geometry);
+}
+
+void UpdateContext::finish_geometry_cache()
+{
+	if (geometry_cache.get_is_active())
+	{
+		log_message("Geometry cache: " + XSI::CString((ULONG)geometry_cache.get_hits()) + " hits, " + XSI::CString((ULONG)geometry_cache.get_misses()) + " misses");
+	}
+	geometry_cache.clear();
+}
+
+bool UpdateContext::get_use_geometry_hash()
+{
+	return geometry_cache.get_is_active() || render_type == RenderType_Region;
+}
+
 void UpdateContext::add_object_index(ULONG xsi_id, size_t cyc_index)
 {
 	if (object_xsi_to_cyc.contains(xsi_id))
@@ -15,6 +15,7 @@
 #include "../render_cycles/cyc_scene/cyc_motion.h"
 #include "../render_base/type_enums.h"
 #include "cyc_scene/cyc_loaders/cyc_loaders.h"
+#include "cyc_scene/cyc_geometry/cyc_geometry_cache.h"
 
 class UpdateContext
 {
@@ -107,6 +108,24 @@ public:
 	bool is_geometry_exists(ULONG xsi_id);
 	size_t get_geometry_index(ULONG xsi_id);
 
+	void add_geometry_hash(ULONG xsi_id, uint64_t hash);
+	// return true if the geometry with the same hash is already exported into the current scene
+	bool is_geometry_hash_equal(ULONG xsi_id, uint64_t hash);
+	// move geometries from the scene into the cache, call it before the session is removed
+	void store_geometry_cache(ccl::Scene* scene);
+	// return true if the geometry is restored from the cache
+	bool restore_cached_geometry(ULONG xsi_id, uint64_t hash, ccl::Geometry* geometry);
+	// log statistics and clear all unused cached geometries
+	void finish_geometry_cache();
+	// return true if geometry hashes should be computed at export
+	// it is required only if the cache contains geometries from the previous scene or the scene can be recreated later at the same frame (in the render region)
+	bool get_use_geometry_hash();
+
+	void add_shader_graph_hash(size_t shader_index, const std::string& graph_hash, const std::string& displacement_hash);
+	// return true if the shader already use the graph with the same hash
+	bool is_shader_graph_hash_equal(size_t shader_index, const std::string& graph_hash);
+	bool is_shader_displacement_hash_equal(size_t shader_index, const std::string& displacement_hash);
+
 	void add_object_index(ULONG xsi_id, size_t cyc_index);
 	bool is_object_exists(ULONG xsi_id);
 	std::vector<size_t> get_object_cycles_indexes(ULONG xsi_id);
@@ -234,6 +253,17 @@ private:
 	// value - index in cycles geometry array, for different instances we should use the same geometry
 	std::unordered_map<ULONG, size_t> geometry_xsi_to_cyc;
 
+	// key - id of the xsi primitive, value - hash of the data, used for export the geometry
+	std::unordered_map<ULONG, uint64_t> geometry_xsi_hash;
+
+	// store here geometries from the previous session, when it recreated
+	// it does not cleared at reset, because reset called between removing old session and creating the new one
+	GeometryCache geometry_cache;
+
+	// key - index of the Cycles shader
+	// value - hashes of the exported shader graph and the part of the graph, connected to the displacement output
+	std::unordered_map<size_t, std::pair<std::string, std::string>> shader_graph_hashes;
+
 	// this map from object id to index in cycles objects array
 	// value is array because it should contains indexes for all instance copies of the given xsi object
 	std::unordered_map<ULONG, std::vector<size_t>> object_xsi_to_cyc;
@@ -2,6 +2,9 @@
 #include <windows.h>
 #include <filesystem>
 #include <map>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
 #include <cstdio>
 
 #include <xsi_application.h>
@@ -80,6 +83,45 @@ void remove_temp_path(const XSI::CString &temp_path)
 	}
 }
 
+// cached listings of directories with tile images
+// key - directory path, the listing is valid while modification time of the directory is the same
+// (it changed when files are added, removed or renamed)
+struct DirectoryListing
+{
+	std::filesystem::file_time_type write_time;
+	std::vector<std::string> files;  // generic paths of all files in the directory
+};
+std::unordered_map<std::string, DirectoryListing> directory_listings;
+
+const std::vector<std::string>& get_directory_files(const std::filesystem::path& directory_path)
+{
+	static const std::vector<std::string> empty_files;
+
+	std::error_code error;
+	std::filesystem::file_time_type write_time = std::filesystem::last_write_time(directory_path, error);
+	if (error)
+	{
+		return empty_files;
+	}
+
+	std::string directory_string = directory_path.generic_string();
+	auto it = directory_listings.find(directory_string);
+	if (it != directory_listings.end() && it->second.write_time == write_time)
+	{
+		return it->second.files;
+	}
+
+	DirectoryListing listing;
+	listing.write_time = write_time;
+	for (const auto& directory_file : std::filesystem::directory_iterator(directory_path, error))
+	{
+		listing.files.push_back(directory_file.path().generic_string());
+	}
+	directory_listings[directory_string] = std::move(listing);
+
+	return directory_listings[directory_string].files;
+}
+
 std::map<int, XSI::CString> sync_image_tiles(const XSI::CString& image_path)
 {
 	std::map<int, XSI::CString> to_return;
@@ -94,11 +136,8 @@ std::map<int, XSI::CString> sync_image_tiles(const XSI::CString& image_path)
 
 		std::string start_string = input_string.substr(0, start);
 		std::string end_string = input_string.substr(start + 4);
-		for (const auto& directory_file : std::filesystem::directory_iterator(directory_path))
+		for (const std::string& file_string : get_directory_files(directory_path))
 		{
-			std::filesystem::path file_path = directory_file.path();
-			std::string file_string = file_path.generic_string();
-
 			size_t find_start_pos = file_string.find(start_string);
 			if (find_start_pos != std::string::npos)
 			{
@@ -125,6 +164,86 @@ std::map<int, XSI::CString> sync_image_tiles(const XSI::CString& image_path)
 	return to_return;
 }
 
+// is extension supported by stb_image?
+bool is_ext_stb(const XSI::CString& ext)
+{
+	return ext == "jpeg" || ext == "jpg" || ext == "png" || ext == "bmp" || ext == "hdr" || ext == "psd" ||
+		ext == "tga" || ext == "gif" || ext == "pic" || ext == "pgm" || ext == "ppm";
+}
+
+bool load_image_info(const XSI::CString& file_path, ULONG& out_width, ULONG& out_height, ULONG& out_channels, ULONG& out_channel_size)
+{
+	ULONG point_pos = file_path.ReverseFindString(".");
+	if (point_pos == UINT_MAX)
+	{
+		return false;
+	}
+
+	XSI::CString ext = file_path.GetSubString(point_pos + 1);
+	ext.Lower();
+
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	ULONG channel_size = 4;
+	bool is_success = false;
+	if (is_ext_stb(ext))
+	{
+		is_success = stbi_info(file_path.GetAsciiString(), &width, &height, &channels) == 1;
+		// 16-bit and hdr images are loaded as floats, all other as bytes
+		if (is_success && !stbi_is_hdr(file_path.GetAsciiString()) && !stbi_is_16_bit(file_path.GetAsciiString()))
+		{
+			channel_size = 1;
+		}
+	}
+	else if (ext == "exr")
+	{
+		is_success = load_input_exr_info(file_path.GetAsciiString(), width, height, channels);
+	}
+
+	if (!is_success || width == 0 || height == 0 || channels == 0)
+	{
+		return false;
+	}
+
+	out_width = width;
+	out_height = height;
+	out_channels = channels;
+	out_channel_size = channel_size;
+
+	return true;
+}
+
+std::vector<unsigned char> load_image_bytes(const XSI::CString& file_path, ULONG& out_width, ULONG& out_height, ULONG& out_channels, bool& out_sucess)
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+
+	out_sucess = false;
+	unsigned char* pixels_data = stbi_load(file_path.GetAsciiString(), &width, &height, &channels, 0);
+	if (pixels_data == NULL)
+	{
+		return std::vector<unsigned char>(0);
+	}
+
+	std::vector<unsigned char> to_return;
+	if (width > 0 && height > 0 && channels > 0)
+	{
+		out_width = width;
+		out_height = height;
+		out_channels = channels;
+		out_sucess = true;
+
+		// flip pixels
+		flip_pixels(pixels_data, out_width, out_height, out_channels);
+		to_return.assign(pixels_data, pixels_data + (size_t)width * height * channels);
+	}
+	stbi_image_free(pixels_data);
+
+	return to_return;
+}
+
 std::vector<float> load_image(const XSI::CString &file_path, ULONG&out_width, ULONG&out_height, ULONG &out_channels, bool& out_sucess)
 {
 	int width = 0;
@@ -138,14 +257,12 @@ std::vector<float> load_image(const XSI::CString &file_path, ULONG&out_width, UL
 		XSI::CString ext = file_path.GetSubString(point_pos + 1);
 		ext.Lower();
 
-		// is extension supported by stb_image?
-		if (ext == "jpeg" || ext == "jpg" || ext == "png" || ext ==  "bmp" || ext == "hdr" || ext == "psd" ||
-			ext == "tga" || ext == "gif" || ext == "pic" || ext == "pgm" || ext == "ppm")
+		if (is_ext_stb(ext))
 		{
 			stbi_ldr_to_hdr_gamma(1.0f);
 
 			float* pixels_data = stbi_loadf(file_path.GetAsciiString(), &width, &height, &channels, 0);
-			if (width == 0 || height == 0 || channels == 0)
+			if (pixels_data == NULL || width == 0 || height == 0 || channels == 0)
 			{
 				out_sucess = false;
 			}
@@ -157,11 +274,16 @@ std::vector<float> load_image(const XSI::CString &file_path, ULONG&out_width, UL
 				out_sucess = true;
 			}
 
+			std::vector<float> to_return;
 			if (out_sucess)
 			{
 				// flip pixels
-				return flip_pixels(pixels_data, out_width, out_height, out_channels);
+				flip_pixels(pixels_data, out_width, out_height, out_channels);
+				to_return.assign(pixels_data, pixels_data + (size_t)width * height * channels);
 			}
+			stbi_image_free(pixels_data);
+
+			return to_return;
 		}
 		else if (ext == "exr")
 		{
@@ -178,7 +300,8 @@ std::vector<float> load_image(const XSI::CString &file_path, ULONG&out_width, UL
 				out_height = height;
 				out_channels = channels;
 
-				return flip_pixels(&exr_pixels[0], out_width, out_height, out_channels);
+				flip_pixels(&exr_pixels[0], out_width, out_height, out_channels);
+				return exr_pixels;
 			}
 			else
 			{
@@ -195,6 +318,128 @@ std::vector<float> load_image(const XSI::CString &file_path, ULONG&out_width, UL
 	return std::vector<float>(0);
 }
 
+XSI::CString get_texture_cache_path(const XSI::CString& file_path, ULONG scale, bool is_srgb)
+{
+	std::string file_path_str = file_path.GetAsciiString();
+	std::error_code error;
+	std::filesystem::file_time_type write_time = std::filesystem::last_write_time(file_path_str, error);
+	if (error)
+	{
+		return "";
+	}
+
+	std::string key = file_path_str + "|" + std::to_string(write_time.time_since_epoch().count()) + "|" + std::to_string(scale) + (is_srgb ? "|srgb" : "");
+	char name_buffer[32];
+	sprintf(name_buffer, "%016llx", (unsigned long long)std::hash<std::string>{}(key));
+
+	return get_project_path() + "\\sycles_cache\\textures\\" + XSI::CString(name_buffer) + ".tex";
+}
+
+// cache file contains header with image size and raw pixels after it
+bool read_texture_cache(const XSI::CString& cache_path, ULONG width, ULONG height, ULONG channels, ULONG channel_size, void* out_pixels)
+{
+	if (cache_path.Length() == 0)
+	{
+		return false;
+	}
+
+	FILE* file = fopen(cache_path.GetAsciiString(), "rb");
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	ULONG header[4];
+	size_t pixels_size = (size_t)width * height * channels * channel_size;
+	bool is_valid = fread(header, sizeof(ULONG), 4, file) == 4 &&
+		header[0] == width && header[1] == height && header[2] == channels && header[3] == channel_size &&
+		fread(out_pixels, 1, pixels_size, file) == pixels_size;
+	fclose(file);
+
+	if (is_valid)
+	{
+		// modification time of the copy is the time of the last use, the oldest copies are removed first
+		std::error_code error;
+		std::filesystem::last_write_time(cache_path.GetAsciiString(), std::filesystem::file_time_type::clock::now(), error);
+	}
+
+	return is_valid;
+}
+
+// remove the least recently used copies, until the size of the cache folder is less than the limit
+void trim_texture_cache(const std::filesystem::path& cache_folder)
+{
+	size_t max_size = (size_t)get_texture_cache_max_size() * 1024 * 1024;
+	std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> files;
+	std::vector<size_t> sizes;
+	size_t total_size = 0;
+	std::error_code error;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(cache_folder, error))
+	{
+		if (entry.is_regular_file(error) && entry.path().extension() == ".tex")
+		{
+			size_t file_size = (size_t)entry.file_size(error);
+			files.push_back({ entry.last_write_time(error), entry.path() });
+			sizes.push_back(file_size);
+			total_size += file_size;
+		}
+	}
+
+	if (total_size <= max_size)
+	{
+		return;
+	}
+
+	std::vector<size_t> order(files.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&files](size_t a, size_t b) { return files[a].first < files[b].first; });
+	for (size_t i = 0; i < order.size() && total_size > max_size; i++)
+	{
+		if (std::filesystem::remove(files[order[i]].second, error))
+		{
+			total_size -= sizes[order[i]];
+		}
+	}
+}
+
+void write_texture_cache(const XSI::CString& cache_path, ULONG width, ULONG height, ULONG channels, ULONG channel_size, const void* pixels)
+{
+	if (cache_path.Length() == 0)
+	{
+		return;
+	}
+
+	std::string cache_path_str = cache_path.GetAsciiString();
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(cache_path_str).parent_path(), error);
+
+	// write into temporary file and then rename it, so partially written file is never used
+	std::string temp_path_str = cache_path_str + ".tmp";
+	FILE* file = fopen(temp_path_str.c_str(), "wb");
+	if (file == NULL)
+	{
+		return;
+	}
+
+	ULONG header[4] = { width, height, channels, channel_size };
+	size_t pixels_size = (size_t)width * height * channels * channel_size;
+	bool is_written = fwrite(header, sizeof(ULONG), 4, file) == 4 && fwrite(pixels, 1, pixels_size, file) == pixels_size;
+	fclose(file);
+
+	if (is_written)
+	{
+		std::filesystem::rename(temp_path_str, cache_path_str, error);
+		trim_texture_cache(std::filesystem::path(cache_path_str).parent_path());
+	}
+	else
+	{
+		std::filesystem::remove(temp_path_str, error);
+	}
+}
+
 // return true if extension corresponds to the ldr image format,
 // flase if it hdr
 bool is_ext_ldr(std::string ext)
@@ -13,7 +13,21 @@ void remove_temp_path(const XSI::CString& temp_path);
 // input image_path is a path to selected image
 std::map<int, XSI::CString> sync_image_tiles(const XSI::CString& image_path);
 
+// read only size and channels of the image, without decoding the pixels
+// out_channel_size is 1 for 8-bit images (should be loaded by load_image_bytes) and 4 for float images (load_image)
+bool load_image_info(const XSI::CString& file_path, ULONG& out_width, ULONG& out_height, ULONG& out_channels, ULONG& out_channel_size);
 std::vector<float> load_image(const XSI::CString& file_path, ULONG& out_width, ULONG& out_height, ULONG& out_channels, bool &out_sucess);
+// load 8-bit image without conversion to float, supports only formats from stb_image
+std::vector<unsigned char> load_image_bytes(const XSI::CString& file_path, ULONG& out_width, ULONG& out_height, ULONG& out_channels, bool& out_sucess);
+
+// reduced copies of texture files are stored in the sycles_cache folder of the project
+// the key of the copy is the source path, modification time of the source file, the reduce scale and the color space of 8-bit pixels
+// so, when the source file is changed, the old copy is not used, and it is removed later, when the cache becomes larger than cache_max_size from the config
+XSI::CString get_texture_cache_path(const XSI::CString& file_path, ULONG scale, bool is_srgb);
+// return false if there is no valid copy with required size
+bool read_texture_cache(const XSI::CString& cache_path, ULONG width, ULONG height, ULONG channels, ULONG channel_size, void* out_pixels);
+void write_texture_cache(const XSI::CString& cache_path, ULONG width, ULONG height, ULONG channels, ULONG channel_size, const void* pixels);
+
 bool is_ext_ldr(std::string ext);
 bool is_output_extension_supported(const XSI::CString &extension);
 XSI::CString sync_image_file(const XSI::CString& file_path, int image_frames, int start_frame, int offset, bool cyclic, const XSI::CTime& eval_time);
\ No newline at end of file
@@ -70,4 +70,32 @@ bool load_input_exr(const std::string &input_filepath, std::vector<float> &out_p
 
 		return true;
 	}
+}
+
+bool load_input_exr_info(const std::string& input_filepath, int& out_width, int& out_height, int& out_channels)
+{
+	EXRVersion exr_version;
+	if (ParseEXRVersionFromFile(&exr_version, input_filepath.c_str()) != TINYEXR_SUCCESS || exr_version.multipart)
+	{
+		return false;
+	}
+
+	EXRHeader exr_header;
+	InitEXRHeader(&exr_header);
+	const char* err = NULL;
+	if (ParseEXRHeaderFromFile(&exr_header, &exr_version, input_filepath.c_str(), &err) != TINYEXR_SUCCESS)
+	{
+		if (err)
+		{
+			FreeEXRErrorMessage(err);
+		}
+		return false;
+	}
+
+	out_width = exr_header.data_window.max_x - exr_header.data_window.min_x + 1;
+	out_height = exr_header.data_window.max_y - exr_header.data_window.min_y + 1;
+	out_channels = 4;
+	FreeEXRHeader(&exr_header);
+
+	return true;
 }
\ No newline at end of file
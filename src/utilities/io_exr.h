@@ -2,4 +2,6 @@
 #include <string>
 
 bool write_output_exr(size_t width, size_t height, size_t components, const std::string& file_path, float* pixels);
-bool load_input_exr(const std::string& input_filepath, std::vector<float>& out_pixels, int& out_width, int& out_height, int& out_channels);
\ No newline at end of file
+bool load_input_exr(const std::string& input_filepath, std::vector<float>& out_pixels, int& out_width, int& out_height, int& out_channels);
+// read only the header of the exr file, output channels are always 4, as in load_input_exr
+bool load_input_exr_info(const std::string& input_filepath, int& out_width, int& out_height, int& out_channels);
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <vector>
 #include <random>
 #include <map>
+#include <algorithm>
 
 #include <xsi_application.h>
 #include <xsi_time.h>
@@ -23,7 +24,14 @@ const float epsilon = 0.0001f;
 
 int get_frame(const XSI::CTime& eval_time)
 {
-	return (int)(eval_time.GetTime() + 0.5);
+	return (int)(eval_time.GetTime(XSI::CTime::Frames) + 0.5);
+}
+
+XSI::CTime get_next_frame_time(const XSI::CTime& eval_time)
+{
+	XSI::CTime next_time = eval_time;
+	next_time.PutTime(eval_time.GetTime(XSI::CTime::Frames) + 1.0, XSI::CTime::Frames);
+	return next_time;
 }
 
 XSI::CString seconds_to_date(double total_seconds)
@@ -347,25 +355,111 @@ ccl::array<int> exctract_tiles(const std::map<int, XSI::CString>& tile_to_path_m
 	return to_return;
 }
 
-std::vector<float> flip_pixels(float* input, ULONG width, ULONG height, ULONG channels)
+// flip the image in vertical direction in-place, by swapping rows from the top and the bottom
+template<typename T>
+void flip_pixels_rows(T* pixels, ULONG width, ULONG height, ULONG channels)
 {
-	size_t pixels_count = width * height;
-	std::vector<float> out_pixels(pixels_count * channels);
-	for (ULONG pixel = 0; pixel < pixels_count; pixel++)
+	size_t row_size = (size_t)width * channels;
+	for (ULONG row = 0; row < height / 2; row++)
 	{
-		ULONG row = pixel / width;
-		ULONG column = pixel - row * width;
-		ULONG flip_pixel = (height - row - 1) * width + column;
-		for (ULONG c = 0; c < channels; c++)
+		T* top_row = pixels + row * row_size;
+		T* bottom_row = pixels + (size_t)(height - row - 1) * row_size;
+		std::swap_ranges(top_row, top_row + row_size, bottom_row);
+	}
+}
+
+void flip_pixels(float* pixels, ULONG width, ULONG height, ULONG channels)
+{
+	flip_pixels_rows(pixels, width, height, channels);
+}
+
+void flip_pixels(unsigned char* pixels, ULONG width, ULONG height, ULONG channels)
+{
+	flip_pixels_rows(pixels, width, height, channels);
+}
+
+ULONG get_image_reduce_scale(ULONG width, ULONG height, ULONG max_size)
+{
+	ULONG scale = 1;
+	if (max_size > 0)
+	{
+		while (std::max(width, height) / scale > max_size)
 		{
-			float v = input[channels * pixel + c];
-			out_pixels[channels * flip_pixel + c] = v;
+			scale *= 2;
+		}
+	}
+
+	return scale;
+}
+
+// decode converts input value of the channel to float, encode converts the average back
+template<typename T, typename D, typename E>
+std::vector<T> reduce_pixels_blocks(const T* pixels, ULONG width, ULONG height, ULONG channels, ULONG scale, D decode, E encode)
+{
+	ULONG out_width = std::max((ULONG)1, width / scale);
+	ULONG out_height = std::max((ULONG)1, height / scale);
+	std::vector<T> out_pixels((size_t)out_width * out_height * channels);
+	std::vector<float> sum(channels);
+	for (ULONG y = 0; y < out_height; y++)
+	{
+		ULONG y_end = std::min(height, (y + 1) * scale);
+		for (ULONG x = 0; x < out_width; x++)
+		{
+			ULONG x_end = std::min(width, (x + 1) * scale);
+			std::fill(sum.begin(), sum.end(), 0.0f);
+			for (ULONG sy = y * scale; sy < y_end; sy++)
+			{
+				const T* row = pixels + ((size_t)sy * width) * channels;
+				for (ULONG sx = x * scale; sx < x_end; sx++)
+				{
+					for (ULONG c = 0; c < channels; c++)
+					{
+						sum[c] += decode(row[sx * channels + c], c);
+					}
+				}
+			}
+
+			float count = (float)((y_end - y * scale) * (x_end - x * scale));
+			T* out_pixel = &out_pixels[((size_t)y * out_width + x) * channels];
+			for (ULONG c = 0; c < channels; c++)
+			{
+				out_pixel[c] = encode(sum[c] / count, c);
+			}
 		}
 	}
 
 	return out_pixels;
 }
 
+std::vector<float> reduce_pixels(const float* pixels, ULONG width, ULONG height, ULONG channels, ULONG scale)
+{
+	return reduce_pixels_blocks(pixels, width, height, channels, scale,
+		[](float v, ULONG c) { return v; },
+		[](float v, ULONG c) { return v; });
+}
+
+std::vector<unsigned char> reduce_pixels(const unsigned char* pixels, ULONG width, ULONG height, ULONG channels, ULONG scale, bool is_srgb)
+{
+	if (!is_srgb)
+	{
+		return reduce_pixels_blocks(pixels, width, height, channels, scale,
+			[](unsigned char v, ULONG c) { return (float)v; },
+			[](float v, ULONG c) { return (unsigned char)(v + 0.5f); });
+	}
+
+	// averaging of sRGB-encoded values darkens high-contrast textures, so average color channels in linear space
+	// alpha channel is always linear (the last channel of 2 and 4-channel images)
+	float to_linear[256];
+	for (int i = 0; i < 256; i++)
+	{
+		to_linear[i] = srgb_to_linear((float)i / 255.0f);
+	}
+	ULONG alpha_channel = (channels == 2 || channels == 4) ? channels - 1 : channels;
+	return reduce_pixels_blocks(pixels, width, height, channels, scale,
+		[&](unsigned char v, ULONG c) { return c == alpha_channel ? (float)v : to_linear[v]; },
+		[&](float v, ULONG c) { return c == alpha_channel ? (unsigned char)(v + 0.5f) : linear_to_srgb_int8(v); });
+}
+
 int powi(int base, unsigned int exp)
 {
 	int res = 1;
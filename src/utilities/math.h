@@ -23,6 +23,7 @@
 #define RAD2DEGF(_rad) ((_rad) * (float)(180.0 / M_PI))
 
 int get_frame(const XSI::CTime& eval_time);
+XSI::CTime get_next_frame_time(const XSI::CTime& eval_time);
 XSI::CString seconds_to_date(double total_seconds);
 float clamp_float(float value, float min, float max);
 float linear_to_srgb_float(float v);
@@ -53,6 +54,15 @@ float interpolate_float_with_middle(float a, float b, float t, float middle);
 XSI::MATH::CColor4f interpolate_color(const XSI::MATH::CColor4f& color1, const XSI::MATH::CColor4f& color2, float t, float mid = 0.5);
 
 ccl::array<int> exctract_tiles(const std::map<int, XSI::CString>& tile_to_path_map);
-std::vector<float> flip_pixels(float* input, ULONG width, ULONG height, ULONG channels);
+// flip pixels in-place
+void flip_pixels(float* pixels, ULONG width, ULONG height, ULONG channels);
+void flip_pixels(unsigned char* pixels, ULONG width, ULONG height, ULONG channels);
+// return the power of two, the image should be reduced by, to fit into max_size (0 - no limit)
+ULONG get_image_reduce_scale(ULONG width, ULONG height, ULONG max_size);
+// reduce the image in scale times by averaging scale x scale blocks of pixels
+// output size is max(1, width / scale) x max(1, height / scale)
+std::vector<float> reduce_pixels(const float* pixels, ULONG width, ULONG height, ULONG channels, ULONG scale);
+// if is_srgb is true, then color channels are averaged in linear space
+std::vector<unsigned char> reduce_pixels(const unsigned char* pixels, ULONG width, ULONG height, ULONG channels, ULONG scale, bool is_srgb);
 int powi(int base, unsigned int exp);
 size_t calc_time_motion_step(size_t mi, size_t motion_steps, MotionSettingsPosition motion_position);
\ No newline at end of file